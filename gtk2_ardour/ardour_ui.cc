@@ -379,6 +379,11 @@ ARDOUR_UI::ARDOUR_UI (int *argcp, char **argvp[], const char* localedir)
 	rec_button.set_name ("transport recenable button");
 	midi_panic_button.set_name ("transport button");
 
+	/* handle peak building progress */
+
+	_peaks_done = _peaks_queued = 0;
+	ARDOUR::SourceFactory::PeakBuildingProgress.connect (forever_connections, MISSING_INVALIDATOR, boost::bind (&ARDOUR_UI::peak_building_progress, this, _1, _2), gui_context());
+
 	ARDOUR::Diskstream::DiskOverrun.connect (forever_connections, MISSING_INVALIDATOR, boost::bind (&ARDOUR_UI::disk_overrun_handler, this), gui_context());
 	ARDOUR::Diskstream::DiskUnderrun.connect (forever_connections, MISSING_INVALIDATOR, boost::bind (&ARDOUR_UI::disk_underrun_handler, this), gui_context());
 
@@ -1634,11 +1639,22 @@ ARDOUR_UI::update_peak_thread_work ()
 	if (c > 0) {
 		snprintf (buf, sizeof (buf), _("PkBld: <span foreground=\"%s\">%d</span>"), c >= 2 ? X_("red") : X_("green"), c);
 		peak_thread_work_label.set_markup (buf);
+		if (_peaks_queued > 0) {
+			set_tip (peak_thread_work_label, string_compose (_("Peak files built: %1 of %2"), _peaks_done, _peaks_queued));
+		}
 	} else {
 		peak_thread_work_label.set_markup (X_(""));
 	}
 }
 
+void
+ARDOUR_UI::peak_building_progress (uint32_t done, uint32_t queued)
+{
+	_peaks_done = done;
+	_peaks_queued = queued;
+	update_peak_thread_work ();
+}
+
 void
 ARDOUR_UI::update_buffer_load ()
 {
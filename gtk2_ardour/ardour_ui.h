@@ -616,6 +616,9 @@ private:
 
 	Gtk::Label   peak_thread_work_label;
 	void update_peak_thread_work ();
+	void peak_building_progress (uint32_t done, uint32_t queued);
+	uint32_t     _peaks_done;
+	uint32_t     _peaks_queued;
 
 	Gtk::Label   buffer_load_label;
 	void update_buffer_load ();
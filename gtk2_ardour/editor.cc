@@ -4659,6 +4659,8 @@ Editor::visual_changer (const VisualChange& vc)
 	}
 
 	_summary->set_overlays_dirty ();
+
+	prioritize_visible_peaks ();
 }
 
 struct EditorOrderTimeAxisSorter {
@@ -5198,6 +5200,8 @@ Editor::region_view_added (RegionView * rv)
 		}
 	}
 
+	prioritize_region_view_peaks (rv);
+
 	_summary->set_background_dirty ();
 }
 
@@ -1110,6 +1110,9 @@ class Editor : public PublicEditor, public PBD::ScopedConnectionList, public ARD
 	sigc::connection control_scroll_connection;
 
 	void tie_vertical_scrolling ();
+	bool track_on_screen (TimeAxisView const *) const;
+	void prioritize_visible_peaks ();
+	void prioritize_region_view_peaks (RegionView*);
 	void set_horizontal_position (double);
 	double horizontal_position () const;
 
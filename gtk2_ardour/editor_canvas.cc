@@ -23,9 +23,12 @@
 
 #include "gtkmm2ext/utils.h"
 
+#include "ardour/audioregion.h"
+#include "ardour/playlist.h"
 #include "ardour/profile.h"
 #include "ardour/rc_configuration.h"
 #include "ardour/smf_source.h"
+#include "ardour/source_factory.h"
 
 #include "pbd/error.h"
 
@@ -865,6 +868,79 @@ Editor::tie_vertical_scrolling ()
 	if (pending_visual_change.idle_handler_id < 0) {
 		_summary->set_overlays_dirty ();
 	}
+
+	prioritize_visible_peaks ();
+}
+
+/** @return true if any part of @param tv is within the visible part of the track canvas */
+bool
+Editor::track_on_screen (TimeAxisView const * tv) const
+{
+	if (tv->hidden () || tv->y_position () < 0) {
+		return false;
+	}
+
+	double const top = vertical_adjustment.get_value ();
+
+	return tv->y_position () < top + _visible_canvas_height && tv->y_position () + tv->effective_height () > top;
+}
+
+/** Ask for the peak files of @param r's sources to be built before those of other sources */
+static void
+prioritize_region_peaks (boost::shared_ptr<Region> r)
+{
+	boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (r);
+
+	if (!ar) {
+		return;
+	}
+
+	for (uint32_t n = 0; n < ar->n_channels (); ++n) {
+		SourceFactory::prioritize_peakfile (ar->audio_source (n));
+	}
+}
+
+/** Make sure that the waveforms the user can see are the first to be
+ *  drawn, when there are peak files waiting to be built.
+ */
+void
+Editor::prioritize_visible_peaks ()
+{
+	if (!_session || SourceFactory::peak_work_queue_length () == 0) {
+		return;
+	}
+
+	framepos_t const end = leftmost_frame + current_page_samples ();
+
+	for (TrackViewList::const_iterator i = track_views.begin(); i != track_views.end(); ++i) {
+
+		RouteTimeAxisView* rtv = dynamic_cast<RouteTimeAxisView*> (*i);
+
+		if (!rtv || !rtv->is_audio_track () || !track_on_screen (rtv)) {
+			continue;
+		}
+
+		boost::shared_ptr<RegionList> rl = rtv->track ()->playlist ()->regions_touched (leftmost_frame, end);
+
+		for (RegionList::const_iterator r = rl->begin(); r != rl->end(); ++r) {
+			prioritize_region_peaks (*r);
+		}
+	}
+}
+
+/** Called when a region view has been added to a track; if it is on screen, make its waveform a priority */
+void
+Editor::prioritize_region_view_peaks (RegionView* rv)
+{
+	if (SourceFactory::peak_work_queue_length () == 0 || !track_on_screen (&rv->get_time_axis_view ())) {
+		return;
+	}
+
+	boost::shared_ptr<Region> r = rv->region ();
+
+	if (r->last_frame () >= leftmost_frame && r->position () < leftmost_frame + current_page_samples ()) {
+		prioritize_region_peaks (r);
+	}
 }
 
 void
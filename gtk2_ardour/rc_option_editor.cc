@@ -3188,6 +3188,21 @@ if (!ARDOUR::Profile->get_mixbus()) {
 	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
 					    _("<b>When enabled</b> plugins will be activated when they are added to tracks/busses. When disabled plugins will be left inactive when they are added to tracks/busses"));
 
+	ComboOption<uint32_t>* pai = new ComboOption<uint32_t> (
+		"plugin-automation-interval",
+		_("Apply plugin automation"),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::get_plugin_automation_interval),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::set_plugin_automation_interval)
+		);
+
+	pai->add (0, _("at each automation event"));
+	pai->add (16, _("every 16 samples"));
+	pai->add (64, _("every 64 samples"));
+
+	add_option (_("Plugins"), pai);
+	Gtkmm2ext::UI::instance()->set_tip (pai->tip_widget(),
+					    _("Plugins are run once for every section between automation events. Applying automation only every 16 or 64 samples rounds those sections up to that size, which avoids running plugins on very short sections when automation is dense. Each automation change then reaches the plugin up to 15 or 63 samples late. Plugins are still run more than once per cycle when automation changes within it."));
+
 #if (defined WINDOWS_VST_SUPPORT || defined MACVST_SUPPORT || defined LXVST_SUPPORT)
 	add_option (_("Plugins/VST"), new OptionEditorHeading (_("VST")));
 	add_option (_("Plugins/VST"),
@@ -0,0 +1,108 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __ardour_async_reader_h__
+#define __ardour_async_reader_h__
+
+#include <sys/types.h>
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR {
+
+/** Batched, asynchronous reads of byte ranges of already-open files.
+ *
+ *  The butler uses this to start the disk reads for every track of a
+ *  refill pass at once, before any of the (synchronous) libsndfile reads
+ *  that actually fill the playback buffers. The kernel can then reorder and
+ *  overlap the I/O for all files, and the libsndfile reads are served from
+ *  the page cache as the data arrives.
+ *
+ *  Uses io_uring if libardour was built with liburing, POSIX AIO otherwise.
+ *  The data read is discarded: all requests share one scratch buffer.
+ *  Each request reads from its own duplicate of the descriptor it was given,
+ *  closed once the request has been reaped, so the owner of a descriptor
+ *  may close it at any time.
+ *  Not thread safe.
+ */
+class LIBARDOUR_API AsyncReader
+{
+  public:
+	/** @param max_requests Maximum number of reads per batch.
+	 *  @param max_read Largest single read, in bytes; longer ranges are split.
+	 */
+	AsyncReader (size_t max_requests = 1024, size_t max_read = 1048576);
+	~AsyncReader ();
+
+	/** @return false if no asynchronous I/O backend is available */
+	bool usable () const { return _usable; }
+	const char* backend () const;
+
+	/** Queue a read of @param len bytes at @param offset in @param fd.
+	 *  @return false if the batch is full.
+	 */
+	bool add (int fd, off_t offset, size_t len);
+
+	/** Start all queued reads.
+	 *  @return number of reads started.
+	 */
+	size_t submit ();
+
+	/** Collect any started reads that have finished, without waiting. */
+	void reap ();
+
+	/** Wait for all started reads to finish. */
+	void wait ();
+
+	/** Ask the kernel to drop started reads that it has not begun yet,
+	 *  where the backend allows that, and stop caring about the rest;
+	 *  reap() or wait() collects them later.
+	 */
+	void cancel ();
+
+	size_t queued () const { return _n_queued; }
+	size_t in_flight () const { return _n_in_flight; }
+
+  private:
+	AsyncReader (AsyncReader const &);
+	AsyncReader& operator= (AsyncReader const &);
+
+	struct Request {
+		int    fd;
+		off_t  offset;
+		size_t len;
+	};
+
+	struct Backend;
+
+	void done (int fd);
+
+	Backend* _backend;
+	bool     _usable;
+	Request* _queue;
+	size_t   _max_requests;
+	size_t   _max_read;
+	size_t   _n_queued;
+	size_t   _n_in_flight;
+	char*    _scratch;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_async_reader_h__ */
@@ -212,6 +212,8 @@ class LIBARDOUR_API AudioDiskstream : public Diskstream
 	/* The two central butler operations */
 	int do_flush (RunContext context, bool force = false);
 	int do_refill () { return _do_refill(_mixdown_buffer, _gain_buffer, 0); }
+	int do_refill_with_buffers (Sample* mixdown_buffer, float* gain_buffer) { return _do_refill (mixdown_buffer, gain_buffer, 0); }
+	void prefetch (AsyncReader&);
 
 
 	int read (Sample* buf, Sample* mixdown_buffer, float* gain_buffer,
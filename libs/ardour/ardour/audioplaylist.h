@@ -28,6 +28,7 @@
 
 namespace ARDOUR  {
 
+class AsyncReader;
 class Session;
 class AudioRegion;
 class Source;
@@ -42,6 +43,7 @@ public:
 	AudioPlaylist (boost::shared_ptr<const AudioPlaylist>, framepos_t start, framecnt_t cnt, std::string name, bool hidden = false);
 
 	framecnt_t read (Sample *dst, Sample *mixdown, float *gain_buffer, framepos_t start, framecnt_t cnt, uint32_t chan_n=0);
+	void prefetch (framepos_t start, framecnt_t cnt, uint32_t chan_n, AsyncReader&);
 
 	bool destroy_region (boost::shared_ptr<Region>);
 
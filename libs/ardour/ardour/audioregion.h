@@ -53,6 +53,7 @@ namespace Properties {
 	LIBARDOUR_API extern PBD::PropertyDescriptor<boost::shared_ptr<AutomationList> > envelope;
 }
 
+class AsyncReader;
 class Playlist;
 class Session;
 class Filter;
@@ -122,6 +123,8 @@ class LIBARDOUR_API AudioRegion : public Region
 	virtual framecnt_t master_read_at (Sample *buf, Sample *mixdown_buf, float *gain_buf,
 					   framepos_t position, framecnt_t cnt, uint32_t chan_n=0) const;
 
+	void prefetch (framepos_t position, framecnt_t cnt, uint32_t chan_n, AsyncReader&) const;
+
 	virtual framecnt_t read_raw_internal (Sample*, framepos_t, framecnt_t, int channel) const;
 
 	XMLNode& state ();
@@ -217,6 +220,7 @@ class LIBARDOUR_API AudioRegion : public Region
 	void recompute_gain_at_start ();
 
 	framecnt_t read_from_sources (SourceList const &, framecnt_t, Sample *, framepos_t, framecnt_t, uint32_t) const;
+	Sample const * mapped_source_data (framepos_t, framecnt_t, uint32_t) const;
 
 	void recompute_at_start ();
 	void recompute_at_end ();
@@ -38,6 +38,8 @@
 
 namespace ARDOUR {
 
+class AsyncReader;
+
 class LIBARDOUR_API AudioSource : virtual public Source,
 		public ARDOUR::Readable,
 		public boost::enable_shared_from_this<ARDOUR::AudioSource>
@@ -59,6 +61,18 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	virtual framecnt_t read (Sample *dst, framepos_t start, framecnt_t cnt, int channel=0) const;
 	virtual framecnt_t write (Sample *src, framecnt_t cnt);
 
+	/** Queue a background read of the data that read() would need for
+	 *  @param start and @param cnt, if this kind of source can do that.
+	 */
+	virtual void prefetch (framepos_t /*start*/, framecnt_t /*cnt*/, AsyncReader&) const {}
+
+	/** @return a pointer to the samples that read() would return for
+	 *  @param start and @param cnt, if this source holds them in memory
+	 *  exactly as they are, otherwise 0. The data remain valid for the
+	 *  lifetime of the source.
+	 */
+	virtual Sample const * mapped_data (framepos_t /*start*/, framecnt_t /*cnt*/) const { return 0; }
+
 	virtual float sample_rate () const = 0;
 
 	virtual void mark_streaming_write_completed (const Lock& lock);
@@ -168,7 +182,26 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	mutable double _last_scale;
 	mutable off_t _last_map_off;
 	mutable size_t  _last_raw_map_length;
+	mutable uint32_t _last_level;
 	mutable boost::scoped_array<PeakData> peak_cache;
+
+	/* coarser levels of peak data, kept in a second file next to the
+	 * peakfile; see audiosource.cc
+	 */
+	int        _peak_levels_fd;
+	bool       _peak_levels_broken;
+	framecnt_t _peak_levels_next;        ///< index of the next peakfile peak that write_peak_levels() expects
+	PeakData   _peak_levels_block[17];   ///< the block being written: 16 level 1 peaks and 1 level 2 peak
+	mutable framecnt_t _peak_levels_frames; ///< frames covered by the levels file, or -1 if not checked yet
+	mutable Glib::Threads::Mutex _peak_levels_lock;
+
+	std::string peak_levels_path () const;
+	void prepare_peak_levels ();
+	void write_peak_levels (framecnt_t first_peak, PeakData const * peaks, framecnt_t npeaks);
+	void done_with_peak_levels (bool done);
+	framecnt_t ensure_peak_levels () const;
+	int build_peak_levels (framecnt_t npeaks) const;
+	int read_peak_level (uint32_t level, framecnt_t first_peak, framecnt_t npeaks, PeakData* dst) const;
 };
 
 }
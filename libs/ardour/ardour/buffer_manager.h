@@ -39,11 +39,13 @@ public:
 
 	static ThreadBuffers* get_thread_buffers ();
 	static void           put_thread_buffers (ThreadBuffers*);
+	static void           localize_thread_buffers (ThreadBuffers*);
 
 	static void ensure_buffers (ChanCount howmany = ChanCount::ZERO, size_t custom = 0);
 
 private:
         static Glib::Threads::Mutex rb_mutex;
+        static Glib::Threads::Mutex ensure_mutex;
 
 	typedef PBD::RingBufferNPT<ThreadBuffers*> ThreadBufferFIFO;
 	typedef std::list<ThreadBuffers*> ThreadBufferList;
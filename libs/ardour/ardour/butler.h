@@ -20,7 +20,11 @@
 #ifndef __ardour_butler_h__
 #define __ardour_butler_h__
 
+#include <map>
+#include <vector>
+
 #include <pthread.h>
+#include <sys/types.h>
 
 #include <glibmm/threads.h>
 
@@ -35,6 +39,9 @@
 
 namespace ARDOUR {
 
+class AsyncReader;
+class Track;
+
 /**
  *  One of the Butler's functions is to clean up (ie delete) unused CrossThreadPools.
  *  When a thread with a CrossThreadPool terminates, its CTP is added to pool_trash.
@@ -56,6 +63,7 @@ class LIBARDOUR_API Butler : public SessionHandleRef
 	void wait_until_finished();
 	bool transport_work_requested() const;
 	void drop_references ();
+	void clear_device_cache ();
 
         void map_parameters ();
 
@@ -93,6 +101,61 @@ private:
 
 	bool flush_tracks_to_disk_normal (boost::shared_ptr<RouteList>, uint32_t& errors);
 
+	/* Parallel disk I/O.
+	 *
+	 * If Config->get_butler_io_threads() is greater than one, refills and flushes
+	 * are handed to a pool of I/O threads instead of being run one after
+	 * another on the butler thread. Tracks are sharded into one queue per
+	 * storage device, each sorted so that the track closest to an underrun
+	 * (or capture overrun) is serviced first. An idle I/O thread always
+	 * picks the device with the fewest threads already working on it, so
+	 * that one slow disk cannot hold up the others.
+	 */
+
+	struct IOJob {
+		IOJob (boost::shared_ptr<Track> t, float u) : track (t), urgency (u) {}
+		boost::shared_ptr<Track> track;
+		float urgency; ///< lower is more urgent
+		bool operator< (IOJob const& other) const { return urgency < other.urgency; }
+	};
+
+	struct IOQueue {
+		IOQueue () : next (0), busy (0) {}
+		std::vector<IOJob> jobs;
+		size_t   next; ///< index of the next job to hand out
+		uint32_t busy; ///< number of I/O threads working on this device
+	};
+
+	bool run_io_pass (RouteList const&, bool refill, uint32_t& errors);
+	size_t io_queue_for (dev_t);
+	dev_t  device_of (boost::shared_ptr<Track>);
+	dev_t  device_of (std::string const& path);
+	IOQueue* next_io_queue ();
+
+	void start_io_threads (uint32_t);
+	void stop_io_threads ();
+	static void* _io_thread_work (void *arg);
+	void io_thread_work ();
+
+	std::vector<pthread_t>  _io_threads;
+	std::vector<IOQueue>    _io_queues;
+	std::map<dev_t, size_t> _io_queue_index;
+	std::vector<std::pair<dev_t, IOJob> > _io_new_jobs; ///< butler thread only
+	std::map<std::string, dev_t> _device_cache;
+	Glib::Threads::Mutex    _device_cache_lock;
+	Glib::Threads::Mutex    _io_lock;
+	Glib::Threads::Cond     _io_work;
+	Glib::Threads::Cond     _io_done;
+	bool                    _io_refill;
+	bool                    _io_quit;
+	uint32_t                _io_pending;
+	uint32_t                _io_errors;
+	bool                    _io_outstanding;
+	std::vector<std::string> _io_failures;
+
+	AsyncReader* _prefetcher;
+	void queue_prefetch (RouteList const&);
+
 	/**
 	 * Add request to butler thread request queue
 	 */
@@ -43,6 +43,7 @@ struct tm;
 
 namespace ARDOUR {
 
+class AsyncReader;
 class IO;
 class Playlist;
 class Processor;
@@ -247,6 +248,17 @@ class LIBARDOUR_API Diskstream : public SessionObject, public PublicDiskstream
 	virtual int do_flush (RunContext context, bool force = false) = 0;
 	virtual int do_refill () = 0;
 
+	/** As do_refill(), but using caller-provided working buffers so that
+	 *  several threads may refill different diskstreams at the same time.
+	 *  Both buffers must hold at least 2*1048576 elements.
+	 */
+	virtual int do_refill_with_buffers (Sample* /*mixdown_buffer*/, float* /*gain_buffer*/) { return do_refill (); }
+
+	/** Queue background reads, on @param reader, of the data that the next
+	 *  do_refill() is likely to want.
+	 */
+	virtual void prefetch (AsyncReader& /*reader*/) {}
+
 	/* XXX fix this redundancy ... */
 
 	virtual void playlist_changed (const PBD::PropertyChange&);
@@ -27,10 +27,10 @@
 #include "audiographer/utils/identity_vertex.h"
 
 #include <boost/ptr_container/ptr_list.hpp>
-#include <glibmm/threadpool.h>
 
 namespace AudioGrapher {
 	class SampleRateConverter;
+	class ThreadPool;
 	class PeakReader;
 	class LoudnessReader;
 	class Normalizer;
@@ -64,10 +64,10 @@ class LIBARDOUR_API ExportGraphBuilder
 
   public:
 
-	ExportGraphBuilder (Session const & session);
+	ExportGraphBuilder (Session const & session, AudioGrapher::ThreadPool & thread_pool);
 	~ExportGraphBuilder ();
 
-	int process (framecnt_t frames, bool last_cycle);
+	int process (framecnt_t frames, bool last_cycle, framecnt_t offset = 0);
 	bool post_process (); // returns true when finished
 	bool need_postprocessing () const { return !intermediates.empty(); }
 	bool realtime() const { return _realtime; }
@@ -79,6 +79,18 @@ class LIBARDOUR_API ExportGraphBuilder
 	void add_config (FileSpec const & config, bool rt);
 	void get_analysis_results (AnalysisResults& results);
 
+	/** Build only what measures the signal for normalization: no files are
+	 *  written. Set before adding configs, afterwards process() the timespan
+	 *  and get_normalization_peaks() for the export proper.
+	 */
+	void set_analysis_only (bool yn) { _analysis_only = yn; }
+	void get_normalization_peaks (std::vector<float>& peaks);
+	/** Normalize by peaks from an analysis-only run of the same configs,
+	 *  while streaming, instead of through a temporary file.
+	 *  Set before adding configs.
+	 */
+	void set_normalization_peaks (std::vector<float> const & peaks) { normalization_peaks = peaks; }
+
   private:
 
 	void add_analyser (const std::string& fn, AnalysisPtr ap) {
@@ -160,6 +172,8 @@ class LIBARDOUR_API ExportGraphBuilder
 		/// Returns true when finished
 		bool process ();
 
+		float measured_peak ();
+
 	                                        private:
 		typedef boost::shared_ptr<AudioGrapher::PeakReader> PeakReaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::LoudnessReader> LoudnessReaderPtr;
@@ -177,6 +191,9 @@ class LIBARDOUR_API ExportGraphBuilder
 		framecnt_t      max_frames_out;
 		bool            use_loudness;
 		bool            use_peak;
+		bool            analysis_only;
+		bool            streaming;
+		float           gain;
 		BufferPtr       buffer;
 		PeakReaderPtr   peak_reader;
 		TmpFilePtr      tmp_file;
@@ -265,11 +282,16 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	std::list<Intermediate *> intermediates;
 
+	// All Intermediates, in the order they were created
+	std::vector<Intermediate *> all_intermediates;
+	std::vector<float> normalization_peaks;
+	bool _analysis_only;
+
 	AnalysisMap analysis_map;
 
 	bool _realtime;
 
-	Glib::ThreadPool thread_pool;
+	AudioGrapher::ThreadPool & thread_pool;
 };
 
 } // namespace ARDOUR
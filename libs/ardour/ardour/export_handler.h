@@ -22,6 +22,7 @@
 #define __ardour_export_handler_h__
 
 #include <map>
+#include <vector>
 
 #include <boost/operators.hpp>
 #include <boost/shared_ptr.hpp>
@@ -38,6 +39,7 @@
 
 namespace AudioGrapher {
 	class BroadcastInfo;
+	class ThreadPool;
 }
 
 namespace ARDOUR
@@ -126,11 +128,11 @@ class LIBARDOUR_API ExportHandler : public ExportElementFactory, public sigc::tr
 
   private:
 
-	void handle_duplicate_format_extensions();
+	typedef boost::shared_ptr<ExportGraphBuilder> GraphBuilderPtr;
+
 	int process (framecnt_t frames);
 
 	Session &          session;
-	boost::shared_ptr<ExportGraphBuilder> graph_builder;
 	ExportStatusPtr    export_status;
 
 	/* The timespan and corresponding file specifications that we are exporting;
@@ -140,20 +142,49 @@ class LIBARDOUR_API ExportHandler : public ExportElementFactory, public sigc::tr
 	ConfigMap          config_map;
 
 	bool               post_processing;
+	bool               analysis_pass;
 
 	/* Timespan management */
 
 	void start_timespan ();
+	void start_pass ();
+	bool need_analysis_pass () const;
 	int  process_timespan (framecnt_t frames);
 	int  post_process ();
 	void finish_timespan ();
+	void finish_pass_timespan (GraphBuilderPtr);
 
 	typedef std::pair<ConfigMap::iterator, ConfigMap::iterator> TimespanBounds;
-	ExportTimespanPtr     current_timespan;
-	TimespanBounds        timespan_bounds;
+	void handle_duplicate_format_extensions (TimespanBounds const &);
+
+	/* Timespans that do not overlap can be chained: they are still rendered
+	   one after another, but the session rolls on from one to the next
+	   instead of stopping, relocating and pre-rolling for each. Each is
+	   written by its own graph builder.
+	*/
+	struct PassTimespan {
+		PassTimespan (ExportTimespanPtr t, GraphBuilderPtr b)
+		  : timespan (t), builder (b), started (false) {}
+
+		ExportTimespanPtr timespan;
+		GraphBuilderPtr   builder;
+		bool              started;
+	};
+	typedef std::vector<PassTimespan> Pass;
+
+	bool can_chain (ExportTimespanPtr) const;
+	void plan_pass (std::vector<ExportTimespanPtr> &) const;
+	void begin_pass_timespan (PassTimespan &);
+
+	/* shared by all graph builders, declared first so that it outlives them */
+	boost::shared_ptr<AudioGrapher::ThreadPool> thread_pool;
+	Pass                         pass;
+	std::vector<GraphBuilderPtr> graph_builders;
+	ExportTimespanPtr            current_timespan;
 
 	PBD::ScopedConnection process_connection;
 	framepos_t             process_position;
+	framepos_t             pass_end;
 
 	/* CD Marker stuff */
 
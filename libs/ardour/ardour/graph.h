@@ -31,6 +31,7 @@
 #include <glib.h>
 
 #include "pbd/semutils.h"
+#include "pbd/work_stealing_deque.h"
 
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
@@ -57,16 +58,17 @@ class LIBARDOUR_API Graph : public SessionHandleRef
 public:
 	Graph (Session & session);
 
-	void prep();
-	void trigger (GraphNode * n);
+	void prep (uint32_t worker);
+	void trigger (GraphNode * n, uint32_t worker);
+	void finish (GraphNode * n, uint32_t worker);
 	void rechain (boost::shared_ptr<RouteList>, GraphEdges const &);
 
 	void dump (int chain);
 	void process();
-	void dec_ref();
-	void restart_cycle();
+	void dec_ref (uint32_t worker);
+	void restart_cycle (uint32_t worker);
 
-	bool run_one();
+	bool run_one (uint32_t worker);
 	void helper_thread();
 	void main_thread();
 
@@ -94,12 +96,48 @@ private:
 	void reset_thread_list ();
 	void drop_threads ();
 
+	/** The routes of each chain; this holds our references to them */
 	node_list_t _nodes_rt[2];
 
-	node_list_t _init_trigger_list[2];
-
-	std::vector<GraphNode *> _trigger_queue;
-	pthread_mutex_t          _trigger_mutex;
+	/** A chain flattened for the process threads, which only ever use
+	 *  indices into these arrays.  Node i feeds the nodes listed in
+	 *  activations[activation_offset[i]] .. activations[activation_offset[i+1] - 1].
+	 */
+	struct Schedule {
+		std::vector<GraphNode*> nodes;
+		std::vector<uint32_t>   activation_offset;
+		std::vector<uint32_t>   activations;
+		/** The number of nodes that directly feed each node */
+		std::vector<gint>       init_refcount;
+		/** The number of those nodes not yet processed in this cycle */
+		std::vector<gint>       refcount;
+		/** The number of nodes on the longest path from each node to
+		 *  the `output' end of the graph, including itself
+		 */
+		std::vector<uint32_t>   critical_path;
+		/** The nodes that nothing feeds */
+		std::vector<uint32_t>   init_trigger;
+
+		void clear ();
+	};
+
+	Schedule _schedule[2];
+
+	typedef PBD::WorkStealingDeque<GraphNode> TriggerQueue;
+
+	/** One queue of runnable nodes per process thread, indexed by worker id;
+	 *  the main thread is worker 0.
+	 */
+	std::vector<TriggerQueue*> _trigger_queues;
+
+	GraphNode* pop_or_steal (uint32_t worker);
+	bool bind_to_dsp_core (uint32_t worker);
+	void wake_helpers ();
+
+	/** The number of nodes queued in all of _trigger_queues */
+	volatile gint _trigger_queue_size;
+	/** Next worker id to hand out to a helper thread */
+	volatile gint _next_worker;
 
 	PBD::Semaphore _execution_sem;
 
@@ -108,7 +146,7 @@ private:
 	PBD::Semaphore _callback_done_sem;
 	PBD::Semaphore _cleanup_sem;
 
-	/** The number of processing threads that are asleep */
+	/** The number of processing threads that are asleep and have not yet been signalled */
 	volatile gint _execution_tokens;
 	/** The number of unprocessed nodes that do not feed any other node; updated during processing */
 	volatile gint _finished_refcount;
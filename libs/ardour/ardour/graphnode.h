@@ -44,23 +44,15 @@ class LIBARDOUR_API GraphNode
 	GraphNode( boost::shared_ptr<Graph> Graph );
 	virtual ~GraphNode();
 
-	void prep( int chain );
-	void dec_ref();
-	void finish( int chain );
-
 	virtual void process();
 
     private:
 	friend class Graph;
 
-	/** Nodes that we directly feed */
-	node_set_t  _activation_set[2];
-
 	boost::shared_ptr<Graph> _graph;
 
-	gint _refcount;
-	/** The number of nodes that we directly feed us (one count for each chain) */
-	gint _init_refcount[2];
+	/** Our index in the Graph's schedule (one for each chain) */
+	uint32_t _schedule_index[2];
 };
 
 }
@@ -42,8 +42,28 @@ extern "C" {
 	LIBARDOUR_API void  x86_sse_avx_copy_vector          (float * dst, const float * src, uint32_t nframes);
 }
 
+extern "C" {
+/* AVX-512 functions */
+	LIBARDOUR_API float x86_avx512_compute_peak          (const float * buf, uint32_t nsamples, float current);
+	LIBARDOUR_API void  x86_avx512_apply_gain_to_buffer  (float * buf, uint32_t nframes, float gain);
+	LIBARDOUR_API void  x86_avx512_mix_buffers_with_gain (float * dst, const float * src, uint32_t nframes, float gain);
+	LIBARDOUR_API void  x86_avx512_mix_buffers_no_gain   (float * dst, const float * src, uint32_t nframes);
+	LIBARDOUR_API void  x86_avx512_copy_vector           (float * dst, const float * src, uint32_t nframes);
+}
+
 LIBARDOUR_API void  x86_sse_find_peaks                 (const float * buf, uint32_t nsamples, float *min, float *max);
 LIBARDOUR_API void  x86_sse_avx_find_peaks             (const float * buf, uint32_t nsamples, float *min, float *max);
+LIBARDOUR_API void  x86_avx512_find_peaks              (const float * buf, uint32_t nsamples, float *min, float *max);
+
+LIBARDOUR_API void  x86_sse_apply_gain_vector_to_buffer     (float * buf, const float * gains, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_sse_mix_buffers_with_gain_vector    (float * dst, const float * src, const float * gains, uint32_t nframes);
+LIBARDOUR_API void  x86_sse_crossfade_buffers               (float * dst, const float * src, const float * gains, uint32_t nframes);
+LIBARDOUR_API void  x86_sse_avx_apply_gain_vector_to_buffer (float * buf, const float * gains, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_sse_avx_mix_buffers_with_gain_vector(float * dst, const float * src, const float * gains, uint32_t nframes);
+LIBARDOUR_API void  x86_sse_avx_crossfade_buffers           (float * dst, const float * src, const float * gains, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512_apply_gain_vector_to_buffer  (float * buf, const float * gains, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_avx512_mix_buffers_with_gain_vector (float * dst, const float * src, const float * gains, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512_crossfade_buffers            (float * dst, const float * src, const float * gains, uint32_t nframes);
 
 /* debug wrappers for SSE functions */
 
@@ -62,6 +82,8 @@ LIBARDOUR_API void veclib_find_peaks                 (const ARDOUR::Sample * buf
 LIBARDOUR_API void  veclib_apply_gain_to_buffer      (ARDOUR::Sample * buf, ARDOUR::pframes_t nframes, float gain);
 LIBARDOUR_API void  veclib_mix_buffers_with_gain     (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes, float gain);
 LIBARDOUR_API void  veclib_mix_buffers_no_gain       (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  veclib_apply_gain_vector_to_buffer  (ARDOUR::Sample * buf, const ARDOUR::gain_t * gains, ARDOUR::pframes_t nframes, float gain);
+LIBARDOUR_API void  veclib_mix_buffers_with_gain_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, const ARDOUR::gain_t * gains, ARDOUR::pframes_t nframes);
 
 #endif
 
@@ -73,5 +95,8 @@ LIBARDOUR_API void  default_apply_gain_to_buffer      (ARDOUR::Sample * buf, ARD
 LIBARDOUR_API void  default_mix_buffers_with_gain     (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes, float gain);
 LIBARDOUR_API void  default_mix_buffers_no_gain       (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes);
 LIBARDOUR_API void  default_copy_vector				  (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  default_apply_gain_vector_to_buffer  (ARDOUR::Sample * buf, const ARDOUR::gain_t * gains, ARDOUR::pframes_t nframes, float gain);
+LIBARDOUR_API void  default_mix_buffers_with_gain_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, const ARDOUR::gain_t * gains, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  default_crossfade_buffers            (ARDOUR::Sample * dst, const ARDOUR::Sample * src, const ARDOUR::gain_t * gains, ARDOUR::pframes_t nframes);
 
 #endif /* __ardour_mix_h__ */
@@ -0,0 +1,84 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __ardour_mmap_file_source_h__
+#define __ardour_mmap_file_source_h__
+
+#include <string>
+
+#include "ardour/audiofilesource.h"
+
+namespace ARDOUR {
+
+/** A read-only audio file source whose sample data is memory-mapped.
+ *
+ *  Only mono files holding 32 bit float samples in the host's byte order
+ *  (WAV, WAVEX and RF64 on little-endian machines) can be used this way,
+ *  since their data chunk is already an array of Samples; constructors
+ *  throw failed_constructor for anything else, and the caller is expected
+ *  to fall back to SndFileSource.
+ *
+ *  Reads are a memcpy from the mapping, and mapped_data() lets callers use
+ *  the samples in place. The kernel is told to read ahead of wherever reads
+ *  are happening, so playback rarely has to wait for a page fault.
+ */
+class LIBARDOUR_API MmapFileSource : public AudioFileSource {
+  public:
+	/** Constructor for existing in-session files during session loading */
+	MmapFileSource (Session&, const XMLNode&);
+
+	/** Constructor for existing external-to-session files. They are never writable or removable. */
+	MmapFileSource (Session&, const std::string& path, int chn, Flag flags);
+
+	~MmapFileSource ();
+
+	float sample_rate () const { return _sample_rate; }
+	int update_header (framepos_t, struct tm&, time_t) { return 0; }
+	int flush_header () { return 0; }
+	void flush () {}
+	bool clamped_at_unity () const { return false; }
+
+	framepos_t natural_position () const { return _timeline_position; }
+	uint32_t channel_count () const { return 1; }
+
+	Sample const * mapped_data (framepos_t start, framecnt_t cnt) const;
+	void prefetch (framepos_t start, framecnt_t cnt, AsyncReader&) const;
+
+  protected:
+	void close () {}
+	void set_header_timeline_position () {}
+	framecnt_t read_unlocked (Sample* dst, framepos_t start, framecnt_t cnt) const;
+	framecnt_t write_unlocked (Sample*, framecnt_t) { return 0; }
+
+  private:
+	float    _sample_rate;
+	char*    _map;          ///< start of the mapping, which is page aligned
+	size_t   _map_length;
+	Sample*  _data;         ///< first sample of the data chunk, within _map
+	mutable framepos_t _readahead_start;
+	mutable framepos_t _readahead_end;
+
+	void init_mmap ();
+	void readahead (framepos_t start, framecnt_t cnt) const;
+	void advise (framepos_t start, framecnt_t cnt) const;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_mmap_file_source_h__ */
@@ -24,6 +24,7 @@
 #include <set>
 #include <map>
 #include <list>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/utility.hpp>
@@ -32,6 +33,7 @@
 
 #include <glib.h>
 
+#include "pbd/interval_tree.h"
 #include "pbd/undo.h"
 #include "pbd/stateful.h"
 #include "pbd/statefuldestructible.h"
@@ -118,6 +120,7 @@ public:
 	bool hidden() const { return _hidden; }
 	bool empty() const;
 	uint32_t n_regions() const;
+	boost::shared_ptr<Region> first_region () const;
 	bool all_regions_empty() const;
 	std::pair<framepos_t, framepos_t> get_extent () const;
 	std::pair<framepos_t, framepos_t> get_extent_with_endspace() const;
@@ -165,6 +168,7 @@ public:
 
 	const RegionListProperty& region_list_property () const { return regions; }
 	boost::shared_ptr<RegionList> region_list();
+	void reindex_region (boost::shared_ptr<Region>);
 
 	boost::shared_ptr<RegionList> regions_at (framepos_t frame);
 	uint32_t                   count_regions_at (framepos_t) const;
@@ -274,6 +278,16 @@ public:
     };
 
 	RegionListProperty   regions;  /* the current list of regions in the playlist */
+	/** the bounds of every region in `regions', for range queries.
+	 *  A region that moves is re-indexed by region_changed_proxy(), or by
+	 *  the region itself while its change signals are suspended; either may
+	 *  run with or without region_lock held, so the index has a lock
+	 *  of its own; it is only held while the index itself is used.
+	 */
+	PBD::IntervalTree<framepos_t, boost::shared_ptr<Region> > region_index;
+	mutable Glib::Threads::RWLock region_index_lock;
+	void index_region (boost::shared_ptr<Region>);
+	void unindex_region (boost::shared_ptr<Region>);
 	std::set<boost::shared_ptr<Region> > all_regions; /* all regions ever added to this playlist */
 	PBD::ScopedConnectionList region_state_changed_connections;
 	PBD::ScopedConnectionList region_drop_references_connections;
@@ -327,6 +341,7 @@ public:
 	void _set_sort_id ();
 
 	boost::shared_ptr<RegionList> regions_touched_locked (framepos_t start, framepos_t end);
+	void regions_touched_locked (framepos_t start, framepos_t end, std::vector<boost::shared_ptr<Region> >& result) const;
 
 	void notify_region_removed (boost::shared_ptr<Region>);
 	void notify_region_added (boost::shared_ptr<Region>);
@@ -404,6 +419,7 @@ public:
 	void setup_layering_indices (RegionList const &);
 	void coalesce_and_check_crossfades (std::list<Evoral::Range<framepos_t> >);
 	boost::shared_ptr<RegionList> find_regions_at (framepos_t);
+	boost::shared_ptr<Region> top_region_at_locked (framepos_t, bool unmuted_only);
 
 	framepos_t _end_space;  //this is used when we are pasting a range with extra space at the end
 };
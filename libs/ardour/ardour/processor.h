@@ -25,6 +25,7 @@
 #include <exception>
 
 #include "pbd/statefuldestructible.h"
+#include "pbd/timing.h"
 
 #include "ardour/ardour.h"
 #include "ardour/buffer_set.h"
@@ -130,6 +131,13 @@ class LIBARDOUR_API Processor : public SessionObject, public Automatable, public
 	virtual void set_owner (SessionObject*);
 	SessionObject* owner() const;
 
+	/** Time taken by run() in each process cycle, measured by the owning Route */
+	PBD::TimingStats& dsp_timing () { return _dsp_timing; }
+
+	/** @return false if there are no DSP statistics (yet) */
+	bool get_dsp_stats (PBD::DurationStats& stats) const { return _dsp_timing.get (stats); }
+	void reset_dsp_stats () { _dsp_timing.reset (); }
+
 protected:
 	virtual int set_state_2X (const XMLNode&, int version);
 
@@ -145,6 +153,7 @@ protected:
 	ProcessorWindowProxy *_window_proxy;
 	PluginPinWindowProxy *_pinmgr_proxy;
 	SessionObject* _owner;
+	PBD::TimingStats _dsp_timing;
 };
 
 } // namespace ARDOUR
@@ -97,6 +97,11 @@ CONFIG_VARIABLE (float, audio_capture_buffer_seconds, "capture-buffer-seconds",
 CONFIG_VARIABLE (float, audio_playback_buffer_seconds, "playback-buffer-seconds", 5.0)
 CONFIG_VARIABLE (float, midi_track_buffer_seconds, "midi-track-buffer-seconds", 1.0)
 CONFIG_VARIABLE (uint32_t, disk_choice_space_threshold,  "disk-choice-space-threshold", 57600000)
+CONFIG_VARIABLE (uint32_t, butler_io_threads,  "butler-io-threads", 0)
+CONFIG_VARIABLE (bool, butler_async_read, "butler-async-read", false)
+CONFIG_VARIABLE (bool, mmap_float_sources, "mmap-float-sources", false)
+CONFIG_VARIABLE (uint32_t, peak_building_threads, "peak-building-threads", 0)
+CONFIG_VARIABLE (bool, parallel_session_load, "parallel-session-load", false)
 CONFIG_VARIABLE (bool, auto_analyse_audio, "auto-analyse-audio", false)
 CONFIG_VARIABLE (float, transient_sensitivity, "transient-sensitivity", 50)
 
@@ -214,6 +219,7 @@ CONFIG_VARIABLE (int32_t, history_depth, "history-depth", 20)
 CONFIG_VARIABLE (bool, use_overlap_equivalency, "use-overlap-equivalency", false)
 CONFIG_VARIABLE (bool, periodic_safety_backups, "periodic-safety-backups", true)
 CONFIG_VARIABLE (uint32_t, periodic_safety_backup_interval, "periodic-safety-backup-interval", 120)
+CONFIG_VARIABLE (bool, incremental_safety_backups, "incremental-safety-backups", false)
 CONFIG_VARIABLE (float, automation_interval_msecs, "automation-interval-msecs", 30)
 #ifdef __APPLE__
 CONFIG_VARIABLE_SPECIAL (std::string, default_session_parent_dir, "default-session-parent-dir", "~/Music", poor_mans_glob)
@@ -224,6 +230,8 @@ CONFIG_VARIABLE_SPECIAL (std::string, default_session_parent_dir, "default-sessi
 #endif
 CONFIG_VARIABLE (bool, allow_special_bus_removal, "allow-special-bus-removal", false)
 CONFIG_VARIABLE (int32_t, processor_usage, "processor-usage", -1)
+/* NUMA node whose cores the DSP threads are bound to, one thread per core; -1 to leave them unbound */
+CONFIG_VARIABLE (int32_t, dsp_numa_node, "dsp-numa-node", -1)
 CONFIG_VARIABLE (gain_t, max_gain, "max-gain", 2.0) /* +6.0dB */
 CONFIG_VARIABLE (uint32_t, max_recent_sessions, "max-recent-sessions", 10)
 CONFIG_VARIABLE (uint32_t, max_recent_templates, "max-recent-templates", 10)
@@ -245,6 +253,7 @@ CONFIG_VARIABLE (int, vst_scan_timeout, "vst-scan-timeout", 600) /* deciseconds,
 CONFIG_VARIABLE (bool, discover_audio_units, "discover-audio-units", false)
 CONFIG_VARIABLE (bool, ask_replace_instrument, "ask-replace-instrument", true)
 CONFIG_VARIABLE (bool, ask_setup_instrument, "ask-setup-instrument", true)
+CONFIG_VARIABLE (uint32_t, plugin_automation_interval, "plugin-automation-interval", 0) /* samples; plugin runs are only split at multiples of this, delaying automation by up to interval - 1 samples. 0: split at every automation event */
 
 /* custom user plugin paths */
 CONFIG_VARIABLE (std::string, plugin_path_vst, "plugin-path-vst", "@default@")
@@ -281,3 +290,5 @@ CONFIG_VARIABLE (bool, show_video_server_dialog, "show-video-server-dialog", fal
 
 CONFIG_VARIABLE (float, export_preroll, "export-preroll", 10.0) // seconds
 CONFIG_VARIABLE (float, export_silence_threshold, "export-silence-threshold", -INFINITY) // dB
+CONFIG_VARIABLE (bool, export_analysis_prepass, "export-analysis-prepass", false)
+CONFIG_VARIABLE (bool, export_chain_timespans, "export-chain-timespans", true) // roll on from one timespan to the next instead of relocating
@@ -31,6 +31,9 @@ namespace ARDOUR {
 	typedef void  (*mix_buffers_with_gain_t)	(ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float);
 	typedef void  (*mix_buffers_no_gain_t)		(ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 	typedef void  (*copy_vector_t)			    (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
+	typedef void  (*apply_gain_vector_to_buffer_t)  (ARDOUR::Sample *, const ARDOUR::gain_t *, pframes_t, float);
+	typedef void  (*mix_buffers_with_gain_vector_t) (ARDOUR::Sample *, const ARDOUR::Sample *, const ARDOUR::gain_t *, pframes_t);
+	typedef void  (*crossfade_buffers_t)            (ARDOUR::Sample *, const ARDOUR::Sample *, const ARDOUR::gain_t *, pframes_t);
 
 	LIBARDOUR_API extern compute_peak_t		compute_peak;
 	LIBARDOUR_API extern find_peaks_t               find_peaks;
@@ -38,6 +41,15 @@ namespace ARDOUR {
 	LIBARDOUR_API extern mix_buffers_with_gain_t	mix_buffers_with_gain;
 	LIBARDOUR_API extern mix_buffers_no_gain_t	mix_buffers_no_gain;
 	LIBARDOUR_API extern copy_vector_t			copy_vector;
+
+	/* per-sample gains, for fades and envelopes:
+	 *   apply_gain_vector_to_buffer:  buf[i] *= gains[i] * gain
+	 *   mix_buffers_with_gain_vector: dst[i] += src[i] * gains[i]
+	 *   crossfade_buffers:            dst[i] = dst[i] * (1 - gains[i]) + src[i] * gains[i]
+	 */
+	LIBARDOUR_API extern apply_gain_vector_to_buffer_t  apply_gain_vector_to_buffer;
+	LIBARDOUR_API extern mix_buffers_with_gain_vector_t mix_buffers_with_gain_vector;
+	LIBARDOUR_API extern crossfade_buffers_t            crossfade_buffers;
 }
 
 #endif /* __ardour_runtime_functions_h__ */
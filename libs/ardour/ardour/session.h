@@ -1108,6 +1108,12 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 
 	std::list<std::string> unknown_processors () const;
 
+	/** @return the @param n processors of all routes that take longest
+	 *  to run, on average, most expensive first.
+	 */
+	std::vector<boost::shared_ptr<Processor> > most_expensive_processors (uint32_t n) const;
+	void reset_dsp_stats ();
+
 	/** Emitted when a feedback cycle has been detected within Ardour's signal
 	    processing path.  Until it is fixed (by the user) some (unspecified)
 	    routes will not be run.
@@ -1380,6 +1386,12 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 
 	XMLTree*         state_tree;
 	bool             state_was_pending;
+
+	/* the state file (in the session dir) that pending state may be saved
+	 * as a journal against, or empty if there is none.
+	 */
+	std::string     _state_journal_base;
+	bool            _pending_state_is_journal;
 	StateOfTheState _state_of_the_state;
 
 	friend class    StateProtector;
@@ -1390,6 +1402,7 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 
 	int      load_options (const XMLNode&);
 	int      load_state (std::string snapshot_name);
+	int      resolve_state_journal (XMLNode&);
 
 	framepos_t _last_roll_location;
 	/** the session frame time at which we last rolled, located, or changed transport direction */
@@ -1871,7 +1884,7 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 
 	void  update_latency (bool playback);
 
-	XMLNode& state(bool);
+	XMLNode& state(bool, bool only_changed_playlists = false);
 
 	/* click track */
 	typedef std::list<Click*> Clicks;
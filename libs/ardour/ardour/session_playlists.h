@@ -20,6 +20,7 @@
 #ifndef __ardour_session_playlists_h__
 #define __ardour_session_playlists_h__
 
+#include <map>
 #include <set>
 #include <vector>
 #include <string>
@@ -27,14 +28,11 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/function.hpp>
 
+#include "pbd/id.h"
 #include "pbd/signals.h"
 
 class XMLNode;
 
-namespace PBD {
-	class ID;
-}
-
 namespace ARDOUR {
 
 class Playlist;
@@ -73,7 +71,10 @@ private:
 
 	void find_equivalent_playlist_regions (boost::shared_ptr<Region>, std::vector<boost::shared_ptr<Region> >& result);
 	void update_after_tempo_map_change ();
-	void add_state (XMLNode *, bool);
+	void add_state (XMLNode *, bool full_state, bool only_changed = false);
+	void mark_saved ();
+	void count_changed_since_saved (uint32_t& changed, uint32_t& total) const;
+	bool changed_since_saved (boost::shared_ptr<Playlist>) const;
 	bool maybe_delete_unused (boost::function<int(boost::shared_ptr<Playlist>)>);
 	int load (Session &, const XMLNode&);
 	int load_unused (Session &, const XMLNode&);
@@ -83,6 +84,10 @@ private:
 	typedef std::set<boost::shared_ptr<Playlist> > List;
 	List playlists;
 	List unused_playlists;
+
+	/* state_generation() of each playlist as of the last mark_saved() */
+	typedef std::map<PBD::ID, uint32_t> Generations;
+	Generations saved_generations;
 };
 
 }
@@ -91,13 +91,21 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 	framecnt_t write_unlocked (Sample *dst, framecnt_t cnt);
 	framecnt_t write_float (Sample* data, framepos_t pos, framecnt_t cnt);
 
+	void prefetch (framepos_t start, framecnt_t cnt, AsyncReader&) const;
+
   private:
 	SNDFILE* _sndfile;
 	SF_INFO _info;
 	BroadcastInfo *_broadcast_info;
 
+	/* for prefetch(); _fd is -1 unless the file is uncompressed and open */
+	int      _fd;
+	off_t    _data_offset;
+	uint32_t _bytes_per_frame;
+
 	void init_sndfile ();
 	int open();
+	void setup_prefetch (int fd);
 	int setup_broadcast_info (framepos_t when, struct tm&, time_t);
 	void file_closed ();
 
@@ -43,6 +43,19 @@ class LIBARDOUR_API SourceFactory {
 	static PBD::Signal1<void,boost::shared_ptr<Source> > SourceCreated;
 
 	static boost::shared_ptr<Source> create (Session&, const XMLNode& node, bool async = false);
+
+	/** Open the audio file described by @param node, as create() would,
+	 *  but do not set up its peakfile or announce it. This does not touch
+	 *  any state shared with other sources, so several may be opened at
+	 *  once from different threads while a session loads.
+	 *  Throws MissingSource or failed_constructor.
+	 */
+	static boost::shared_ptr<Source> open_audio_file (Session&, const XMLNode& node);
+
+	/** Finish what open_audio_file() began: set up the peakfile and
+	 *  emit SourceCreated. Returns 0 if the peakfile could not be set up.
+	 */
+	static boost::shared_ptr<Source> announce (boost::shared_ptr<Source>, bool async = false);
 	static boost::shared_ptr<Source> createSilent (Session&, const XMLNode& node,
 	                                               framecnt_t nframes, float sample_rate);
 
@@ -70,6 +83,18 @@ class LIBARDOUR_API SourceFactory {
 
 	static int peak_work_queue_length ();
 	static int setup_peakfile (boost::shared_ptr<Source>, bool async);
+
+	/** Build peaks for @param as before those of any other source that is
+	 *  waiting for them (e.g. because it is visible in the editor).
+	 *  Does nothing if @param as is not waiting.
+	 */
+	static void prioritize_peakfile (boost::shared_ptr<AudioSource> as);
+
+	/** Emitted by a peak building thread after it has finished with a
+	 *  source. The arguments are the number of sources done and the number
+	 *  queued, both counted since the queue was last empty.
+	 */
+	static PBD::Signal2<void,uint32_t,uint32_t> PeakBuildingProgress;
 };
 
 }
@@ -36,6 +36,7 @@ public:
 	~ThreadBuffers ();
 
 	void ensure_buffers (ChanCount howmany = ChanCount::ZERO, size_t custom = 0);
+	void reallocate ();
 
 	BufferSet* silent_buffers;
 	BufferSet* scratch_buffers;
@@ -50,6 +51,9 @@ public:
 
 private:
 	void allocate_pan_automation_buffers (framecnt_t nframes, uint32_t howmany, bool force);
+
+	/** the `custom' size passed to the last ensure_buffers() */
+	size_t _custom;
 };
 
 } // namespace
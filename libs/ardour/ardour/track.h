@@ -28,6 +28,7 @@
 
 namespace ARDOUR {
 
+class AsyncReader;
 class Session;
 class Playlist;
 class RouteGroup;
@@ -157,6 +158,8 @@ class LIBARDOUR_API Track : public Route, public Recordable, public PublicDiskst
 	float playback_buffer_load () const;
 	float capture_buffer_load () const;
 	int do_refill ();
+	int do_refill_with_buffers (Sample* mixdown_buffer, float* gain_buffer);
+	void prefetch (AsyncReader&);
 	int do_flush (RunContext, bool force = false);
 	void set_pending_overwrite (bool);
 	int seek (framepos_t, bool complete_refill = false);
@@ -0,0 +1,325 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifdef WAF_BUILD
+#include "libardour-config.h"
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <stdint.h>
+
+#ifndef PLATFORM_WINDOWS
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#elif !defined PLATFORM_WINDOWS
+#include <aio.h>
+#endif
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+
+#include "ardour/async_reader.h"
+#include "ardour/debug.h"
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+
+#ifdef HAVE_LIBURING
+
+struct AsyncReader::Backend {
+	struct io_uring ring;
+};
+
+static const char* backend_name = "io_uring";
+
+#elif !defined PLATFORM_WINDOWS
+
+struct AsyncReader::Backend {
+	Backend (size_t n) : cbs (new struct aiocb[n]), list (new struct aiocb*[n]), spare (new struct aiocb*[n]), n_spare (n) {
+		for (size_t i = 0; i < n; ++i) {
+			spare[i] = &cbs[i];
+		}
+	}
+	~Backend () { delete [] cbs; delete [] list; delete [] spare; }
+	struct aiocb*  cbs;
+	struct aiocb** list;  ///< started and not yet reaped; the first _n_in_flight are used
+	struct aiocb** spare; ///< control blocks not in use
+	size_t         n_spare;
+};
+
+static const char* backend_name = "POSIX AIO";
+
+#else
+
+struct AsyncReader::Backend {};
+
+static const char* backend_name = "none";
+
+#endif
+
+AsyncReader::AsyncReader (size_t max_requests, size_t max_read)
+	: _backend (0)
+	, _usable (false)
+	, _queue (new Request[max_requests])
+	, _max_requests (max_requests)
+	, _max_read (max_read)
+	, _n_queued (0)
+	, _n_in_flight (0)
+	, _scratch (new char[max_read])
+{
+#ifdef HAVE_LIBURING
+	_backend = new Backend;
+	int const r = io_uring_queue_init (max_requests, &_backend->ring, 0);
+	if (r < 0) {
+		warning << string_compose (_("AsyncReader: cannot set up io_uring (%1)"), strerror (-r)) << endmsg;
+		delete _backend;
+		_backend = 0;
+		return;
+	}
+	_usable = true;
+#elif !defined PLATFORM_WINDOWS
+	_backend = new Backend (max_requests);
+	_usable = true;
+#endif
+}
+
+AsyncReader::~AsyncReader ()
+{
+	cancel ();
+	wait ();
+
+	for (size_t i = 0; i < _n_queued; ++i) {
+		done (_queue[i].fd);
+	}
+
+#ifdef HAVE_LIBURING
+	if (_backend) {
+		io_uring_queue_exit (&_backend->ring);
+	}
+#endif
+
+	delete _backend;
+	delete [] _queue;
+	delete [] _scratch;
+}
+
+const char*
+AsyncReader::backend () const
+{
+	return _usable ? backend_name : "none";
+}
+
+bool
+AsyncReader::add (int fd, off_t offset, size_t len)
+{
+	if (!_usable || fd < 0) {
+		return false;
+	}
+
+#ifndef PLATFORM_WINDOWS
+	while (len) {
+		if (_n_queued + _n_in_flight >= _max_requests) {
+			return false;
+		}
+
+		/* our own descriptor, so that the caller may close theirs
+		 * while the read is still in flight.
+		 */
+		int const dfd = dup (fd);
+
+		if (dfd < 0) {
+			return false;
+		}
+
+		Request& r (_queue[_n_queued++]);
+		r.fd = dfd;
+		r.offset = offset;
+		r.len = len < _max_read ? len : _max_read;
+
+		offset += r.len;
+		len -= r.len;
+	}
+#endif
+
+	return true;
+}
+
+size_t
+AsyncReader::submit ()
+{
+	if (!_usable || _n_queued == 0) {
+		return 0;
+	}
+
+	size_t n = 0;
+
+#ifdef HAVE_LIBURING
+
+	for (; n < _n_queued; ++n) {
+		struct io_uring_sqe* sqe = io_uring_get_sqe (&_backend->ring);
+		if (!sqe) {
+			break;
+		}
+		io_uring_prep_read (sqe, _queue[n].fd, _scratch, _queue[n].len, _queue[n].offset);
+		io_uring_sqe_set_data (sqe, (void*) (intptr_t) _queue[n].fd);
+	}
+
+	for (size_t i = n; i < _n_queued; ++i) {
+		done (_queue[i].fd);
+	}
+
+	int const r = io_uring_submit (&_backend->ring);
+
+	if (r < 0) {
+		/* the prepared entries stay in the ring; wait() submits them */
+		DEBUG_TRACE (DEBUG::Butler, string_compose ("io_uring_submit failed: %1\n", strerror (-r)));
+	}
+
+#elif !defined PLATFORM_WINDOWS
+
+	for (size_t i = 0; i < _n_queued; ++i) {
+		struct aiocb* cb = _backend->spare[--_backend->n_spare];
+		memset (cb, 0, sizeof (struct aiocb));
+		cb->aio_fildes = _queue[i].fd;
+		cb->aio_offset = _queue[i].offset;
+		cb->aio_buf = _scratch;
+		cb->aio_nbytes = _queue[i].len;
+		cb->aio_lio_opcode = LIO_READ;
+		_backend->list[_n_in_flight + i] = cb;
+	}
+
+	if (lio_listio (LIO_NOWAIT, &_backend->list[_n_in_flight], _n_queued, 0) != 0) {
+		/* some requests may have been queued anyway (EAGAIN, EIO);
+		 * reap() and wait() sort them out via aio_error().
+		 */
+		DEBUG_TRACE (DEBUG::Butler, string_compose ("lio_listio failed: %1\n", strerror (errno)));
+	}
+
+	n = _n_queued;
+
+#endif
+
+	_n_in_flight += n;
+	_n_queued = 0;
+
+	return n;
+}
+
+void
+AsyncReader::reap ()
+{
+	if (!_backend || _n_in_flight == 0) {
+		return;
+	}
+
+#ifdef HAVE_LIBURING
+
+	struct io_uring_cqe* cqe;
+
+	while (_n_in_flight && io_uring_peek_cqe (&_backend->ring, &cqe) == 0) {
+		done ((int) (intptr_t) io_uring_cqe_get_data (cqe));
+		io_uring_cqe_seen (&_backend->ring, cqe);
+		--_n_in_flight;
+	}
+
+#elif !defined PLATFORM_WINDOWS
+
+	size_t still = 0;
+
+	for (size_t i = 0; i < _n_in_flight; ++i) {
+		struct aiocb* cb = _backend->list[i];
+		if (aio_error (cb) == EINPROGRESS) {
+			_backend->list[still++] = cb;
+			continue;
+		}
+		/* we don't care about the result, but must collect it */
+		aio_return (cb);
+		done (cb->aio_fildes);
+		_backend->spare[_backend->n_spare++] = cb;
+	}
+
+	_n_in_flight = still;
+
+#endif
+}
+
+void
+AsyncReader::wait ()
+{
+	if (!_backend || _n_in_flight == 0) {
+		return;
+	}
+
+#ifdef HAVE_LIBURING
+
+	while (_n_in_flight) {
+		if (io_uring_submit_and_wait (&_backend->ring, 1) < 0) {
+			break;
+		}
+		reap ();
+	}
+
+#elif !defined PLATFORM_WINDOWS
+
+	for (size_t i = 0; i < _n_in_flight; ++i) {
+		struct aiocb* cb = _backend->list[i];
+		while (aio_error (cb) == EINPROGRESS) {
+			struct aiocb const * one[1] = { cb };
+			aio_suspend (one, 1, 0);
+		}
+	}
+
+	reap ();
+
+#endif
+}
+
+void
+AsyncReader::cancel ()
+{
+	if (!_backend || _n_in_flight == 0) {
+		return;
+	}
+
+#if !defined HAVE_LIBURING && !defined PLATFORM_WINDOWS
+	for (size_t i = 0; i < _n_in_flight; ++i) {
+		aio_cancel (_backend->list[i]->aio_fildes, _backend->list[i]);
+	}
+#endif
+
+	/* io_uring cannot usefully cancel a read of a regular file once
+	 * submitted; those just finish in the background.
+	 */
+
+	reap ();
+}
+
+void
+AsyncReader::done (int fd)
+{
+#ifndef PLATFORM_WINDOWS
+	::close (fd);
+#endif
+}
@@ -1103,6 +1103,45 @@ AudioDiskstream::_do_refill_with_alloc (bool partial_fill)
 	return ret;
 }
 
+/** Queue background reads of the part of the playlist that _do_refill() will
+ *  read next. This repeats _do_refill()'s checks without looking at loop
+ *  ranges; a wrong guess only costs a wasted read.
+ */
+void
+AudioDiskstream::prefetch (AsyncReader& reader)
+{
+	boost::shared_ptr<ChannelList> c = channels.reader();
+	boost::shared_ptr<AudioPlaylist> pl = audio_playlist ();
+
+	if (c->empty() || !pl || (_session.state_of_the_state() & Session::Loading)) {
+		return;
+	}
+
+	framecnt_t cnt = c->front()->playback_buf->write_space ();
+
+	if (cnt == 0 || ((cnt < disk_read_chunk_frames) && fabs (_actual_speed) < 2.0f)) {
+		return;
+	}
+
+	framepos_t start;
+
+	if ((_visible_speed * _session.transport_speed()) < 0.0f) {
+		cnt = min (cnt, file_frame);
+		start = file_frame - cnt;
+	} else {
+		cnt = min (cnt, max_framepos - file_frame);
+		start = file_frame;
+	}
+
+	if (cnt == 0) {
+		return;
+	}
+
+	for (uint32_t n = 0; n < c->size(); ++n) {
+		pl->prefetch (start, cnt, n, reader);
+	}
+}
+
 /** Get some more data from disk and put it in our channels' playback_bufs,
  *  if there is suitable space in them.
  *
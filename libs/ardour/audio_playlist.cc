@@ -140,7 +140,7 @@ AudioPlaylist::AudioPlaylist (boost::shared_ptr<const AudioPlaylist> other, fram
 
 /** Sort by descending layer and then by ascending position */
 struct ReadSorter {
-    bool operator() (boost::shared_ptr<Region> a, boost::shared_ptr<Region> b) {
+    bool operator() (boost::shared_ptr<Region> const & a, boost::shared_ptr<Region> const & b) const {
 	    if (a->layer() != b->layer()) {
 		    return a->layer() > b->layer();
 	    }
@@ -157,6 +157,25 @@ struct Segment {
 	Evoral::Range<framepos_t> range;       ///< range of the region to read, in session frames
 };
 
+/** Queue background reads, on @param reader, of the source data that
+ *  read() would need for the same range and channel.
+ */
+void
+AudioPlaylist::prefetch (framepos_t start, framecnt_t cnt, uint32_t chan_n, AsyncReader& reader)
+{
+	RegionReadLock rl (this);
+
+	vector<boost::shared_ptr<Region> > all;
+	regions_touched_locked (start, start + cnt - 1, all);
+
+	for (vector<boost::shared_ptr<Region> >::const_iterator i = all.begin(); i != all.end(); ++i) {
+		boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
+		if (ar) {
+			ar->prefetch (start, cnt, chan_n, reader);
+		}
+	}
+}
+
 /** @param start Start position in session frames.
  *  @param cnt Number of frames to read.
  */
@@ -191,8 +210,9 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, fr
 	/* Find all the regions that are involved in the bit we are reading,
 	   and sort them by descending layer and ascending position.
 	*/
-	boost::shared_ptr<RegionList> all = regions_touched_locked (start, start + cnt - 1);
-	all->sort (ReadSorter ());
+	vector<boost::shared_ptr<Region> > all;
+	regions_touched_locked (start, start + cnt - 1, all);
+	stable_sort (all.begin(), all.end(), ReadSorter ());
 
 	/* This will be a list of the bits of our read range that we have
 	   handled completely (ie for which no more regions need to be read).
@@ -204,7 +224,7 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, fr
 	list<Segment> to_do;
 
 	/* Now go through the `all' list filling in `to_do' and `done' */
-	for (RegionList::iterator i = all->begin(); i != all->end(); ++i) {
+	for (vector<boost::shared_ptr<Region> >::iterator i = all.begin(); i != all.end(); ++i) {
 		boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
 
 		/* muted regions don't figure into it at all */
@@ -298,6 +318,7 @@ AudioPlaylist::destroy_region (boost::shared_ptr<Region> region)
 
 			if ((*i) == region) {
 				regions.erase (i);
+				unindex_region (region);
 				changed = true;
 			}
 
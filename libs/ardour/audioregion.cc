@@ -51,6 +51,7 @@
 #include "ardour/progress.h"
 
 #include "ardour/sndfilesource.h"
+#include "ardour/mmap_file_source.h"
 #ifdef HAVE_COREAUDIO
 #include "ardour/coreaudiosource.h"
 #endif // HAVE_COREAUDIO
@@ -575,31 +576,37 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 	   We can never read directly into buf, since it may contain data
 	   from a region `below' this one in the stack, and our fades (if they exist)
 	   may need to mix with the existing data.
+
+	   If there is no gain to apply and the source holds the data in memory
+	   (e.g. a memory-mapped file) we can use it from there instead, and
+	   skip the copy into mixdown_buffer.
 	*/
 
-	if (read_from_sources (_sources, _length, mixdown_buffer, position, to_read, chan_n) != to_read) {
-		return 0;
+	Sample const * data = 0;
+
+	if (!envelope_active() && _scale_amplitude == 1.0f) {
+		data = mapped_source_data (position, to_read, chan_n);
 	}
 
-	/* APPLY REGULAR GAIN CURVES AND SCALING TO mixdown_buffer */
+	if (!data) {
 
-	if (envelope_active())  {
-		_envelope->curve().get_vector (internal_offset, internal_offset + to_read, gain_buffer, to_read);
+		if (read_from_sources (_sources, _length, mixdown_buffer, position, to_read, chan_n) != to_read) {
+			return 0;
+		}
 
-		if (_scale_amplitude != 1.0f) {
-			for (framecnt_t n = 0; n < to_read; ++n) {
-				mixdown_buffer[n] *= gain_buffer[n] * _scale_amplitude;
-			}
-		} else {
-			for (framecnt_t n = 0; n < to_read; ++n) {
-				mixdown_buffer[n] *= gain_buffer[n];
-			}
+		/* APPLY REGULAR GAIN CURVES AND SCALING TO mixdown_buffer */
+
+		if (envelope_active())  {
+			_envelope->curve().get_vector (internal_offset, internal_offset + to_read, gain_buffer, to_read);
+			apply_gain_vector_to_buffer (mixdown_buffer, gain_buffer, to_read, _scale_amplitude);
+		} else if (_scale_amplitude != 1.0f) {
+			apply_gain_to_buffer (mixdown_buffer, to_read, _scale_amplitude);
 		}
-	} else if (_scale_amplitude != 1.0f) {
-		apply_gain_to_buffer (mixdown_buffer, to_read, _scale_amplitude);
+
+		data = mixdown_buffer;
 	}
 
-	/* APPLY FADES TO THE DATA IN mixdown_buffer AND MIX THE RESULTS INTO
+	/* APPLY FADES TO OUR DATA AND MIX THE RESULTS INTO
 	 * buf. The key things to realize here: (1) the fade being applied is
 	 * (as of April 26th 2012) just the inverse of the fade in curve (2)
 	 * "buf" contains data from lower regions already. So this operation
@@ -618,33 +625,29 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 				_inverse_fade_in->curve().get_vector (internal_offset, internal_offset + fade_in_limit, gain_buffer, fade_in_limit);
 
 				/* Fade the data from lower layers out */
-				for (framecnt_t n = 0; n < fade_in_limit; ++n) {
-					buf[n] *= gain_buffer[n];
-				}
+				apply_gain_vector_to_buffer (buf, gain_buffer, fade_in_limit, 1.0f);
 
-				/* refill gain buffer with the fade in */
+				/* refill gain buffer with the fade in, and mix our
+				 * newly-read data in with it
+				 */
 
 				_fade_in->curve().get_vector (internal_offset, internal_offset + fade_in_limit, gain_buffer, fade_in_limit);
+				mix_buffers_with_gain_vector (buf, data, gain_buffer, fade_in_limit);
 
 			} else {
 
 				/* no explicit inverse fade in, so just use (1 - fade
-				 * in) for the fade out of lower layers
+				 * in) for the fade out of lower layers, and mix our
+				 * data in with the fade in the same pass.
 				 */
 
 				_fade_in->curve().get_vector (internal_offset, internal_offset + fade_in_limit, gain_buffer, fade_in_limit);
-
-				for (framecnt_t n = 0; n < fade_in_limit; ++n) {
-					buf[n] *= 1 - gain_buffer[n];
-				}
+				crossfade_buffers (buf, data, gain_buffer, fade_in_limit);
 			}
 		} else {
+			/* Mix our newly-read data in, with the fade */
 			_fade_in->curve().get_vector (internal_offset, internal_offset + fade_in_limit, gain_buffer, fade_in_limit);
-		}
-
-		/* Mix our newly-read data in, with the fade */
-		for (framecnt_t n = 0; n < fade_in_limit; ++n) {
-			buf[n] += mixdown_buffer[n] * gain_buffer[n];
+			mix_buffers_with_gain_vector (buf, data, gain_buffer, fade_in_limit);
 		}
 	}
 
@@ -658,13 +661,12 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 				_inverse_fade_out->curve().get_vector (curve_offset, curve_offset + fade_out_limit, gain_buffer, fade_out_limit);
 
 				/* Fade the data from lower levels in */
-				for (framecnt_t n = 0, m = fade_out_offset; n < fade_out_limit; ++n, ++m) {
-					buf[m] *= gain_buffer[n];
-				}
+				apply_gain_vector_to_buffer (buf + fade_out_offset, gain_buffer, fade_out_limit, 1.0f);
 
-				/* fetch the actual fade out */
+				/* fetch the actual fade out, and mix our data in with it */
 
 				_fade_out->curve().get_vector (curve_offset, curve_offset + fade_out_limit, gain_buffer, fade_out_limit);
+				mix_buffers_with_gain_vector (buf + fade_out_offset, data + fade_out_offset, gain_buffer, fade_out_limit);
 
 			} else {
 
@@ -674,33 +676,27 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 				 */
 
 				_fade_out->curve().get_vector (curve_offset, curve_offset + fade_out_limit, gain_buffer, fade_out_limit);
-
-				for (framecnt_t n = 0, m = fade_out_offset; n < fade_out_limit; ++n, ++m) {
-					buf[m] *= 1 - gain_buffer[n];
-				}
+				crossfade_buffers (buf + fade_out_offset, data + fade_out_offset, gain_buffer, fade_out_limit);
 			}
 		} else {
+			/* Mix our newly-read data with whatever was already there,
+			   with the fade out applied to our data.
+			*/
 			_fade_out->curve().get_vector (curve_offset, curve_offset + fade_out_limit, gain_buffer, fade_out_limit);
-		}
-
-		/* Mix our newly-read data with whatever was already there,
-		   with the fade out applied to our data.
-		*/
-		for (framecnt_t n = 0, m = fade_out_offset; n < fade_out_limit; ++n, ++m) {
-			buf[m] += mixdown_buffer[m] * gain_buffer[n];
+			mix_buffers_with_gain_vector (buf + fade_out_offset, data + fade_out_offset, gain_buffer, fade_out_limit);
 		}
 	}
 
-	/* MIX OR COPY THE REGION BODY FROM mixdown_buffer INTO buf */
+	/* MIX OR COPY THE REGION BODY INTO buf */
 
 	framecnt_t const N = to_read - fade_in_limit - fade_out_limit;
 	if (N > 0) {
 		if (opaque ()) {
-			DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("Region %1 memcpy into buf @ %2 + %3, from mixdown buffer @ %4 + %5, len = %6 cnt was %7\n",
-									   name(), buf, fade_in_limit, mixdown_buffer, fade_in_limit, N, cnt));
-			memcpy (buf + fade_in_limit, mixdown_buffer + fade_in_limit, N * sizeof (Sample));
+			DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("Region %1 memcpy into buf @ %2 + %3, from %4 @ %5 + %6, len = %7 cnt was %8\n",
+									   name(), buf, fade_in_limit, (data == mixdown_buffer ? "mixdown buffer" : "source"), data, fade_in_limit, N, cnt));
+			memcpy (buf + fade_in_limit, data + fade_in_limit, N * sizeof (Sample));
 		} else {
-			mix_buffers_no_gain (buf + fade_in_limit, mixdown_buffer + fade_in_limit, N);
+			mix_buffers_no_gain (buf + fade_in_limit, data + fade_in_limit, N);
 		}
 	}
 
@@ -766,6 +762,54 @@ AudioRegion::read_from_sources (SourceList const & srcs, framecnt_t limit, Sampl
 	return to_read;
 }
 
+/** @return a pointer to the source data that read_from_sources() would
+ *  copy for @param position, @param cnt and @param chan_n, if the source
+ *  can provide it in place; otherwise 0.
+ */
+Sample const *
+AudioRegion::mapped_source_data (framepos_t position, framecnt_t cnt, uint32_t chan_n) const
+{
+	uint32_t channel = chan_n;
+
+	if (channel >= n_channels()) {
+		if (!Config->get_replicate_missing_region_channels()) {
+			return 0;
+		}
+		channel = chan_n % n_channels();
+	}
+
+	return audio_source (channel)->mapped_data (_start + (position - _position), cnt);
+}
+
+/** Queue background reads, on @param reader, of the source data that
+ *  read_at() would need for @param position, @param cnt and @param chan_n.
+ */
+void
+AudioRegion::prefetch (framepos_t position, framecnt_t cnt, uint32_t chan_n, AsyncReader& reader) const
+{
+	if (n_channels() == 0 || muted()) {
+		return;
+	}
+
+	framepos_t const from = max (position, _position.val());
+	framepos_t const to = min (position + cnt, _position.val() + _length.val());
+
+	if (to <= from) {
+		return;
+	}
+
+	uint32_t channel = chan_n;
+
+	if (channel >= n_channels()) {
+		if (!Config->get_replicate_missing_region_channels()) {
+			return;
+		}
+		channel = chan_n % n_channels();
+	}
+
+	audio_source (channel)->prefetch (_start + (from - _position), to - from, reader);
+}
+
 XMLNode&
 AudioRegion::get_basic_state ()
 {
@@ -1615,6 +1659,9 @@ AudioRegion::get_related_audio_file_channel_count () const
                 chan_count = sndf->channel_count();
             }
         }
+        else if (boost::dynamic_pointer_cast<MmapFileSource>(*i)) {
+            chan_count = max (chan_count, (uint32_t) 1);
+        }
 #ifdef HAVE_COREAUDIO
         else {
             boost::shared_ptr<CoreAudioSource> cauf = boost::dynamic_pointer_cast<CoreAudioSource>(*i);
@@ -89,6 +89,11 @@ AudioSource::AudioSource (Session& s, const string& name)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _last_level (0)
+	, _peak_levels_fd (-1)
+	, _peak_levels_broken (false)
+	, _peak_levels_next (0)
+	, _peak_levels_frames (-1)
 {
 }
 
@@ -105,6 +110,11 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _last_level (0)
+	, _peak_levels_fd (-1)
+	, _peak_levels_broken (false)
+	, _peak_levels_next (0)
+	, _peak_levels_frames (-1)
 {
 	if (set_state (node, Stateful::loading_state_version)) {
 		throw failed_constructor();
@@ -124,6 +134,11 @@ AudioSource::~AudioSource ()
 		_peakfile_fd = -1;
 	}
 
+	if ((-1) != _peak_levels_fd) {
+		close (_peak_levels_fd);
+		_peak_levels_fd = -1;
+	}
+
 	delete [] peak_leftovers;
 }
 
@@ -214,6 +229,9 @@ AudioSource::touch_peakfile ()
 	tbuf.modtime = time ((time_t*) 0);
 
 	g_utime (_peakpath.c_str(), &tbuf);
+
+	/* keep the levels file at least as new as the peakfile, or it will be thought stale */
+	g_utime (peak_levels_path ().c_str(), &tbuf);
 }
 
 int
@@ -230,8 +248,17 @@ AudioSource::rename_peakfile (string newpath)
 		}
 	}
 
+	string const old_levels = peak_levels_path ();
+
 	_peakpath = newpath;
 
+	if (Glib::file_test (old_levels, Glib::FILE_TEST_EXISTS)) {
+		if (g_rename (old_levels.c_str(), peak_levels_path ().c_str()) != 0) {
+			/* not fatal; they will be rebuilt from the peakfile when needed */
+			::g_unlink (old_levels.c_str());
+		}
+	}
+
 	return 0;
 }
 
@@ -243,6 +270,11 @@ AudioSource::initialize_peakfile (const string& audio_path, const bool in_sessio
 
 	_peakpath = construct_peak_filepath (audio_path, in_session);
 
+	{
+		Glib::Threads::Mutex::Lock ll (_peak_levels_lock);
+		_peak_levels_frames = -1;
+	}
+
 	if (!empty() && !Glib::file_test (_peakpath.c_str(), Glib::FILE_TEST_EXISTS)) {
 		string oldpeak = construct_peak_filepath (audio_path, in_session, true);
 		DEBUG_TRACE(DEBUG::Peaks, string_compose ("Looking for old peak file %1 for Audio file %2\n", oldpeak, audio_path));
@@ -345,6 +377,13 @@ int
 AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t start, framecnt_t cnt,
 				  double samples_per_visual_peak, framecnt_t samples_per_file_peak) const
 {
+	/* when zoomed out far enough, the coarser levels of peak data may be
+	   used (see below). Bring them up to date before taking _lock: that
+	   may take a while, and ensure_peak_levels() takes _lock itself.
+	*/
+	const bool use_levels = (samples_per_file_peak == _FPP && samples_per_visual_peak >= (_FPP << 4));
+	const framecnt_t level_frames = use_levels ? ensure_peak_levels () : 0;
+
 	Glib::Threads::Mutex::Lock lm (_lock);
 	double scale;
 	double expected_peaks;
@@ -531,14 +570,33 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 		    to avoid confusion, I'll refer to the requested peaks as visual_peaks and the peakfile peaks as stored_peaks
 		*/
 
-		const framecnt_t chunksize = (framecnt_t) expected_peaks; // we read all the peaks we need in one hit.
+		/* when zoomed out far enough, use one of the coarser levels of
+		   peak data, so that the amount read for each visual peak stays
+		   bounded however long the source is.
+		*/
+
+		uint32_t level = 0;
+		framecnt_t fpp = samples_per_file_peak;
+
+		if (use_levels) {
+			for (uint32_t l = 2; l > 0; --l) {
+				framecnt_t const level_fpp = _FPP << (4 * l);
+				if (samples_per_visual_peak >= level_fpp && cnt >= 2 * level_fpp && start + cnt <= level_frames) {
+					level = l;
+					fpp = level_fpp;
+					break;
+				}
+			}
+		}
+
+		const framecnt_t chunksize = (framecnt_t) (cnt / (double) fpp); // we read all the peaks we need in one hit.
 
 		/* compute the rounded up frame position  */
 
-		framepos_t current_stored_peak = (framepos_t) ceil (start / (double) samples_per_file_peak);
+		framepos_t current_stored_peak = (framepos_t) ceil (start / (double) fpp);
 		framepos_t next_visual_peak  = (framepos_t) ceil (start / samples_per_visual_peak);
 		double     next_visual_peak_frame = next_visual_peak * samples_per_visual_peak;
-		framepos_t stored_peak_before_next_visual_peak = (framepos_t) next_visual_peak_frame / samples_per_file_peak;
+		framepos_t stored_peak_before_next_visual_peak = (framepos_t) next_visual_peak_frame / fpp;
 		framecnt_t nvisual_peaks = 0;
 		uint32_t i = 0;
 
@@ -548,55 +606,62 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 
 		/* open ... close during out: handling */
 
-		off_t  map_off =  (uint32_t) (ceil (start / (double) samples_per_file_peak)) * sizeof(PeakData);
+		off_t  map_off =  (uint32_t) (ceil (start / (double) fpp)) * sizeof(PeakData);
 		off_t  read_map_off = map_off & ~(bufsize - 1);
 		off_t  map_delta = map_off - read_map_off;
 		size_t raw_map_length = chunksize * sizeof(PeakData);
 		size_t map_length = (chunksize * sizeof(PeakData)) + map_delta;
 
-		if (_first_run || (_last_scale != samples_per_visual_peak) || (_last_map_off != map_off) || (_last_raw_map_length < raw_map_length)) {
+		if (_first_run || (_last_scale != samples_per_visual_peak) || (_last_map_off != map_off) || (_last_raw_map_length < raw_map_length) || (_last_level != level)) {
 			peak_cache.reset (new PeakData[npeaks]);
 			boost::scoped_array<PeakData> staging (new PeakData[chunksize]);
 
-			char* addr;
+			if (level > 0) {
+				if (read_peak_level (level, map_off / sizeof (PeakData), chunksize, staging.get())) {
+					return -1;
+				}
+			} else {
+				char* addr;
 #ifdef PLATFORM_WINDOWS
-			HANDLE file_handle =  (HANDLE) _get_osfhandle(int(sfd));
-			HANDLE map_handle;
-			LPVOID view_handle;
-			bool err_flag;
-
-			map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
-			if (map_handle == NULL) {
-				error << string_compose (_("map failed - could not create file mapping for peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
+				HANDLE file_handle =  (HANDLE) _get_osfhandle(int(sfd));
+				HANDLE map_handle;
+				LPVOID view_handle;
+				bool err_flag;
+
+				map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+				if (map_handle == NULL) {
+					error << string_compose (_("map failed - could not create file mapping for peakfile %1."), _peakpath) << endmsg;
+					return -1;
+				}
 
-			view_handle = MapViewOfFile(map_handle, FILE_MAP_READ, 0, read_map_off, map_length);
-			if (view_handle == NULL) {
-				error << string_compose (_("map failed - could not map peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
+				view_handle = MapViewOfFile(map_handle, FILE_MAP_READ, 0, read_map_off, map_length);
+				if (view_handle == NULL) {
+					error << string_compose (_("map failed - could not map peakfile %1."), _peakpath) << endmsg;
+					return -1;
+				}
 
-			addr = (char *) view_handle;
+				addr = (char *) view_handle;
 
-			memcpy ((void*)staging.get(), (void*)(addr + map_delta), raw_map_length);
+				memcpy ((void*)staging.get(), (void*)(addr + map_delta), raw_map_length);
 
-			err_flag = UnmapViewOfFile (view_handle);
-			err_flag = CloseHandle(map_handle);
-			if(!err_flag) {
-				error << string_compose (_("unmap failed - could not unmap peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
+				err_flag = UnmapViewOfFile (view_handle);
+				err_flag = CloseHandle(map_handle);
+				if(!err_flag) {
+					error << string_compose (_("unmap failed - could not unmap peakfile %1."), _peakpath) << endmsg;
+					return -1;
+				}
 #else
-			addr = (char*) mmap (0, map_length, PROT_READ, MAP_PRIVATE, sfd, read_map_off);
-			if (addr ==  MAP_FAILED) {
-				error << string_compose (_("map failed - could not mmap peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
+				addr = (char*) mmap (0, map_length, PROT_READ, MAP_PRIVATE, sfd, read_map_off);
+				if (addr ==  MAP_FAILED) {
+					error << string_compose (_("map failed - could not mmap peakfile %1."), _peakpath) << endmsg;
+					return -1;
+				}
 
-			memcpy ((void*)staging.get(), (void*)(addr + map_delta), raw_map_length);
-			munmap (addr, map_length);
+				memcpy ((void*)staging.get(), (void*)(addr + map_delta), raw_map_length);
+				munmap (addr, map_length);
 #endif
+			}
+
 			while (nvisual_peaks < read_npeaks) {
 
 				xmax = -1.0;
@@ -614,7 +679,7 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 				peak_cache[nvisual_peaks].min = xmin;
 				++nvisual_peaks;
 				next_visual_peak_frame =  min ((double) start + cnt, (next_visual_peak_frame + samples_per_visual_peak));
-				stored_peak_before_next_visual_peak = (uint32_t) next_visual_peak_frame / samples_per_file_peak;
+				stored_peak_before_next_visual_peak = (uint32_t) next_visual_peak_frame / fpp;
 			}
 
 			if (zero_fill) {
@@ -626,6 +691,7 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 			_last_scale = samples_per_visual_peak;
 			_last_map_off = map_off;
 			_last_raw_map_length = raw_map_length;
+			_last_level = level;
 		}
 
 		memcpy ((void*)peaks, (void*)peak_cache.get(), npeaks * sizeof(PeakData));
@@ -802,6 +868,7 @@ AudioSource::close_peakfile ()
 	if (!_peakpath.empty()) {
 		::g_unlink (_peakpath.c_str());
 	}
+	done_with_peak_levels (false);
 	_peaks_built = false;
 	return 0;
 }
@@ -817,6 +884,9 @@ AudioSource::prepare_for_peakfile_writes ()
 		error << string_compose(_("AudioSource: cannot open _peakpath (c) \"%1\" (%2)"), _peakpath, strerror (errno)) << endmsg;
 		return -1;
 	}
+
+	prepare_peak_levels ();
+
 	return 0;
 }
 
@@ -828,6 +898,7 @@ AudioSource::done_with_peakfile_writes (bool done)
 			close (_peakfile_fd);
 			_peakfile_fd = -1;
 		}
+		done_with_peak_levels (false);
 		return;
 	}
 
@@ -835,6 +906,8 @@ AudioSource::done_with_peakfile_writes (bool done)
 		compute_and_write_peaks (0, 0, 0, true, false, _FPP);
 	}
 
+	done_with_peak_levels (done);
+
 	if (done) {
 		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 		_peaks_built = true;
@@ -904,6 +977,10 @@ AudioSource::compute_and_write_peaks (Sample* buf, framecnt_t first_frame, frame
 
 			_peak_byte_max = max (_peak_byte_max, (off_t) (byte + sizeof(PeakData)));
 
+			if (fpp == _FPP) {
+				write_peak_levels (peak_leftover_frame / fpp, &x, 1);
+			}
+
 			{
 				Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 				PeakRangeReady (peak_leftover_frame, peak_leftover_cnt); /* EMIT SIGNAL */
@@ -1030,6 +1107,10 @@ AudioSource::compute_and_write_peaks (Sample* buf, framecnt_t first_frame, frame
 
 	_peak_byte_max = max (_peak_byte_max, (off_t) (first_peak_byte + bytes_to_write));
 
+	if (fpp == _FPP && peaks_computed) {
+		write_peak_levels (first_frame / fpp, peakbuf.get(), peaks_computed);
+	}
+
 	if (frames_done) {
 		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 		PeakRangeReady (first_frame, frames_done); /* EMIT SIGNAL */
@@ -1063,6 +1144,325 @@ AudioSource::truncate_peakfile ()
 	}
 }
 
+/* COARSER LEVELS OF PEAK DATA
+
+   The peakfile holds one peak per _FPP (256) frames. Next to it, in
+   peak_levels_path(), we keep two coarser levels: level 1, with a peak
+   per 4096 frames, and level 2, with a peak per 65536 frames. After a
+   short header the file is a sequence of blocks, one per 65536 frames,
+   each holding the 16 level 1 peaks for those frames followed by their
+   level 2 peak. Both levels grow a block at a time, so the file can be
+   written alongside the peakfile as peaks are computed.
+
+   Peakfiles written by older versions have no levels file; one is built
+   from the peakfile the first time a zoomed-out view needs it.
+*/
+
+namespace {
+
+struct PeakLevelsHeader {
+	char     magic[4];
+	uint32_t version;
+	uint32_t frames_per_peak[3];
+	uint32_t reserved;
+	int64_t  frames; ///< number of source frames covered
+};
+
+const char       peak_levels_magic[4] = { 'A', 'P', 'L', 'V' };
+const uint32_t   peak_levels_version = 1;
+const framecnt_t peaks_per_block = 256; ///< peakfile peaks per block
+const framecnt_t block_size = 17;       ///< PeakData per block
+
+void
+merge_peak (PeakData& into, PeakData const & p, bool first)
+{
+	if (first) {
+		into = p;
+	} else {
+		into.min = min (into.min, p.min);
+		into.max = max (into.max, p.max);
+	}
+}
+
+/** Fold the peakfile peak @param p, which is number @param k within its block, into @param block */
+void
+add_to_block (PeakData* block, PeakData const & p, framecnt_t k)
+{
+	merge_peak (block[k / 16], p, (k % 16) == 0);
+	merge_peak (block[16], p, k == 0);
+}
+
+bool
+write_at (int fd, void const * buf, size_t len, off_t offset)
+{
+	if (lseek (fd, offset, SEEK_SET) != offset) {
+		return false;
+	}
+	return ::write (fd, buf, len) == (ssize_t) len;
+}
+
+off_t
+block_offset (framecnt_t block)
+{
+	return sizeof (PeakLevelsHeader) + block * block_size * sizeof (PeakData);
+}
+
+bool
+write_peak_levels_header (int fd, framecnt_t frames)
+{
+	PeakLevelsHeader h;
+
+	memcpy (h.magic, peak_levels_magic, sizeof (h.magic));
+	h.version = peak_levels_version;
+	h.frames_per_peak[0] = _FPP;
+	h.frames_per_peak[1] = _FPP * 16;
+	h.frames_per_peak[2] = _FPP * 256;
+	h.reserved = 0;
+	h.frames = frames;
+
+	return write_at (fd, &h, sizeof (h), 0);
+}
+
+}
+
+string
+AudioSource::peak_levels_path () const
+{
+	return _peakpath + X_(".levels");
+}
+
+/** Start a new levels file to go with the peakfile that is about to be written */
+void
+AudioSource::prepare_peak_levels ()
+{
+	Glib::Threads::Mutex::Lock ll (_peak_levels_lock);
+
+	if (_peak_levels_fd >= 0) {
+		return;
+	}
+
+	_peak_levels_next = 0;
+	_peak_levels_frames = 0;
+	_peak_levels_broken = false;
+
+	if ((_peak_levels_fd = g_open (peak_levels_path ().c_str(), O_CREAT|O_RDWR|O_TRUNC, 0664)) < 0 ||
+	    !write_peak_levels_header (_peak_levels_fd, 0)) {
+		/* not fatal, reads will just use the peakfile */
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("cannot write peak levels %1 (%2)\n", peak_levels_path (), strerror (errno)));
+		_peak_levels_broken = true;
+	}
+}
+
+/** Fold @param npeaks peakfile peaks, the first of which is peak number
+ *  @param first_peak, into the levels file.
+ */
+void
+AudioSource::write_peak_levels (framecnt_t first_peak, PeakData const * peaks, framecnt_t npeaks)
+{
+	Glib::Threads::Mutex::Lock ll (_peak_levels_lock);
+
+	if (_peak_levels_fd < 0 || _peak_levels_broken) {
+		return;
+	}
+
+	if (first_peak != _peak_levels_next) {
+		/* not a continuation of what we have (e.g. a destructive
+		 * overwrite). Give up; the levels will be rebuilt from the
+		 * peakfile when they are next needed.
+		 */
+		_peak_levels_broken = true;
+		return;
+	}
+
+	framecnt_t k = first_peak;
+	framecnt_t block = k / peaks_per_block;
+
+	for (framecnt_t n = 0; n < npeaks; ++n, ++k) {
+		if (k / peaks_per_block != block) {
+			if (!write_at (_peak_levels_fd, _peak_levels_block, sizeof (_peak_levels_block), block_offset (block))) {
+				_peak_levels_broken = true;
+				return;
+			}
+			block = k / peaks_per_block;
+		}
+		add_to_block (_peak_levels_block, peaks[n], k % peaks_per_block);
+	}
+
+	/* write the block we are in the middle of too, so that readers see all the data so far */
+
+	if (!write_at (_peak_levels_fd, _peak_levels_block, sizeof (_peak_levels_block), block_offset (block))) {
+		_peak_levels_broken = true;
+		return;
+	}
+
+	_peak_levels_next = k;
+	_peak_levels_frames = _peak_levels_next * _FPP;
+}
+
+/** Finish writing the levels file. If @param done is false, or anything
+ *  went wrong, it is removed.
+ */
+void
+AudioSource::done_with_peak_levels (bool done)
+{
+	Glib::Threads::Mutex::Lock ll (_peak_levels_lock);
+
+	bool ok = false;
+
+	if (_peak_levels_fd >= 0) {
+		ok = done && !_peak_levels_broken && write_peak_levels_header (_peak_levels_fd, _peak_levels_next * _FPP);
+		close (_peak_levels_fd);
+		_peak_levels_fd = -1;
+	}
+
+	if (ok) {
+		_peak_levels_frames = _peak_levels_next * _FPP;
+	} else {
+		::g_unlink (peak_levels_path ().c_str());
+		_peak_levels_frames = -1;
+	}
+}
+
+/** Make sure that the levels file is up to date with the peakfile,
+ *  building it if necessary. Must not be called with _lock held.
+ *  @return number of source frames the levels cover.
+ */
+framecnt_t
+AudioSource::ensure_peak_levels () const
+{
+	bool    peaks_built;
+	off_t   peak_byte_max;
+
+	{
+		/* _lock is taken before _peak_levels_lock elsewhere, so not here */
+		Glib::Threads::Mutex::Lock lm (_lock);
+		peaks_built = _peaks_built;
+		peak_byte_max = _peak_byte_max;
+	}
+
+	Glib::Threads::Mutex::Lock ll (_peak_levels_lock);
+
+	if (_peak_levels_fd >= 0) {
+		/* being written right now */
+		return _peak_levels_broken ? 0 : _peak_levels_frames;
+	}
+
+	if (_peak_levels_frames >= 0) {
+		return _peak_levels_frames;
+	}
+
+	if (!peaks_built || peak_byte_max == 0) {
+		return 0;
+	}
+
+	string const path = peak_levels_path ();
+	framecnt_t const npeaks = peak_byte_max / sizeof (PeakData);
+	framecnt_t const frames = npeaks * _FPP;
+	GStatBuf peak_stat;
+	GStatBuf levels_stat;
+
+	if (g_stat (_peakpath.c_str(), &peak_stat) == 0 && g_stat (path.c_str(), &levels_stat) == 0 && levels_stat.st_mtime >= peak_stat.st_mtime) {
+
+		ScopedFileDescriptor fd (g_open (path.c_str(), O_RDONLY, 0444));
+		PeakLevelsHeader h;
+
+		if (fd >= 0 && ::read (fd, &h, sizeof (h)) == sizeof (h) &&
+		    memcmp (h.magic, peak_levels_magic, sizeof (h.magic)) == 0 &&
+		    h.version == peak_levels_version &&
+		    h.frames == frames) {
+			_peak_levels_frames = frames;
+			return frames;
+		}
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Building peak levels %1 from %2\n", path, _peakpath));
+
+	if (build_peak_levels (npeaks)) {
+		/* don't try again; reads will use the peakfile */
+		_peak_levels_frames = 0;
+	}
+
+	return _peak_levels_frames;
+}
+
+/** Build the levels file from the first @param npeaks peaks of the peakfile.
+ *  _peak_levels_lock must be held.
+ */
+int
+AudioSource::build_peak_levels (framecnt_t npeaks) const
+{
+	string const path = peak_levels_path ();
+	framecnt_t const blocks_per_read = 256;
+
+	ScopedFileDescriptor in (g_open (_peakpath.c_str(), O_RDONLY, 0444));
+	ScopedFileDescriptor out (g_open (path.c_str(), O_CREAT|O_RDWR|O_TRUNC, 0664));
+
+	if (in < 0 || out < 0) {
+		return -1;
+	}
+
+	boost::scoped_array<PeakData> base (new PeakData[blocks_per_read * peaks_per_block]);
+	boost::scoped_array<PeakData> blocks (new PeakData[blocks_per_read * block_size]());
+	framecnt_t done = 0;
+	bool ok = true;
+
+	while (ok && done < npeaks) {
+
+		framecnt_t const n = min (blocks_per_read * peaks_per_block, npeaks - done);
+		ssize_t const bytes = n * sizeof (PeakData);
+
+		if (::read (in, base.get(), bytes) != bytes) {
+			ok = false;
+			break;
+		}
+
+		for (framecnt_t k = 0; k < n; ++k) {
+			add_to_block (&blocks[(k / peaks_per_block) * block_size], base[k], k % peaks_per_block);
+		}
+
+		framecnt_t const nblocks = (n + peaks_per_block - 1) / peaks_per_block;
+
+		ok = write_at (out, blocks.get(), nblocks * block_size * sizeof (PeakData), block_offset (done / peaks_per_block));
+		done += n;
+	}
+
+	if (!ok || !write_peak_levels_header (out, npeaks * _FPP)) {
+		::g_unlink (path.c_str());
+		return -1;
+	}
+
+	_peak_levels_frames = npeaks * _FPP;
+	return 0;
+}
+
+/** Read @param npeaks peaks of level @param level (1 or 2), starting with
+ *  peak number @param first_peak of that level, into @param dst.
+ */
+int
+AudioSource::read_peak_level (uint32_t level, framecnt_t first_peak, framecnt_t npeaks, PeakData* dst) const
+{
+	framecnt_t const per_block = (level == 1) ? 16 : 1;
+	framecnt_t const first_block = first_peak / per_block;
+	framecnt_t const nblocks = (first_peak + npeaks - 1) / per_block - first_block + 1;
+	ssize_t const bytes = nblocks * block_size * sizeof (PeakData);
+
+	ScopedFileDescriptor fd (g_open (peak_levels_path ().c_str(), O_RDONLY, 0444));
+	boost::scoped_array<PeakData> blocks (new PeakData[nblocks * block_size]);
+
+	if (fd < 0 || lseek (fd, block_offset (first_block), SEEK_SET) != block_offset (first_block) || ::read (fd, blocks.get(), bytes) != bytes) {
+		error << string_compose (_("Cannot read peak levels @ %1 (%2)"), peak_levels_path (), strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	for (framecnt_t n = 0; n < npeaks; ++n) {
+		framecnt_t const p = first_peak + n;
+		PeakData const * b = &blocks[(p / per_block - first_block) * block_size];
+		dst[n] = (level == 1) ? b[p % 16] : b[16];
+	}
+
+	return 0;
+}
+
 framecnt_t
 AudioSource::available_peaks (double zoom_factor) const
 {
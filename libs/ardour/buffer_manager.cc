@@ -30,6 +30,7 @@ using namespace PBD;
 RingBufferNPT<ThreadBuffers*>* BufferManager::thread_buffers = 0;
 std::list<ThreadBuffers*>* BufferManager::thread_buffers_list = 0;
 Glib::Threads::Mutex BufferManager::rb_mutex;
+Glib::Threads::Mutex BufferManager::ensure_mutex;
 
 using std::cerr;
 using std::endl;
@@ -74,10 +75,24 @@ BufferManager::put_thread_buffers (ThreadBuffers* tbp)
 	// cerr << "Put back thread buffers, readable count now " << thread_buffers->read_space() << endl;
 }
 
+/** Move the memory of @param tbp, which the caller has taken with
+ *  get_thread_buffers(), to the NUMA node that the calling thread runs on.
+ */
+void
+BufferManager::localize_thread_buffers (ThreadBuffers* tbp)
+{
+	/* a process thread calls this as it starts, so we cannot rely on
+	 * the process lock to keep ensure_buffers() away.
+	 */
+	Glib::Threads::Mutex::Lock em (ensure_mutex);
+	tbp->reallocate ();
+}
+
 void
 BufferManager::ensure_buffers (ChanCount howmany, size_t custom)
 {
         /* this is protected by the audioengine's process lock: we do not  */
+	Glib::Threads::Mutex::Lock em (ensure_mutex);
 
 	for (ThreadBufferList::iterator i = thread_buffers_list->begin(); i != thread_buffers_list->end(); ++i) {
 		(*i)->ensure_buffers (howmany, custom);
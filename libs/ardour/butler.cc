@@ -25,12 +25,23 @@
 #include <poll.h>
 #endif
 
+#include <algorithm>
+
+#include <glibmm/miscutils.h>
+
 #include "pbd/error.h"
+#include "pbd/gstdio_compat.h"
 #include "pbd/pthread_utils.h"
 #include "ardour/debug.h"
+#include "ardour/async_reader.h"
+#include "ardour/audio_diskstream.h"
+#include "ardour/audio_track.h"
+#include "ardour/audiofilesource.h"
 #include "ardour/butler.h"
 #include "ardour/io.h"
 #include "ardour/midi_diskstream.h"
+#include "ardour/playlist.h"
+#include "ardour/region.h"
 #include "ardour/session.h"
 #include "ardour/track.h"
 #include "ardour/auditioner.h"
@@ -50,6 +61,12 @@ Butler::Butler(Session& s)
 	, midi_dstream_buffer_size(0)
 	, pool_trash(16)
 	, _xthread (true)
+	, _io_refill (false)
+	, _io_quit (false)
+	, _io_pending (0)
+	, _io_errors (0)
+	, _io_outstanding (false)
+	, _prefetcher (0)
 {
 	g_atomic_int_set(&should_do_transport_work, 0);
 	SessionEvent::pool->set_trash (&pool_trash);
@@ -120,6 +137,16 @@ Butler::start_thread()
 
 	MidiDiskstream::set_readahead_frames ((framecnt_t) (Config->get_midi_readahead() * rate));
 
+	if (Config->get_butler_async_read () && !_prefetcher) {
+		_prefetcher = new AsyncReader;
+		if (!_prefetcher->usable ()) {
+			delete _prefetcher;
+			_prefetcher = 0;
+		} else {
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("butler prefetches using %1\n", _prefetcher->backend ()));
+		}
+	}
+
 	should_run = false;
 
 	if (pthread_create_and_store ("disk butler", &thread, _thread_work, this)) {
@@ -130,6 +157,8 @@ Butler::start_thread()
 	//pthread_detach (thread);
 	have_thread = true;
 
+	start_io_threads (Config->get_butler_io_threads ());
+
 	// we are ready to request buffer adjustments
 	_session.adjust_capture_buffering ();
 	_session.adjust_playback_buffering ();
@@ -146,6 +175,11 @@ Butler::terminate_thread ()
 		queue_request (Request::Quit);
 		pthread_join (thread, &status);
 	}
+
+	stop_io_threads ();
+
+	delete _prefetcher;
+	_prefetcher = 0;
 }
 
 void *
@@ -224,7 +258,20 @@ Butler::thread_work ()
 		RouteList rl_with_auditioner = *rl;
 		rl_with_auditioner.push_back (_session.the_auditioner());
 
-		for (i = rl_with_auditioner.begin(); !transport_work_requested() && should_run && i != rl_with_auditioner.end(); ++i) {
+		if (_prefetcher && !transport_work_requested() && should_run) {
+			queue_prefetch (rl_with_auditioner);
+		}
+
+		if (!_io_threads.empty ()) {
+			if (!transport_work_requested() && should_run) {
+				disk_work_outstanding = run_io_pass (rl_with_auditioner, true, err);
+			}
+			i = rl_with_auditioner.end ();
+		} else {
+			i = rl_with_auditioner.begin ();
+		}
+
+		for (; !transport_work_requested() && should_run && i != rl_with_auditioner.end(); ++i) {
 
 			boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
 
@@ -265,6 +312,10 @@ Butler::thread_work ()
 
 		if (!err && transport_work_requested()) {
 			DEBUG_TRACE (DEBUG::Butler, "transport work requested during refill, back to restart\n");
+			if (_prefetcher) {
+				/* after a locate, what it is still reading is of no use */
+				_prefetcher->cancel ();
+			}
 			goto restart;
 		}
 
@@ -312,6 +363,13 @@ Butler::flush_tracks_to_disk_normal (boost::shared_ptr<RouteList> rl, uint32_t&
 {
 	bool disk_work_outstanding = false;
 
+	if (!_io_threads.empty ()) {
+		if (!transport_work_requested() && should_run) {
+			disk_work_outstanding = run_io_pass (*rl, false, errors);
+		}
+		return disk_work_outstanding;
+	}
+
 	for (RouteList::iterator i = rl->begin(); !transport_work_requested() && should_run && i != rl->end(); ++i) {
 
 		// cerr << "write behind for " << (*i)->name () << endl;
@@ -488,6 +546,349 @@ Butler::empty_pool_trash ()
 	}
 }
 
+/** Start background reads of what the refills for @param rl are going to
+ *  read, for all tracks at once, so that the kernel can schedule them together
+ *  and the refills (mostly) find their data in the page cache.
+ */
+void
+Butler::queue_prefetch (RouteList const & rl)
+{
+	/* collect the last pass's reads; they are normally long done, since
+	 * the refills read the same data, and we never wait for them.
+	 */
+	_prefetcher->reap ();
+
+	for (RouteList::const_iterator i = rl.begin(); i != rl.end(); ++i) {
+
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+
+		if (!tr) {
+			continue;
+		}
+
+		boost::shared_ptr<IO> io = tr->input ();
+
+		if (io && !io->active()) {
+			continue;
+		}
+
+		tr->prefetch (*_prefetcher);
+	}
+
+	size_t const n = _prefetcher->submit ();
+
+	DEBUG_TRACE (DEBUG::Butler, string_compose ("butler started %1 prefetch reads\n", n));
+}
+
+void
+Butler::start_io_threads (uint32_t n)
+{
+	/* a single I/O thread would just serialize everything again */
+	if (n < 2) {
+		return;
+	}
+
+	_io_quit = false;
+
+	for (uint32_t i = 0; i < n; ++i) {
+		pthread_t t;
+		if (pthread_create_and_store ("butler io", &t, _io_thread_work, this)) {
+			error << _("Session: could not create butler I/O thread") << endmsg;
+			break;
+		}
+		_io_threads.push_back (t);
+	}
+
+	DEBUG_TRACE (DEBUG::Butler, string_compose ("started %1 butler I/O threads\n", _io_threads.size()));
+}
+
+void
+Butler::stop_io_threads ()
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_io_lock);
+		_io_quit = true;
+		_io_work.broadcast ();
+	}
+
+	for (std::vector<pthread_t>::iterator t = _io_threads.begin(); t != _io_threads.end(); ++t) {
+		void* status;
+		pthread_join (*t, &status);
+	}
+
+	_io_threads.clear ();
+	_io_queues.clear ();
+	_io_queue_index.clear ();
+}
+
+void*
+Butler::_io_thread_work (void* arg)
+{
+	pthread_set_name (X_("butler io"));
+	((Butler *) arg)->io_thread_work ();
+	return 0;
+}
+
+/** Main loop of one butler I/O thread */
+void
+Butler::io_thread_work ()
+{
+	/* our own working buffers, sized as in AudioDiskstream::_do_refill_with_alloc() */
+	Sample* mixdown_buffer = new Sample[2*1048576];
+	float*  gain_buffer    = new float[2*1048576];
+
+	Glib::Threads::Mutex::Lock lm (_io_lock);
+
+	while (!_io_quit) {
+
+		IOQueue* q = next_io_queue ();
+
+		if (!q) {
+			_io_work.wait (_io_lock);
+			continue;
+		}
+
+		boost::shared_ptr<Track> tr = q->jobs[q->next++].track;
+		const bool refill = _io_refill;
+		/* give up on the rest of this pass if the butler has more important things to do */
+		const bool skip = transport_work_requested() || !should_run;
+		int ret = 0;
+
+		++q->busy;
+		lm.release ();
+
+		if (!skip) {
+			if (refill) {
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("butler I/O thread refills %1, playback load = %2\n", tr->name(), tr->playback_buffer_load()));
+				ret = tr->do_refill_with_buffers (mixdown_buffer, gain_buffer);
+			} else {
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("butler I/O thread flushes %1, capture load = %2\n", tr->name(), tr->capture_buffer_load()));
+				ret = tr->do_flush (ButlerContext, false);
+			}
+		}
+
+		lm.acquire ();
+		--q->busy;
+
+		if (skip || ret == 1) {
+			_io_outstanding = true;
+		} else if (ret != 0) {
+			++_io_errors;
+			_io_failures.push_back (tr->name ());
+		}
+
+		if (--_io_pending == 0) {
+			_io_done.signal ();
+		}
+	}
+
+	lm.release ();
+
+	delete [] mixdown_buffer;
+	delete [] gain_buffer;
+}
+
+/** Called with _io_lock held.
+ *  @return the queue an idle I/O thread should take its next job from, or 0 if there is no work.
+ */
+Butler::IOQueue*
+Butler::next_io_queue ()
+{
+	IOQueue* best = 0;
+
+	for (std::vector<IOQueue>::iterator q = _io_queues.begin(); q != _io_queues.end(); ++q) {
+
+		if (q->next >= q->jobs.size()) {
+			continue;
+		}
+
+		/* prefer the device with the fewest threads on it, then the most urgent job */
+		if (!best || q->busy < best->busy ||
+		    (q->busy == best->busy && q->jobs[q->next].urgency < best->jobs[best->next].urgency)) {
+			best = &(*q);
+		}
+	}
+
+	return best;
+}
+
+/** Refill (or flush) all tracks in @param rl using the I/O threads, and wait until they are done.
+ *  @return true if there is still disk work outstanding.
+ */
+bool
+Butler::run_io_pass (RouteList const & rl, bool refill, uint32_t& errors)
+{
+	/* work out where each track's data lives before taking _io_lock,
+	 * since that may have to wait for the filesystem.
+	 */
+	_io_new_jobs.clear ();
+
+	for (RouteList::const_iterator i = rl.begin(); i != rl.end(); ++i) {
+
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+
+		if (!tr) {
+			continue;
+		}
+
+		if (refill) {
+			boost::shared_ptr<IO> io = tr->input ();
+
+			if (io && !io->active()) {
+				/* don't read inactive tracks */
+				continue;
+			}
+
+			/* the emptier the playback buffer, the sooner it needs a refill */
+			_io_new_jobs.push_back (std::make_pair (device_of (tr), IOJob (tr, tr->playback_buffer_load ())));
+
+		} else {
+			/* note that we still try to flush diskstreams attached to inactive routes;
+			 * the fuller the capture buffer, the sooner it needs a flush.
+			 */
+			_io_new_jobs.push_back (std::make_pair (device_of (tr), IOJob (tr, 1.0 - tr->capture_buffer_load ())));
+		}
+	}
+
+	const uint32_t njobs = _io_new_jobs.size ();
+
+	if (njobs == 0) {
+		return false;
+	}
+
+	Glib::Threads::Mutex::Lock lm (_io_lock);
+
+	for (std::vector<std::pair<dev_t, IOJob> >::const_iterator j = _io_new_jobs.begin(); j != _io_new_jobs.end(); ++j) {
+		_io_queues[io_queue_for (j->first)].jobs.push_back (j->second);
+	}
+
+	_io_new_jobs.clear ();
+
+	for (std::vector<IOQueue>::iterator q = _io_queues.begin(); q != _io_queues.end(); ++q) {
+		std::sort (q->jobs.begin(), q->jobs.end());
+		q->next = 0;
+	}
+
+	_io_refill = refill;
+	_io_pending = njobs;
+	_io_errors = 0;
+	_io_outstanding = false;
+	_io_failures.clear ();
+
+	DEBUG_TRACE (DEBUG::Butler, string_compose ("butler hands %1 %2 jobs to I/O threads on %3 devices\n", njobs, (refill ? "refill" : "flush"), _io_queues.size()));
+
+	_io_work.broadcast ();
+
+	while (_io_pending) {
+		_io_done.wait (_io_lock);
+	}
+
+	for (std::vector<std::string>::const_iterator f = _io_failures.begin(); f != _io_failures.end(); ++f) {
+		if (refill) {
+			error << string_compose(_("Butler read ahead failure on dstream %1"), *f) << endmsg;
+		} else {
+			error << string_compose(_("Butler write-behind failure on dstream %1"), *f) << endmsg;
+		}
+	}
+
+	/* only the butler counts write errors, as in flush_tracks_to_disk_normal() */
+	if (!refill) {
+		errors += _io_errors;
+	}
+
+	for (std::vector<IOQueue>::iterator q = _io_queues.begin(); q != _io_queues.end(); ++q) {
+		q->jobs.clear ();
+	}
+
+	return _io_outstanding;
+}
+
+/** @return the device holding @param tr's data.
+ *
+ *  This is the directory of the track's current capture file if it has one,
+ *  otherwise that of the first source in its playlist. Tracks that use several
+ *  devices at once are assigned to one of them; that only affects ordering.
+ */
+dev_t
+Butler::device_of (boost::shared_ptr<Track> tr)
+{
+	std::string path;
+	boost::shared_ptr<AudioTrack> at = boost::dynamic_pointer_cast<AudioTrack> (tr);
+
+	if (at) {
+		boost::shared_ptr<AudioFileSource> ws = at->audio_diskstream()->write_source ();
+		if (ws) {
+			path = ws->path ();
+		}
+	}
+
+	if (path.empty()) {
+		boost::shared_ptr<Playlist> pl = tr->playlist ();
+		boost::shared_ptr<Region> r;
+		if (pl && (r = pl->first_region ())) {
+			boost::shared_ptr<FileSource> fs = boost::dynamic_pointer_cast<FileSource> (r->source (0));
+			if (fs) {
+				path = fs->path ();
+			}
+		}
+	}
+
+	return path.empty() ? 0 : device_of (Glib::path_get_dirname (path));
+}
+
+/** Called with _io_lock held.
+ *  @return index of the I/O queue for @param dev.
+ */
+size_t
+Butler::io_queue_for (dev_t dev)
+{
+	std::map<dev_t, size_t>::const_iterator i = _io_queue_index.find (dev);
+
+	if (i != _io_queue_index.end()) {
+		return i->second;
+	}
+
+	_io_queues.push_back (IOQueue ());
+	_io_queue_index.insert (std::make_pair (dev, _io_queues.size() - 1));
+
+	return _io_queues.size() - 1;
+}
+
+dev_t
+Butler::device_of (std::string const & dir)
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_device_cache_lock);
+		std::map<std::string, dev_t>::const_iterator i = _device_cache.find (dir);
+
+		if (i != _device_cache.end()) {
+			return i->second;
+		}
+	}
+
+	GStatBuf sbuf;
+	dev_t dev = 0;
+
+	if (g_stat (dir.c_str(), &sbuf) == 0) {
+		dev = sbuf.st_dev;
+	}
+
+	Glib::Threads::Mutex::Lock lm (_device_cache_lock);
+	_device_cache.insert (std::make_pair (dir, dev));
+
+	return dev;
+}
+
+/** Forget which device each directory is on; called when the session
+ *  moves or its search paths change.
+ */
+void
+Butler::clear_device_cache ()
+{
+	Glib::Threads::Mutex::Lock lm (_device_cache_lock);
+	_device_cache.clear ();
+}
+
 void
 Butler::drop_references ()
 {
@@ -20,6 +20,7 @@
 
 #include "ardour/export_graph_builder.h"
 
+#include <algorithm>
 #include <vector>
 
 #include <glibmm/miscutils.h>
@@ -56,9 +57,10 @@ using std::string;
 
 namespace ARDOUR {
 
-ExportGraphBuilder::ExportGraphBuilder (Session const & session)
+ExportGraphBuilder::ExportGraphBuilder (Session const & session, AudioGrapher::ThreadPool & thread_pool)
 	: session (session)
-	, thread_pool (hardware_concurrency())
+	, _analysis_only (false)
+	, thread_pool (thread_pool)
 {
 	process_buffer_frames = session.engine().samples_per_cycle();
 }
@@ -67,15 +69,19 @@ ExportGraphBuilder::~ExportGraphBuilder ()
 {
 }
 
+/** @param frames Number of frames to export.
+ *  @param last_cycle true if these are the last frames of the timespan.
+ *  @param offset Position of the first frame to export in this cycle's buffers.
+ */
 int
-ExportGraphBuilder::process (framecnt_t frames, bool last_cycle)
+ExportGraphBuilder::process (framecnt_t frames, bool last_cycle, framecnt_t offset)
 {
-	assert(frames <= process_buffer_frames);
+	assert(offset + frames <= process_buffer_frames);
 
 	for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it) {
 		Sample const * process_buffer = 0;
-		it->first->read (process_buffer, frames);
-		ConstProcessContext<Sample> context(process_buffer, frames, 1);
+		it->first->read (process_buffer, offset + frames);
+		ConstProcessContext<Sample> context(process_buffer + offset, frames, 1);
 		if (last_cycle) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
 		it->second->process (context);
 	}
@@ -114,8 +120,11 @@ ExportGraphBuilder::reset ()
 	channel_configs.clear ();
 	channels.clear ();
 	intermediates.clear ();
+	all_intermediates.clear ();
+	normalization_peaks.clear ();
 	analysis_map.clear();
 	_realtime = false;
+	_analysis_only = false;
 }
 
 void
@@ -191,6 +200,18 @@ ExportGraphBuilder::get_analysis_results (AnalysisResults& results) {
 	}
 }
 
+void
+ExportGraphBuilder::get_normalization_peaks (std::vector<float>& peaks)
+{
+	peaks.clear ();
+	if (!_analysis_only) {
+		return;
+	}
+	for (std::vector<Intermediate *>::iterator i = all_intermediates.begin(); i != all_intermediates.end(); ++i) {
+		peaks.push_back ((*i)->measured_peak ());
+	}
+}
+
 void
 ExportGraphBuilder::add_split_config (FileSpec const & config)
 {
@@ -411,25 +432,61 @@ ExportGraphBuilder::SFC::operator== (FileSpec const & other_config) const
 	return config.format->sample_format() == other_config.format->sample_format();
 }
 
-/* Intermediate (Normalizer, TmpFile) */
+/* Intermediate (Normalizer, TmpFile)
+ *
+ * Without an analysis pass, the signal is measured while it is written to
+ * a temporary file, which is then read back through the normalizer in
+ * post-processing. With one, the analysis-only graph just measures, and
+ * the export proper normalizes by the known peak as it goes.
+ */
 
 ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, FileSpec const & new_config, framecnt_t max_frames)
 	: parent (parent)
 	, use_loudness (false)
 	, use_peak (false)
+	, analysis_only (parent._analysis_only)
+	, streaming (false)
+	, gain (1.0)
 {
-	std::string tmpfile_path = parent.session.session_directory().export_path();
-	tmpfile_path = Glib::build_filename(tmpfile_path, "XXXXXX");
-	std::vector<char> tmpfile_path_buf(tmpfile_path.size() + 1);
-	std::copy(tmpfile_path.begin(), tmpfile_path.end(), tmpfile_path_buf.begin());
-	tmpfile_path_buf[tmpfile_path.size()] = '\0';
-
 	config = new_config;
 	uint32_t const channels = config.channel_config->get_n_chans();
 	max_frames_out = 4086 - (4086 % channels); // TODO good chunk size
 	use_loudness = config.format->normalize_loudness ();
 	use_peak = config.format->normalize ();
 
+	size_t const index = parent.all_intermediates.size ();
+	parent.all_intermediates.push_back (this);
+
+	if (analysis_only) {
+		if (use_peak) {
+			peak_reader.reset (new PeakReader ());
+		}
+		if (use_loudness) {
+			loudness_reader.reset (new LoudnessReader (config.format->sample_rate(), channels, max_frames));
+		}
+		return;
+	}
+
+	if (!parent._realtime && index < parent.normalization_peaks.size ()) {
+		streaming = true;
+		max_frames_out = max_frames;
+
+		normalizer.reset (new AudioGrapher::Normalizer (use_loudness ? 0.0 : config.format->normalize_dbfs()));
+		threader.reset (new Threader<Sample> (parent.thread_pool));
+		normalizer->alloc_buffer (max_frames_out);
+		normalizer->add_output (threader);
+		gain = normalizer->set_peak (parent.normalization_peaks[index]);
+
+		add_child (new_config);
+		return;
+	}
+
+	std::string tmpfile_path = parent.session.session_directory().export_path();
+	tmpfile_path = Glib::build_filename(tmpfile_path, "XXXXXX");
+	std::vector<char> tmpfile_path_buf(tmpfile_path.size() + 1);
+	std::copy(tmpfile_path.begin(), tmpfile_path.end(), tmpfile_path_buf.begin());
+	tmpfile_path_buf[tmpfile_path.size()] = '\0';
+
 	buffer.reset (new AllocatingProcessContext<Sample> (max_frames_out, channels));
 
 	if (use_peak) {
@@ -469,7 +526,9 @@ ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, Fil
 ExportGraphBuilder::FloatSinkPtr
 ExportGraphBuilder::Intermediate::sink ()
 {
-	if (use_loudness) {
+	if (streaming) {
+		return normalizer;
+	} else if (use_loudness) {
 		return loudness_reader;
 	} else if (use_peak) {
 		return peak_reader;
@@ -489,6 +548,10 @@ ExportGraphBuilder::Intermediate::add_child (FileSpec const & new_config)
 
 	children.push_back (new SFC (parent, new_config, max_frames_out));
 	threader->add_output (children.back().sink());
+
+	if (streaming && (use_loudness || use_peak)) {
+		children.back().set_peak (gain);
+	}
 }
 
 void
@@ -529,18 +592,22 @@ ExportGraphBuilder::Intermediate::process()
 	return frames_read != buffer->frames();
 }
 
-void
-ExportGraphBuilder::Intermediate::prepare_post_processing()
+float
+ExportGraphBuilder::Intermediate::measured_peak ()
 {
-	// called in sync rt-context
-	float gain;
 	if (use_loudness) {
-		gain = normalizer->set_peak (loudness_reader->get_peak (config.format->normalize_lufs (), config.format->normalize_dbtp ()));
+		return loudness_reader->get_peak (config.format->normalize_lufs (), config.format->normalize_dbtp ());
 	} else if (use_peak) {
-		gain = normalizer->set_peak (peak_reader->get_peak());
-	} else {
-		gain = normalizer->set_peak (0.0);
+		return peak_reader->get_peak();
 	}
+	return 0.0;
+}
+
+void
+ExportGraphBuilder::Intermediate::prepare_post_processing()
+{
+	// called in sync rt-context
+	gain = normalizer->set_peak (measured_peak ());
 	if (use_loudness || use_peak) {
 		// push info to analyzers
 		for (boost::ptr_list<SFC>::iterator i = children.begin(); i != children.end(); ++i) {
@@ -584,6 +651,14 @@ ExportGraphBuilder::SRC::sink ()
 void
 ExportGraphBuilder::SRC::add_child (FileSpec const & new_config)
 {
+	if (parent._analysis_only) {
+		/* nothing is written, only what is normalized needs measuring */
+		if (new_config.format->normalize()) {
+			add_child_to_list (new_config, intermediate_children);
+		}
+		return;
+	}
+
 	if (new_config.format->normalize() || parent._realtime) {
 		add_child_to_list (new_config, intermediate_children);
 	} else {
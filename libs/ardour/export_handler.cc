@@ -20,11 +20,16 @@
 
 #include "ardour/export_handler.h"
 
+#include <algorithm>
+
 #include "pbd/gstdio_compat.h"
 #include <glibmm.h>
 #include <glibmm/convert.h>
 
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
+
+#include "audiographer/general/thread_pool.h"
 
 #include "ardour/audioengine.h"
 #include "ardour/audiofile_tagger.h"
@@ -36,6 +41,7 @@
 #include "ardour/export_status.h"
 #include "ardour/export_format_specification.h"
 #include "ardour/export_filename.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/soundcloud_upload.h"
 #include "ardour/system_exec.h"
 #include "pbd/openuri.h"
@@ -110,9 +116,11 @@ ExportElementFactory::add_filename_copy (ExportFilenamePtr other)
 ExportHandler::ExportHandler (Session & session)
   : ExportElementFactory (session)
   , session (session)
-  , graph_builder (new ExportGraphBuilder (session))
   , export_status (session.get_export_status ())
   , post_processing (false)
+  , analysis_pass (false)
+  , process_position (0)
+  , pass_end (0)
   , cue_tracknum (0)
   , cue_indexnum (0)
 {
@@ -120,7 +128,9 @@ ExportHandler::ExportHandler (Session & session)
 
 ExportHandler::~ExportHandler ()
 {
-	graph_builder->cleanup (export_status->aborted () );
+	for (std::vector<GraphBuilderPtr>::iterator i = graph_builders.begin(); i != graph_builders.end(); ++i) {
+		(*i)->cleanup (export_status->aborted () );
+	}
 }
 
 /** Add an export to the `to-do' list */
@@ -164,92 +174,256 @@ ExportHandler::do_export ()
 	start_timespan ();
 }
 
+/** A timespan can be chained with others if it is exported faster than
+ *  realtime from ports or routes: region exports read the region at the
+ *  session's position and realtime exports are encoded while running.
+ */
+bool
+ExportHandler::can_chain (ExportTimespanPtr timespan) const
+{
+	if (timespan->realtime ()) {
+		return false;
+	}
+
+	std::pair<ConfigMap::const_iterator, ConfigMap::const_iterator> bounds = config_map.equal_range (timespan);
+	for (ConfigMap::const_iterator it = bounds.first; it != bounds.second; ++it) {
+		if (it->second.channel_config->region_processing_type () != RegionExportChannelFactory::None) {
+			return false;
+		}
+	}
+	return true;
+}
+
+struct TimespanSortByStart {
+	bool operator() (ExportTimespanPtr const & a, ExportTimespanPtr const & b) const {
+		return a->get_start() < b->get_start();
+	}
+};
+
+/** Pick the timespans to export in the next pass over the session.
+ *
+ *  Starting at the earliest timespan that is left, later timespans are
+ *  chained on as long as they do not overlap the previous one and the gap
+ *  to it is no longer than the export pre-roll; rolling through such a gap
+ *  costs no more than locating there and pre-rolling again. The timespans
+ *  of a pass are rendered sequentially, as the transport reaches them.
+ */
 void
-ExportHandler::start_timespan ()
+ExportHandler::plan_pass (std::vector<ExportTimespanPtr> & timespans) const
 {
-	export_status->timespan++;
+	timespans.clear ();
+
+	if (!Config->get_export_chain_timespans () || !can_chain (config_map.begin()->first)) {
+		timespans.push_back (config_map.begin()->first);
+		return;
+	}
+
+	std::vector<ExportTimespanPtr> candidates;
+	for (ConfigMap::const_iterator it = config_map.begin(); it != config_map.end(); it = config_map.upper_bound (it->first)) {
+		if (can_chain (it->first)) {
+			candidates.push_back (it->first);
+		}
+	}
+
+	std::stable_sort (candidates.begin(), candidates.end(), TimespanSortByStart ());
 
+	const framecnt_t max_gap = Config->get_export_preroll() * session.nominal_frame_rate ();
+
+	for (std::vector<ExportTimespanPtr>::const_iterator i = candidates.begin(); i != candidates.end(); ++i) {
+		if (!timespans.empty()) {
+			framepos_t const end = timespans.back()->get_end();
+			if ((*i)->get_start() < end) {
+				/* overlaps, leave it for a later pass */
+				continue;
+			}
+			if ((*i)->get_start() - end > max_gap) {
+				break;
+			}
+		}
+		timespans.push_back (*i);
+	}
+}
+
+void
+ExportHandler::start_timespan ()
+{
 	if (config_map.empty()) {
+		export_status->timespan++;
 		// freewheeling has to be stopped from outside the process cycle
 		export_status->set_running (false);
 		return;
 	}
 
-	/* finish_timespan pops the config_map entry that has been done, so
-	   this is the timespan to do this time
+	/* finish_timespan pops the config_map entries that have been done, so
+	   the timespans in this pass are chosen from what is left
 	*/
-	current_timespan = config_map.begin()->first;
+	std::vector<ExportTimespanPtr> timespans;
+	plan_pass (timespans);
 
-	export_status->total_frames_current_timespan = current_timespan->get_length();
-	export_status->timespan_name = current_timespan->name();
-	export_status->processed_frames_current_timespan = 0;
+	if (!thread_pool) {
+		/* the thread that runs the export works on each batch as well */
+		thread_pool.reset (new AudioGrapher::ThreadPool (std::max (1u, hardware_concurrency()) - 1));
+	}
+
+	while (graph_builders.size() < timespans.size()) {
+		graph_builders.push_back (GraphBuilderPtr (new ExportGraphBuilder (session, *thread_pool)));
+	}
+
+	pass.clear ();
+	for (size_t n = 0; n < timespans.size(); ++n) {
+		graph_builders[n]->reset ();
+		pass.push_back (PassTimespan (timespans[n], graph_builders[n]));
+	}
+
+	analysis_pass = need_analysis_pass ();
+	start_pass ();
+}
 
-	/* Register file configurations to graph builder */
+/** Normalizing needs to know the peak or loudness of the whole timespan.
+ *  Rather than writing everything to a temporary file and reading it back,
+ *  the session can be run twice: once only to measure, once to export.
+ *  Realtime exports are not run twice, neither are region exports which
+ *  read regions without running the session.
+ *  This is off by default: the two runs only produce the same audio if
+ *  every plugin is deterministic, otherwise the export can exceed the
+ *  measured peak and clip.
+ */
+bool
+ExportHandler::need_analysis_pass () const
+{
+	if (!Config->get_export_analysis_prepass ()) {
+		return false;
+	}
+
+	bool normalize = false;
+	for (Pass::const_iterator p = pass.begin(); p != pass.end(); ++p) {
+		if (p->timespan->realtime ()) {
+			return false;
+		}
+		std::pair<ConfigMap::const_iterator, ConfigMap::const_iterator> bounds = config_map.equal_range (p->timespan);
+		for (ConfigMap::const_iterator it = bounds.first; it != bounds.second; ++it) {
+			if (it->second.channel_config->region_processing_type () != RegionExportChannelFactory::None) {
+				return false;
+			}
+			if (it->second.format->normalize ()) {
+				normalize = true;
+			}
+		}
+	}
+	return normalize;
+}
 
-	/* Here's the config_map entries that use this timespan */
-	timespan_bounds = config_map.equal_range (current_timespan);
-	graph_builder->reset ();
-	graph_builder->set_current_timespan (current_timespan);
-	handle_duplicate_format_extensions();
-	bool realtime = current_timespan->realtime ();
+/** Register file configurations to the pass's graph builders and start
+ *  running the session. This is done a second time after an analysis pass,
+ *  handing what it measured to the builders.
+ */
+void
+ExportHandler::start_pass ()
+{
+	bool realtime = false;
 	bool region_export = true;
 	bool incl_master_bus = false;
-	for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
-		// Filenames can be shared across timespans
-		FileSpec & spec = it->second;
-		spec.filename->set_timespan (it->first);
-		switch (spec.channel_config->region_processing_type ()) {
-			case RegionExportChannelFactory::None:
-			case RegionExportChannelFactory::Processed:
-				region_export = false;
-				break;
-			default:
-				break;
-		}
+
+	for (Pass::iterator p = pass.begin(); p != pass.end(); ++p) {
+		ExportTimespanPtr timespan = p->timespan;
+		GraphBuilderPtr graph_builder = p->builder;
+
+		std::vector<float> peaks;
+		graph_builder->get_normalization_peaks (peaks);
+
+		/* Here's the config_map entries that use this timespan */
+		TimespanBounds timespan_bounds = config_map.equal_range (timespan);
+		graph_builder->reset ();
+		graph_builder->set_current_timespan (timespan);
+		graph_builder->set_analysis_only (analysis_pass);
+		graph_builder->set_normalization_peaks (peaks);
+		handle_duplicate_format_extensions (timespan_bounds);
+		realtime = timespan->realtime ();
+
+		for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
+			/* Filenames can be shared across timespans, but a pass
+			 * sets up all of its timespans before it starts: give each
+			 * of them its own copy, so that the writers and finish_pass_timespan()
+			 * use this timespan's path rather than the last one set.
+			 */
+			FileSpec & spec = it->second;
+			spec.filename.reset (new ExportFilename (*spec.filename));
+			spec.filename->set_timespan (it->first);
+			switch (spec.channel_config->region_processing_type ()) {
+				case RegionExportChannelFactory::None:
+				case RegionExportChannelFactory::Processed:
+					region_export = false;
+					break;
+				default:
+					break;
+			}
 #if 1 // hack alert -- align master bus, compensate master latency
 
-		/* there's no easier way to get this information here.
-		 * Ports are configured in the PortExportChannelSelector GUI,
-		 * This ExportHandler has no context of routes.
-		 */
-		boost::shared_ptr<Route> master_bus = session.master_out ();
-		if (master_bus) {
-			const PortSet& ps = master_bus->output ()->ports();
+			/* there's no easier way to get this information here.
+			 * Ports are configured in the PortExportChannelSelector GUI,
+			 * This ExportHandler has no context of routes.
+			 */
+			boost::shared_ptr<Route> master_bus = session.master_out ();
+			if (master_bus) {
+				const PortSet& ps = master_bus->output ()->ports();
 
-			const ExportChannelConfiguration::ChannelList& channels = spec.channel_config->get_channels ();
-			for (ExportChannelConfiguration::ChannelList::const_iterator it = channels.begin(); it != channels.end(); ++it) {
+				const ExportChannelConfiguration::ChannelList& channels = spec.channel_config->get_channels ();
+				for (ExportChannelConfiguration::ChannelList::const_iterator it = channels.begin(); it != channels.end(); ++it) {
 
-				boost::shared_ptr <PortExportChannel> pep = boost::dynamic_pointer_cast<PortExportChannel> (*it);
-				if (!pep) {
-					continue;
-				}
-				PortExportChannel::PortSet const& ports = pep->get_ports ();
-				for (PortExportChannel::PortSet::const_iterator it = ports.begin(); it != ports.end(); ++it) {
-					boost::shared_ptr<AudioPort> ap = (*it).lock();
-					if (ps.contains (ap)) {
-						incl_master_bus = true;
+					boost::shared_ptr <PortExportChannel> pep = boost::dynamic_pointer_cast<PortExportChannel> (*it);
+					if (!pep) {
+						continue;
+					}
+					PortExportChannel::PortSet const& ports = pep->get_ports ();
+					for (PortExportChannel::PortSet::const_iterator it = ports.begin(); it != ports.end(); ++it) {
+						boost::shared_ptr<AudioPort> ap = (*it).lock();
+						if (ps.contains (ap)) {
+							incl_master_bus = true;
+						}
 					}
 				}
 			}
-		}
 #endif
-		graph_builder->add_config (spec, realtime);
+			graph_builder->add_config (spec, realtime);
+		}
 	}
 
 	// ExportDialog::update_realtime_selection does not allow this
 	assert (!region_export || !realtime);
 
+	process_position = pass.front().timespan->get_start();
+	pass_end = pass.back().timespan->get_end();
+
+	if (analysis_pass) {
+		export_status->active_job = ExportStatus::Normalizing;
+		export_status->total_postprocessing_cycles = (pass_end - process_position) / session.engine().samples_per_cycle() + 1;
+		export_status->current_postprocessing_cycle = 0;
+	} else {
+		begin_pass_timespan (pass.front ());
+	}
+
 	/* start export */
 
 	post_processing = false;
 	session.ProcessExport.connect_same_thread (process_connection, boost::bind (&ExportHandler::process, this, _1));
-	process_position = current_timespan->get_start();
 	// TODO check if it's a RegionExport.. set flag to skip  process_without_events()
 	session.start_audio_export (process_position, realtime, region_export, incl_master_bus);
 }
 
 void
-ExportHandler::handle_duplicate_format_extensions()
+ExportHandler::begin_pass_timespan (PassTimespan & p)
+{
+	p.started = true;
+	current_timespan = p.timespan;
+
+	export_status->timespan++;
+	export_status->total_frames_current_timespan = p.timespan->get_length();
+	export_status->timespan_name = p.timespan->name();
+	export_status->processed_frames_current_timespan = 0;
+}
+
+void
+ExportHandler::handle_duplicate_format_extensions (TimespanBounds const & timespan_bounds)
 {
 	typedef std::map<std::string, int> ExtCountMap;
 
@@ -291,33 +465,67 @@ ExportHandler::process (framecnt_t frames)
 int
 ExportHandler::process_timespan (framecnt_t frames)
 {
-	export_status->active_job = ExportStatus::Exporting;
-	/* update position */
+	export_status->active_job = analysis_pass ? ExportStatus::Normalizing : ExportStatus::Exporting;
 
-	framecnt_t frames_to_read = 0;
-	framepos_t const end = current_timespan->get_end();
+	/* this cycle covers [process_position, cycle_end) of the session */
 
-	bool const last_cycle = (process_position + frames >= end);
+	bool const last_cycle = (process_position + frames >= pass_end);
+	framepos_t const cycle_end = last_cycle ? pass_end : process_position + frames;
 
 	if (last_cycle) {
-		frames_to_read = end - process_position;
 		export_status->stop = true;
-	} else {
-		frames_to_read = frames;
 	}
 
-	process_position += frames_to_read;
-	export_status->processed_frames += frames_to_read;
-	export_status->processed_frames_current_timespan += frames_to_read;
+	int ret = 0;
 
-	/* Do actual processing */
-	int ret = graph_builder->process (frames_to_read, last_cycle);
+	for (Pass::iterator p = pass.begin(); p != pass.end(); ++p) {
+		framepos_t const start = p->timespan->get_start();
+		framepos_t const end = p->timespan->get_end();
+
+		if (end <= process_position || start >= cycle_end) {
+			continue;
+		}
+
+		framecnt_t const offset = std::max (start, process_position) - process_position;
+		framecnt_t const frames_to_read = std::min (end, cycle_end) - process_position - offset;
+
+		if (!analysis_pass) {
+			if (!p->started) {
+				begin_pass_timespan (*p);
+			}
+			export_status->processed_frames += frames_to_read;
+			export_status->processed_frames_current_timespan += frames_to_read;
+		}
+
+		/* Do actual processing */
+		if (p->builder->process (frames_to_read, end <= cycle_end, offset)) {
+			ret = -1;
+		}
+	}
+
+	process_position = cycle_end;
+
+	if (analysis_pass) {
+		export_status->current_postprocessing_cycle++;
+		if (last_cycle) {
+			/* run the same pass again, for real this time */
+			analysis_pass = false;
+			start_pass ();
+		}
+		return ret;
+	}
 
 	/* Start post-processing/normalizing if necessary */
 	if (last_cycle) {
-		post_processing = graph_builder->need_postprocessing ();
+		unsigned cycles = 0;
+		for (Pass::const_iterator p = pass.begin(); p != pass.end(); ++p) {
+			if (p->builder->need_postprocessing ()) {
+				post_processing = true;
+				cycles = std::max (cycles, p->builder->get_postprocessing_cycle_count());
+			}
+		}
 		if (post_processing) {
-			export_status->total_postprocessing_cycles = graph_builder->get_postprocessing_cycle_count();
+			export_status->total_postprocessing_cycles = cycles;
 			export_status->current_postprocessing_cycle = 0;
 		} else {
 			finish_timespan ();
@@ -331,11 +539,18 @@ ExportHandler::process_timespan (framecnt_t frames)
 int
 ExportHandler::post_process ()
 {
-	if (graph_builder->post_process ()) {
+	bool done = true;
+	for (Pass::iterator p = pass.begin(); p != pass.end(); ++p) {
+		if (!p->builder->post_process ()) {
+			done = false;
+		}
+	}
+
+	if (done) {
 		finish_timespan ();
 		export_status->active_job = ExportStatus::Exporting;
 	} else {
-		if (graph_builder->realtime ()) {
+		if (pass.front().builder->realtime ()) {
 			export_status->active_job = ExportStatus::Encoding;
 		} else {
 			export_status->active_job = ExportStatus::Normalizing;
@@ -356,13 +571,27 @@ ExportHandler::command_output(std::string output, size_t size)
 
 void
 ExportHandler::finish_timespan ()
+{
+	for (Pass::iterator p = pass.begin(); p != pass.end(); ++p) {
+		current_timespan = p->timespan;
+		finish_pass_timespan (p->builder);
+	}
+
+	pass.clear ();
+	start_timespan ();
+}
+
+void
+ExportHandler::finish_pass_timespan (GraphBuilderPtr graph_builder)
 {
 	graph_builder->get_analysis_results (export_status->result_map);
 
-	while (config_map.begin() != timespan_bounds.second) {
+	TimespanBounds timespan_bounds = config_map.equal_range (current_timespan);
 
-		ExportFormatSpecPtr fmt = config_map.begin()->second.format;
-		std::string filename = config_map.begin()->second.filename->get_path(fmt);
+	for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ) {
+
+		ExportFormatSpecPtr fmt = it->second.format;
+		std::string filename = it->second.filename->get_path(fmt);
 		if (fmt->with_cue()) {
 			export_cd_marker_file (current_timespan, fmt, filename, CDMarkerCUE);
 		}
@@ -479,10 +708,8 @@ ExportHandler::finish_timespan ()
 			}
 			delete soundcloud_uploader;
 		}
-		config_map.erase (config_map.begin());
+		config_map.erase (it++);
 	}
-
-	start_timespan ();
 }
 
 /*** CD Marker stuff ***/
@@ -137,6 +137,9 @@ apply_gain_to_buffer_t  ARDOUR::apply_gain_to_buffer = 0;
 mix_buffers_with_gain_t ARDOUR::mix_buffers_with_gain = 0;
 mix_buffers_no_gain_t   ARDOUR::mix_buffers_no_gain = 0;
 copy_vector_t			ARDOUR::copy_vector = 0;
+apply_gain_vector_to_buffer_t  ARDOUR::apply_gain_vector_to_buffer = 0;
+mix_buffers_with_gain_vector_t ARDOUR::mix_buffers_with_gain_vector = 0;
+crossfade_buffers_t            ARDOUR::crossfade_buffers = 0;
 
 PBD::Signal1<void,std::string> ARDOUR::BootMessage;
 PBD::Signal3<void,std::string,std::string,bool> ARDOUR::PluginScanMessage;
@@ -168,15 +171,30 @@ setup_hardware_optimization (bool try_optimization)
 
 #if defined (ARCH_X86) && defined (BUILD_SSE_OPTIMIZATIONS)
 
-#ifdef PLATFORM_WINDOWS
-		/* We have AVX-optimized code for Windows */
+#ifdef HAVE_AVX512F
+		/* AVX-512 code is only built on Linux, and only if the compiler supports it */
 
-		if (fpu->has_avx()) {
-#else
-		/* AVX code doesn't compile on Linux yet */
+		if (fpu->has_avx512f()) {
+
+			info << "Using AVX-512 optimized routines" << endmsg;
+
+			compute_peak          = x86_avx512_compute_peak;
+			find_peaks            = x86_avx512_find_peaks;
+			apply_gain_to_buffer  = x86_avx512_apply_gain_to_buffer;
+			mix_buffers_with_gain = x86_avx512_mix_buffers_with_gain;
+			mix_buffers_no_gain   = x86_avx512_mix_buffers_no_gain;
+			copy_vector           = x86_avx512_copy_vector;
 
-		if (false) {
+			apply_gain_vector_to_buffer  = x86_avx512_apply_gain_vector_to_buffer;
+			mix_buffers_with_gain_vector = x86_avx512_mix_buffers_with_gain_vector;
+			crossfade_buffers            = x86_avx512_crossfade_buffers;
+
+			generic_mix_functions = false;
+
+		} else
 #endif
+		if (fpu->has_avx()) {
+
 			info << "Using AVX optimized routines" << endmsg;
 
 			// AVX SET
@@ -187,6 +205,17 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
 
+#ifdef PLATFORM_WINDOWS
+			/* the Windows AVX build has no per-sample gain kernels */
+			apply_gain_vector_to_buffer  = x86_sse_apply_gain_vector_to_buffer;
+			mix_buffers_with_gain_vector = x86_sse_mix_buffers_with_gain_vector;
+			crossfade_buffers            = x86_sse_crossfade_buffers;
+#else
+			apply_gain_vector_to_buffer  = x86_sse_avx_apply_gain_vector_to_buffer;
+			mix_buffers_with_gain_vector = x86_sse_avx_mix_buffers_with_gain_vector;
+			crossfade_buffers            = x86_sse_avx_crossfade_buffers;
+#endif
+
 			generic_mix_functions = false;
 
 		} else if (fpu->has_sse()) {
@@ -201,6 +230,10 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
 
+			apply_gain_vector_to_buffer  = x86_sse_apply_gain_vector_to_buffer;
+			mix_buffers_with_gain_vector = x86_sse_mix_buffers_with_gain_vector;
+			crossfade_buffers            = x86_sse_crossfade_buffers;
+
 			generic_mix_functions = false;
 
 		}
@@ -215,6 +248,10 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain    = veclib_mix_buffers_no_gain;
 			copy_vector            = default_copy_vector;
 
+			apply_gain_vector_to_buffer  = veclib_apply_gain_vector_to_buffer;
+			mix_buffers_with_gain_vector = veclib_mix_buffers_with_gain_vector;
+			crossfade_buffers            = default_crossfade_buffers;
+
 			generic_mix_functions = false;
 
 			info << "Apple VecLib H/W specific optimizations in use" << endmsg;
@@ -235,6 +272,10 @@ setup_hardware_optimization (bool try_optimization)
 		mix_buffers_no_gain   = default_mix_buffers_no_gain;
 		copy_vector           = default_copy_vector;
 
+		apply_gain_vector_to_buffer  = default_apply_gain_vector_to_buffer;
+		mix_buffers_with_gain_vector = default_mix_buffers_with_gain_vector;
+		crossfade_buffers            = default_crossfade_buffers;
+
 		info << "No H/W specific optimizations in use" << endmsg;
 	}
 
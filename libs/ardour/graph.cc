@@ -19,8 +19,13 @@
 */
 #include <stdio.h>
 #include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <map>
 
 #include "pbd/compose.h"
+#include "pbd/cpus.h"
+#include "pbd/error.h"
 #include "pbd/debug_rt_alloc.h"
 #include "pbd/pthread_utils.h"
 
@@ -31,6 +36,7 @@
 #include "ardour/route.h"
 #include "ardour/process_thread.h"
 #include "ardour/audioengine.h"
+#include "ardour/rc_configuration.h"
 
 #include "pbd/i18n.h"
 
@@ -38,6 +44,30 @@ using namespace ARDOUR;
 using namespace PBD;
 using namespace std;
 
+/* Capacity of each per-thread trigger queue. A queue never holds more
+ * nodes than there are routes in the graph.
+ */
+static const guint trigger_queue_capacity = 8192;
+
+/* Number of rounds of work-stealing attempts an idle process thread makes
+ * before it goes to sleep. Waking a thread via the semaphore costs far
+ * more than a few spins when the next node becomes runnable shortly.
+ */
+static const int steal_spin_rounds = 64;
+
+namespace {
+
+/** Orders schedule indices by increasing critical path length */
+struct CriticalPathLess {
+	CriticalPathLess (vector<uint32_t> const & cp) : critical_path (cp) {}
+	bool operator() (uint32_t a, uint32_t b) const {
+		return critical_path[a] < critical_path[b];
+	}
+	vector<uint32_t> const & critical_path;
+};
+
+}
+
 #ifdef DEBUG_RT_ALLOC
 static Graph* graph = 0;
 
@@ -59,14 +89,9 @@ Graph::Graph (Session & session)
 	, _callback_done_sem ("graph_done", 0)
 	, _cleanup_sem ("graph_cleanup", 0)
 {
-        pthread_mutex_init( &_trigger_mutex, NULL);
-
-	/* XXX: rather hacky `fix' to stop _trigger_queue.push_back() allocating
-	   memory in the RT thread.
-	*/
-	_trigger_queue.reserve (8192);
-
         _execution_tokens = 0;
+        _trigger_queue_size = 0;
+        _next_worker = 1;
 
         _current_chain = 0;
         _pending_chain = 0;
@@ -103,6 +128,17 @@ Graph::reset_thread_list ()
 	/* For now, we shouldn't be using the graph code if we only have 1 DSP thread */
 	assert (num_threads > 1);
 
+	/* when DSP threads are bound to the cores of a NUMA node, run no more
+	   threads than the node has cores, so that no two share a core (see
+	   bind_to_dsp_core()).
+	*/
+	if (Config->get_dsp_numa_node () >= 0) {
+		vector<int> cpus;
+		if (numa_node_cpus (Config->get_dsp_numa_node (), cpus) && cpus.size () > 1) {
+			num_threads = min (num_threads, (uint32_t) cpus.size ());
+		}
+	}
+
         /* don't bother doing anything here if we already have the right
            number of threads.
         */
@@ -117,6 +153,18 @@ Graph::reset_thread_list ()
                 drop_threads ();
         }
 
+        for (vector<TriggerQueue*>::iterator i = _trigger_queues.begin(); i != _trigger_queues.end(); ++i) {
+                delete *i;
+        }
+        _trigger_queues.clear ();
+
+        for (uint32_t i = 0; i < num_threads; ++i) {
+                _trigger_queues.push_back (new TriggerQueue (trigger_queue_capacity));
+        }
+
+        g_atomic_int_set (&_trigger_queue_size, 0);
+        g_atomic_int_set (&_next_worker, 1);
+
         _threads_active = true;
 
 	if (AudioEngine::instance()->create_process_thread (boost::bind (&Graph::main_thread, this)) != 0) {
@@ -138,9 +186,14 @@ Graph::session_going_away()
         // now drop all references on the nodes.
         _nodes_rt[0].clear();
         _nodes_rt[1].clear();
-        _init_trigger_list[0].clear();
-        _init_trigger_list[1].clear();
-        _trigger_queue.clear();
+        _schedule[0].clear();
+        _schedule[1].clear();
+
+        for (vector<TriggerQueue*>::iterator i = _trigger_queues.begin(); i != _trigger_queues.end(); ++i) {
+                delete *i;
+        }
+        _trigger_queues.clear ();
+        g_atomic_int_set (&_trigger_queue_size, 0);
 }
 
 void
@@ -152,14 +205,10 @@ Graph::drop_threads ()
         uint32_t thread_count = AudioEngine::instance()->process_thread_count ();
 
         for (unsigned int i=0; i < thread_count; i++) {
-		pthread_mutex_lock (&_trigger_mutex);
 		_execution_sem.signal ();
-		pthread_mutex_unlock (&_trigger_mutex);
         }
 
-	pthread_mutex_lock (&_trigger_mutex);
         _callback_start_sem.signal ();
-	pthread_mutex_unlock (&_trigger_mutex);
 
 	AudioEngine::instance()->join_process_threads ();
 
@@ -173,13 +222,8 @@ Graph::clear_other_chain ()
 
         while (1) {
                 if (_setup_chain != _pending_chain) {
-
-                        for (node_list_t::iterator ni=_nodes_rt[_setup_chain].begin(); ni!=_nodes_rt[_setup_chain].end(); ni++) {
-                                (*ni)->_activation_set[_setup_chain].clear();
-                        }
-
                         _nodes_rt[_setup_chain].clear ();
-                        _init_trigger_list[_setup_chain].clear ();
+                        _schedule[_setup_chain].clear ();
                         break;
                 }
                 /* setup chain == pending chain - we have
@@ -190,9 +234,20 @@ Graph::clear_other_chain ()
 }
 
 void
-Graph::prep()
+Graph::Schedule::clear ()
+{
+        nodes.clear ();
+        activation_offset.clear ();
+        activations.clear ();
+        init_refcount.clear ();
+        refcount.clear ();
+        critical_path.clear ();
+        init_trigger.clear ();
+}
+
+void
+Graph::prep (uint32_t worker)
 {
-        node_list_t::iterator i;
         int chain;
 
         if (_swap_mutex.trylock()) {
@@ -209,35 +264,123 @@ Graph::prep()
 
         chain = _current_chain;
 
-        _graph_empty = true;
-        for (i=_nodes_rt[chain].begin(); i!=_nodes_rt[chain].end(); i++) {
-                (*i)->prep( chain);
-                _graph_empty = false;
+        Schedule& s (_schedule[chain]);
+
+        _graph_empty = s.nodes.empty ();
+
+        if (!_graph_empty) {
+                memcpy (&s.refcount[0], &s.init_refcount[0], s.refcount.size () * sizeof (gint));
         }
+
         _finished_refcount = _init_finished_refcount[chain];
 
-	/* Trigger the initial nodes for processing, which are the ones at the `input' end */
-	pthread_mutex_lock (&_trigger_mutex);
-        for (i=_init_trigger_list[chain].begin(); i!=_init_trigger_list[chain].end(); i++) {
-		/* don't use ::trigger here, as we have already locked the mutex */
-                _trigger_queue.push_back (i->get ());
+	/* Trigger the initial nodes for processing, which are the ones at the `input' end.
+	   They all go onto the queue of the thread that runs prep(); idle
+	   threads will steal them from there.  init_trigger is sorted so that
+	   the node at the head of the longest chain is pushed last, and so is
+	   the first one that we run ourselves.
+	*/
+        for (vector<uint32_t>::const_iterator i = s.init_trigger.begin(); i != s.init_trigger.end(); ++i) {
+                trigger (s.nodes[*i], worker);
         }
-	pthread_mutex_unlock (&_trigger_mutex);
 }
 
+/** Make @param n runnable by pushing it onto the queue owned by @param worker,
+ *  which must be the calling thread.
+ */
 void
-Graph::trigger (GraphNode* n)
+Graph::trigger (GraphNode* n, uint32_t worker)
+{
+        g_atomic_int_inc (&_trigger_queue_size);
+
+        if (!_trigger_queues[worker]->push (n)) {
+		/* cannot happen unless a single cycle has more runnable routes
+		   than trigger_queue_capacity; run it right here rather than lose it.
+		*/
+                g_atomic_int_add (&_trigger_queue_size, -1);
+                n->process ();
+                finish (n, worker);
+        }
+}
+
+/** Called when @param n has been processed by @param worker: tell the nodes
+ *  that it feeds, queueing any that have nothing left to wait for.
+ */
+void
+Graph::finish (GraphNode* n, uint32_t worker)
+{
+        const int chain = _current_chain;
+        Schedule& s (_schedule[chain]);
+
+        const uint32_t i = n->_schedule_index[chain];
+        const uint32_t begin = s.activation_offset[i];
+        const uint32_t end = s.activation_offset[i + 1];
+
+        if (begin == end) {
+		/* This node does not feed anybody, so decrement the graph's finished count */
+                dec_ref (worker);
+                return;
+        }
+
+	/* activations are sorted by increasing critical path, so the
+	   longest chain is pushed last and run next by this thread.
+	*/
+        for (uint32_t a = begin; a < end; ++a) {
+                const uint32_t j = s.activations[a];
+                if (g_atomic_int_dec_and_test (&s.refcount[j])) {
+                        trigger (s.nodes[j], worker);
+                }
+        }
+}
+
+/** Take a runnable node from @param worker's own queue or, failing that,
+ *  steal one from another thread's queue.
+ *  @return the node, or 0 if none could be found.
+ */
+GraphNode*
+Graph::pop_or_steal (uint32_t worker)
 {
-	pthread_mutex_lock (&_trigger_mutex);
-        _trigger_queue.push_back (n);
-	pthread_mutex_unlock (&_trigger_mutex);
+        GraphNode* n = _trigger_queues[worker]->pop ();
+
+        if (!n) {
+                const uint32_t nq = _trigger_queues.size ();
+                for (uint32_t i = 1; i < nq && !n; ++i) {
+                        n = _trigger_queues[(worker + i) % nq]->steal ();
+                }
+        }
+
+        if (n) {
+                g_atomic_int_add (&_trigger_queue_size, -1);
+        }
+
+        return n;
+}
+
+/** Wake up as many sleeping threads as there are queued nodes for them to run */
+void
+Graph::wake_helpers ()
+{
+        int ts = g_atomic_int_get (&_trigger_queue_size);
+
+        while (ts > 0) {
+                int et = g_atomic_int_get (&_execution_tokens);
+                if (et <= 0) {
+                        break;
+                }
+		/* claim one sleeping thread; another waker may have beaten us to it */
+                if (g_atomic_int_compare_and_exchange (&_execution_tokens, et, et - 1)) {
+                        DEBUG_TRACE(DEBUG::ProcessThreads, string_compose ("%1 signals a sleeping thread\n", pthread_name()));
+                        _execution_sem.signal ();
+                        --ts;
+                }
+        }
 }
 
 /** Called when a node at the `output' end of the chain (ie one that has no-one to feed)
  *  is finished.
  */
 void
-Graph::dec_ref()
+Graph::dec_ref (uint32_t worker)
 {
         if (g_atomic_int_dec_and_test (const_cast<gint*> (&_finished_refcount))) {
 
@@ -245,12 +388,12 @@ Graph::dec_ref()
 		   the graph, so there is nothing more to do this time around.
 		*/
 
-		restart_cycle ();
+		restart_cycle (worker);
         }
 }
 
 void
-Graph::restart_cycle()
+Graph::restart_cycle (uint32_t worker)
 {
         // we are through. wakeup our caller.
 
@@ -264,7 +407,7 @@ Graph::restart_cycle()
                 return;
         }
 
-	prep ();
+	prep (worker);
 
         if (_graph_empty && _threads_active) {
                 goto again;
@@ -287,135 +430,218 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const & edges
         int chain = _setup_chain;
         DEBUG_TRACE (DEBUG::Graph, string_compose ("============== setup %1\n", chain));
 
+        Schedule& s (_schedule[chain]);
+
+        s.clear ();
+        _nodes_rt[chain].clear();
+
 	/* This will become the number of nodes that do not feed any other node;
 	   once we have processed this number of those nodes, we have finished.
 	*/
         _init_finished_refcount[chain] = 0;
 
-	/* This will become a list of nodes that are not fed by another node, ie
-	   those at the `input' end.
-	*/
-        _init_trigger_list[chain].clear();
+	/* Make _nodes_rt[chain] a copy of routelist, and number the routes */
+        map<GraphNode*, uint32_t> index;
 
-        _nodes_rt[chain].clear();
-
-	/* Clear things out, and make _nodes_rt[chain] a copy of routelist */
         for (RouteList::iterator ri=routelist->begin(); ri!=routelist->end(); ri++) {
-                (*ri)->_init_refcount[chain] = 0;
-                (*ri)->_activation_set[chain].clear();
+                (*ri)->_schedule_index[chain] = s.nodes.size ();
+                index[ri->get ()] = s.nodes.size ();
+                s.nodes.push_back (ri->get ());
                 _nodes_rt[chain].push_back (*ri);
         }
 
-        // now add refs for the connections.
+        const uint32_t n_nodes = s.nodes.size ();
 
-        for (node_list_t::iterator ni = _nodes_rt[chain].begin(); ni != _nodes_rt[chain].end(); ni++) {
+	/* The nodes that each node directly feeds, and so the number of
+	   nodes that directly feed each node.
+	*/
+        vector<vector<uint32_t> > fed (n_nodes);
 
-                boost::shared_ptr<Route> r = boost::dynamic_pointer_cast<Route> (*ni);
+        s.init_refcount.assign (n_nodes, 0);
 
-		/* The routes that are directly fed by r */
-		set<GraphVertex> fed_from_r = edges.from (r);
+        for (RouteList::iterator ri=routelist->begin(); ri!=routelist->end(); ri++) {
 
-		/* Hence whether r has an output */
-		bool const has_output = !fed_from_r.empty ();
+		const uint32_t i = (*ri)->_schedule_index[chain];
+		set<GraphVertex> fed_from_r = edges.from (*ri);
 
-		/* Set up r's activation set */
-		for (set<GraphVertex>::iterator i = fed_from_r.begin(); i != fed_from_r.end(); ++i) {
-			r->_activation_set[chain].insert (*i);
+		for (set<GraphVertex>::iterator f = fed_from_r.begin(); f != fed_from_r.end(); ++f) {
+			map<GraphNode*, uint32_t>::const_iterator j = index.find (f->get ());
+			if (j != index.end ()) {
+				fed[i].push_back (j->second);
+				s.init_refcount[j->second] += 1;
+			}
 		}
+        }
+
+	/* Put the nodes in topological order (the graph is acyclic), then
+	   work back from the `output' end to find the length of the longest
+	   path from each node.
+	*/
+        vector<uint32_t> order;
+        vector<gint> pending (s.init_refcount);
+
+        order.reserve (n_nodes);
+
+        for (uint32_t i = 0; i < n_nodes; ++i) {
+                if (pending[i] == 0) {
+                        order.push_back (i);
+                }
+        }
 
-		/* r has an input if there are some incoming edges to r in the graph */
-		bool const has_input = !edges.has_none_to (r);
+        for (size_t o = 0; o < order.size (); ++o) {
+                for (vector<uint32_t>::const_iterator j = fed[order[o]].begin(); j != fed[order[o]].end(); ++j) {
+                        if (--pending[*j] == 0) {
+                                order.push_back (*j);
+                        }
+                }
+        }
 
-		/* Increment the refcount of any route that we directly feed */
-                for (node_set_t::iterator ai = r->_activation_set[chain].begin(); ai != r->_activation_set[chain].end(); ai++) {
-                        (*ai)->_init_refcount[chain] += 1;
+        assert (order.size () == n_nodes);
+
+        s.critical_path.assign (n_nodes, 1);
+
+        for (vector<uint32_t>::reverse_iterator o = order.rbegin(); o != order.rend(); ++o) {
+                for (vector<uint32_t>::const_iterator j = fed[*o].begin(); j != fed[*o].end(); ++j) {
+                        s.critical_path[*o] = max (s.critical_path[*o], s.critical_path[*j] + 1);
                 }
+        }
 
-                if (!has_input) {
+	/* Flatten the activation lists, each sorted by increasing critical
+	   path: the last node triggered is the first one that the triggering
+	   thread runs itself, and it should be the one with the most work
+	   waiting behind it.
+	*/
+        CriticalPathLess by_critical_path (s.critical_path);
+
+        s.activation_offset.reserve (n_nodes + 1);
+
+        for (uint32_t i = 0; i < n_nodes; ++i) {
+
+                s.activation_offset.push_back (s.activations.size ());
+
+                sort (fed[i].begin(), fed[i].end(), by_critical_path);
+                s.activations.insert (s.activations.end(), fed[i].begin(), fed[i].end());
+
+                if (s.init_refcount[i] == 0) {
 			/* no input, so this node needs to be triggered initially to get things going */
-                        _init_trigger_list[chain].push_back (*ni);
-		}
+                        s.init_trigger.push_back (i);
+                }
 
-                if (!has_output) {
+                if (fed[i].empty ()) {
 			/* no output, so this is one of the nodes that we can count off to decide
 			   if we've finished
 			*/
                         _init_finished_refcount[chain] += 1;
-		}
+                }
         }
 
+        s.activation_offset.push_back (s.activations.size ());
+
+        sort (s.init_trigger.begin(), s.init_trigger.end(), by_critical_path);
+
+        s.refcount.assign (n_nodes, 0);
+
         _pending_chain = chain;
         dump(chain);
 }
 
 /** Called by both the main thread and all helpers.
+ *  @param worker the index of the calling thread's trigger queue.
  *  @return true to quit, false to carry on.
  */
 bool
-Graph::run_one()
+Graph::run_one (uint32_t worker)
 {
-        GraphNode* to_run;
-
-        pthread_mutex_lock (&_trigger_mutex);
-        if (_trigger_queue.size()) {
-                to_run = _trigger_queue.back();
-                _trigger_queue.pop_back();
-        } else {
-                to_run = 0;
-        }
-
-	/* the number of threads that are asleep */
-	int et = _execution_tokens;
-	/* the number of nodes that need to be run */
-	int ts = _trigger_queue.size();
-
-	/* hence how many threads to wake up */
-        int wakeup = min (et, ts);
-	/* update the number of threads that will still be sleeping */
-        _execution_tokens -= wakeup;
+        GraphNode* to_run = pop_or_steal (worker);
 
-        DEBUG_TRACE(DEBUG::ProcessThreads, string_compose ("%1 signals %2\n", pthread_name(), wakeup));
+	/* If there is more queued work than we are about to run, wake
+	   up sleeping threads to take it.
+	*/
+        wake_helpers ();
 
-        for (int i = 0; i < wakeup; i++) {
-                _execution_sem.signal ();
+	/* Spin for a while trying to steal work before sleeping: the nodes
+	   that we are waiting for are usually about to be triggered by
+	   another thread.
+	*/
+        for (int spin = 0; to_run == 0 && spin < steal_spin_rounds && _threads_active; ++spin) {
+                to_run = pop_or_steal (worker);
         }
 
         while (to_run == 0) {
-                _execution_tokens += 1;
-                pthread_mutex_unlock (&_trigger_mutex);
+                g_atomic_int_inc (&_execution_tokens);
                 DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 goes to sleep\n", pthread_name()));
                 _execution_sem.wait ();
                 if (!_threads_active) {
                         return true;
                 }
                 DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 is awake\n", pthread_name()));
-                pthread_mutex_lock (&_trigger_mutex);
-                if (_trigger_queue.size()) {
-                        to_run = _trigger_queue.back();
-                        _trigger_queue.pop_back();
-                }
+                to_run = pop_or_steal (worker);
         }
-        pthread_mutex_unlock (&_trigger_mutex);
 
         to_run->process();
-        to_run->finish (_current_chain);
+        finish (to_run, worker);
 
         DEBUG_TRACE(DEBUG::ProcessThreads, string_compose ("%1 has finished run_one()\n", pthread_name()));
 
         return !_threads_active;
 }
 
+/** If the configuration asks for it, bind the calling thread, which runs
+ *  @param worker's queue, to one of the cores of the configured NUMA node.
+ *  Workers are spread over the node's cores in order, so each worker stays
+ *  on one core and no two share a core. This does not keep a route on one
+ *  core: prep() runs on whichever thread finished the last cycle and nodes
+ *  are stolen by idle workers, so a route may run on any core of the node.
+ *  This allocates, so call it with RT malloc checks suspended.
+ *  @return true if the thread was bound.
+ */
+bool
+Graph::bind_to_dsp_core (uint32_t worker)
+{
+	const int node = Config->get_dsp_numa_node ();
+
+	if (node < 0) {
+		return false;
+	}
+
+	vector<int> cpus;
+
+	if (!numa_node_cpus (node, cpus)) {
+		if (worker == 0) {
+			warning << string_compose (_("Cannot find the CPUs of NUMA node %1; DSP threads will not be bound to it"), node) << endmsg;
+		}
+		return false;
+	}
+
+	/* reset_thread_list() runs at most one worker per core of the node */
+	const int cpu = cpus[worker % cpus.size ()];
+	const int err = set_thread_cpu_affinity (cpu);
+
+	if (err) {
+		warning << string_compose (_("Cannot bind DSP thread %1 to CPU %2 (%3)"), worker, cpu, strerror (err)) << endmsg;
+		return false;
+	}
+
+	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("DSP thread %1 bound to CPU %2 on NUMA node %3\n", worker, cpu, node));
+
+	return true;
+}
+
 void
 Graph::helper_thread()
 {
+	const uint32_t worker = g_atomic_int_add (&_next_worker, 1);
+	assert (worker < _trigger_queues.size ());
+
 	suspend_rt_malloc_checks ();
+	const bool bound = bind_to_dsp_core (worker);
 	ProcessThread* pt = new ProcessThread ();
+	/* a thread bound to a core takes its buffers from that core's memory */
+	pt->get_buffers (bound);
 	resume_rt_malloc_checks ();
 
-	pt->get_buffers();
-
 	while(1) {
-		if (run_one()) {
+		if (run_one (worker)) {
 			break;
 		}
 	}
@@ -429,11 +655,11 @@ void
 Graph::main_thread()
 {
 	suspend_rt_malloc_checks ();
+	const bool bound = bind_to_dsp_core (0);
 	ProcessThread* pt = new ProcessThread ();
+	pt->get_buffers (bound);
 	resume_rt_malloc_checks ();
 
-	pt->get_buffers();
-
 again:
 	_callback_start_sem.wait ();
 
@@ -443,7 +669,7 @@ again:
 		return;
 	}
 
-	prep ();
+	prep (0);
 
 	if (_graph_empty && _threads_active) {
 		_callback_done_sem.signal ();
@@ -454,7 +680,7 @@ again:
 	/* This loop will run forever */
 	while (1) {
 		DEBUG_TRACE(DEBUG::ProcessThreads, "main thread runs one graph node\n");
-		if (run_one()) {
+		if (run_one (0)) {
 			break;
 		}
 	}
@@ -467,23 +693,22 @@ void
 Graph::dump (int chain)
 {
 #ifndef NDEBUG
-        node_list_t::iterator ni;
-        node_set_t::iterator ai;
-
         chain = _pending_chain;
 
+        Schedule const & s (_schedule[chain]);
+
         DEBUG_TRACE (DEBUG::Graph, "--------------------------------------------Graph dump:\n");
-        for (ni=_nodes_rt[chain].begin(); ni!=_nodes_rt[chain].end(); ni++) {
-                boost::shared_ptr<Route> rp = boost::dynamic_pointer_cast<Route>( *ni);
-                DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", rp->name().c_str(), (*ni)->_init_refcount[chain]));
-                for (ai=(*ni)->_activation_set[chain].begin(); ai!=(*ni)->_activation_set[chain].end(); ai++) {
-                        DEBUG_TRACE (DEBUG::Graph, string_compose ("  triggers: %1\n", boost::dynamic_pointer_cast<Route>(*ai)->name().c_str()));
+        for (uint32_t i = 0; i < s.nodes.size (); ++i) {
+                Route* rp = dynamic_cast<Route*> (s.nodes[i]);
+                DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2  critical path: %3\n", rp->name().c_str(), s.init_refcount[i], s.critical_path[i]));
+                for (uint32_t a = s.activation_offset[i]; a < s.activation_offset[i + 1]; ++a) {
+                        DEBUG_TRACE (DEBUG::Graph, string_compose ("  triggers: %1\n", dynamic_cast<Route*> (s.nodes[s.activations[a]])->name().c_str()));
                 }
         }
 
         DEBUG_TRACE (DEBUG::Graph, "------------- trigger list:\n");
-        for (ni=_init_trigger_list[chain].begin(); ni!=_init_trigger_list[chain].end(); ni++) {
-                DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", boost::dynamic_pointer_cast<Route>(*ni)->name().c_str(), (*ni)->_init_refcount[chain]));
+        for (vector<uint32_t>::const_iterator i = s.init_trigger.begin(); i != s.init_trigger.end(); ++i) {
+                DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", dynamic_cast<Route*> (s.nodes[*i])->name().c_str(), s.init_refcount[*i]));
         }
 
         DEBUG_TRACE (DEBUG::Graph, string_compose ("final activation refcount: %1\n", _init_finished_refcount[chain]));
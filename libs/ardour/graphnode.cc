@@ -27,52 +27,14 @@ using namespace ARDOUR;
 GraphNode::GraphNode (boost::shared_ptr<Graph> graph)
         : _graph(graph)
 {
+	_schedule_index[0] = 0;
+	_schedule_index[1] = 0;
 }
 
 GraphNode::~GraphNode()
 {
 }
 
-void
-GraphNode::prep (int chain)
-{
-	/* This is the number of nodes that directly feed us */
-        _refcount = _init_refcount[chain];
-}
-
-/** Called by another node to tell us that one of the nodes that feed us
- *  has been processed.
- */
-void
-GraphNode::dec_ref()
-{
-        if (g_atomic_int_dec_and_test (&_refcount)) {
-		/* All the nodes that feed us are done, so we can queue this node
-		   for processing.
-		*/
-                _graph->trigger (this);
-	}
-}
-
-void
-GraphNode::finish (int chain)
-{
-        node_set_t::iterator i;
-        bool feeds_somebody = false;
-
-	/* Tell the nodes that we feed that we've finished */
-        for (i=_activation_set[chain].begin(); i!=_activation_set[chain].end(); i++) {
-                (*i)->dec_ref();
-                feeds_somebody = true;
-        }
-
-        if (!feeds_somebody) {
-		/* This node does not feed anybody, so decrement the graph's finished count */
-                _graph->dec_ref();
-        }
-}
-
-
 void
 GraphNode::process()
 {
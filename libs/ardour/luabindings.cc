@@ -180,6 +180,7 @@ CLASSKEYS(ARDOUR::SessionConfiguration);
 CLASSKEYS(ARDOUR::Source);
 
 CLASSKEYS(PBD::ID);
+CLASSKEYS(PBD::DurationStats);
 CLASSKEYS(PBD::Configuration);
 CLASSKEYS(PBD::PropertyChange);
 CLASSKEYS(PBD::StatefulDestructible);
@@ -319,6 +320,16 @@ LuaBindings::common (lua_State* L)
 
 		.beginStdVector <PBD::ID> ("IdVector").endClass ()
 
+		.beginClass <PBD::DurationStats> ("DurationStats")
+		.addConstructor <void (*) ()> ()
+		.addData ("count", &PBD::DurationStats::count, false)
+		.addFunction ("min_usecs", &PBD::DurationStats::min_usecs)
+		.addFunction ("max_usecs", &PBD::DurationStats::max_usecs)
+		.addFunction ("avg_usecs", &PBD::DurationStats::avg_usecs)
+		.addFunction ("last_usecs", &PBD::DurationStats::last_usecs)
+		.addFunction ("bucket", &PBD::DurationStats::bucket)
+		.endClass ()
+
 		.beginClass <XMLNode> ("XMLNode")
 		.addFunction ("name", &XMLNode::name)
 		.endClass ()
@@ -1201,6 +1212,8 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("active", &Processor::active)
 		.addFunction ("activate", &Processor::activate)
 		.addFunction ("deactivate", &Processor::deactivate)
+		.addFunction ("get_dsp_stats", &Processor::get_dsp_stats)
+		.addFunction ("reset_dsp_stats", &Processor::reset_dsp_stats)
 		.addFunction ("output_streams", &PluginInsert::output_streams)
 		.addFunction ("input_streams", &PluginInsert::input_streams)
 		.endClass ()
@@ -1796,6 +1809,8 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("new_midi_route", &Session::new_midi_route)
 		.addFunction ("get_routes", &Session::get_routes)
 		.addFunction ("get_tracks", &Session::get_tracks)
+		.addFunction ("most_expensive_processors", &Session::most_expensive_processors)
+		.addFunction ("reset_dsp_stats", &Session::reset_dsp_stats)
 		.addFunction ("name", &Session::name)
 		.addFunction ("path", &Session::path)
 		.addFunction ("record_status", &Session::record_status)
@@ -1644,8 +1644,7 @@ MidiModel::resolve_overlaps_unlocked (const NotePtr note, void* arg)
 	TimeType sa = note->time();
 	TimeType ea  = note->end_time();
 
-	const Pitches& p (pitches (note->channel()));
-	NotePtr search_note(new Note<TimeType>(0, TimeType(), TimeType(), note->note()));
+	const Pitches& p (pitches (note->channel(), note->note()));
 	set<NotePtr> to_be_deleted;
 	bool set_note_length = false;
 	bool set_note_time = false;
@@ -1654,8 +1653,7 @@ MidiModel::resolve_overlaps_unlocked (const NotePtr note, void* arg)
 
 	DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1 checking overlaps for note %2 @ %3\n", this, (int)note->note(), note->time()));
 
-	for (Pitches::const_iterator i = p.lower_bound (search_note);
-	     i != p.end() && (*i)->note() == note->note(); ++i) {
+	for (Pitches::const_iterator i = p.begin(); i != p.end(); ++i) {
 
 		TimeType sb = (*i)->time();
 		TimeType eb = (*i)->end_time();
@@ -362,6 +362,7 @@ MidiPlaylist::destroy_region (boost::shared_ptr<Region> region)
 
 			if ((*i) == region) {
 				regions.erase (i);
+				unindex_region (region);
 				changed = true;
 			}
 
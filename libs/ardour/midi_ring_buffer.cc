@@ -238,7 +238,7 @@ MidiRingBuffer<T>::dump(ostream& str)
 	uint32_t          ev_size;
 
 	RingBufferNPT<uint8_t>::rw_vector vec;
-	RingBufferNPT<uint8_t>::get_read_vector (&vec);
+	RingBufferNPT<uint8_t>::peek_read_vector (&vec);
 
 	if (vec.len[0] == 0) {
 		return;
@@ -142,6 +142,30 @@ default_copy_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t
 	memcpy(dst, src, nframes*sizeof(ARDOUR::Sample));
 }
 
+void
+default_apply_gain_vector_to_buffer (ARDOUR::Sample * buf, const ARDOUR::gain_t * gains, pframes_t nframes, float gain)
+{
+	for (pframes_t i = 0; i < nframes; i++) {
+		buf[i] *= gains[i] * gain;
+	}
+}
+
+void
+default_mix_buffers_with_gain_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, const ARDOUR::gain_t * gains, pframes_t nframes)
+{
+	for (pframes_t i = 0; i < nframes; i++) {
+		dst[i] += src[i] * gains[i];
+	}
+}
+
+void
+default_crossfade_buffers (ARDOUR::Sample * dst, const ARDOUR::Sample * src, const ARDOUR::gain_t * gains, pframes_t nframes)
+{
+	for (pframes_t i = 0; i < nframes; i++) {
+		dst[i] += (src[i] - dst[i]) * gains[i];
+	}
+}
+
 #if defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
 #include <Accelerate/Accelerate.h>
 
@@ -180,6 +204,22 @@ veclib_mix_buffers_no_gain (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pf
 	vDSP_vsma(src, 1, &gain, dst, 1, dst, 1, nframes);
 }
 
+void
+veclib_apply_gain_vector_to_buffer (ARDOUR::Sample * buf, const ARDOUR::gain_t * gains, pframes_t nframes, float gain)
+{
+	if (gain == 1.0f) {
+		vDSP_vmul(buf, 1, gains, 1, buf, 1, nframes);
+	} else {
+		default_apply_gain_vector_to_buffer (buf, gains, nframes, gain);
+	}
+}
+
+void
+veclib_mix_buffers_with_gain_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, const ARDOUR::gain_t * gains, pframes_t nframes)
+{
+	vDSP_vma(src, 1, gains, 1, dst, 1, dst, 1, nframes);
+}
+
 #endif
 
 
@@ -0,0 +1,358 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifdef WAF_BUILD
+#include "libardour-config.h"
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifndef PLATFORM_WINDOWS
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <glib.h>
+#include <sndfile.h>
+
+#include <glibmm/fileutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+
+#include "ardour/broadcast_info.h"
+#include "ardour/mmap_file_source.h"
+#include "ardour/rc_configuration.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+namespace {
+
+/** Everything we need to know about a file to map it */
+struct Layout {
+	Layout () : sample_rate (0), frames (0), data_offset (0), file_size (0), time_reference (0), bwf (false) {}
+
+	int        sample_rate;
+	framecnt_t frames;
+	off_t      data_offset;
+	off_t      file_size;
+	int64_t    time_reference;
+	bool       bwf;
+};
+
+/** Use libsndfile to find out if the file open on @param fd is a mono,
+ *  native-endian 32 bit float file, and if so, where its sample data lives.
+ *  The descriptor is left open.
+ */
+bool
+probe (int fd, Layout& layout)
+{
+#ifdef PLATFORM_WINDOWS
+	return false;
+#else
+	if (G_BYTE_ORDER != G_LITTLE_ENDIAN) {
+		return false;
+	}
+
+	char magic[4];
+
+	/* libsndfile reads "RIFX" (big-endian) WAV files too */
+	if (pread (fd, magic, sizeof (magic), 0) != sizeof (magic) ||
+	    (memcmp (magic, "RIFF", 4) && memcmp (magic, "RF64", 4))) {
+		return false;
+	}
+
+	struct stat st;
+
+	if (fstat (fd, &st)) {
+		return false;
+	}
+
+	SF_INFO info;
+	memset (&info, 0, sizeof (info));
+
+	SNDFILE* sf = sf_open_fd (fd, SFM_READ, &info, false);
+
+	if (!sf) {
+		return false;
+	}
+
+	bool ok = false;
+
+	switch (info.format & SF_FORMAT_TYPEMASK) {
+	case SF_FORMAT_WAV:
+	case SF_FORMAT_WAVEX:
+	case SF_FORMAT_RF64:
+		ok = info.channels == 1 && (info.format & SF_FORMAT_SUBMASK) == SF_FORMAT_FLOAT;
+		break;
+	default:
+		break;
+	}
+
+	/* libsndfile seeks the descriptor to the start of the data chunk for this */
+
+	if (ok && sf_seek (sf, 0, SEEK_SET|SFM_READ) == 0) {
+		layout.data_offset = lseek (fd, 0, SEEK_CUR);
+		layout.frames = info.frames;
+		layout.sample_rate = info.samplerate;
+		layout.file_size = st.st_size;
+
+		ok = layout.data_offset > 0 &&
+			(layout.data_offset % sizeof (Sample)) == 0 &&
+			layout.data_offset + (off_t) (layout.frames * sizeof (Sample)) <= layout.file_size;
+
+		if (ok) {
+			BroadcastInfo bwf;
+			if ((layout.bwf = bwf.load_from_file (sf))) {
+				layout.time_reference = bwf.get_time_reference ();
+			}
+		}
+	} else {
+		ok = false;
+	}
+
+	sf_close (sf);
+	return ok;
+#endif
+}
+
+}
+
+/** Constructor for existing in-session files during session loading */
+MmapFileSource::MmapFileSource (Session& s, const XMLNode& node)
+	: Source (s, node)
+	, AudioFileSource (s, node)
+	, _sample_rate (0)
+	, _map (0)
+	, _map_length (0)
+	, _data (0)
+	, _readahead_start (0)
+	, _readahead_end (0)
+{
+	if (writable () || _channel != 0) {
+		throw failed_constructor ();
+	}
+
+	init_mmap ();
+
+        assert (Glib::file_test (_path, Glib::FILE_TEST_EXISTS));
+	existence_check ();
+}
+
+/** Constructor for existing external-to-session files.
+ *  Files created this way are never writable or removable.
+ */
+MmapFileSource::MmapFileSource (Session& s, const string& path, int chn, Flag flags)
+	: Source (s, DataType::AUDIO, path, Flag (flags & ~(Writable|Removable|RemovableIfEmpty|RemoveAtDestroy)))
+	, AudioFileSource (s, path, Flag (flags & ~(Writable|Removable|RemovableIfEmpty|RemoveAtDestroy)))
+	, _sample_rate (0)
+	, _map (0)
+	, _map_length (0)
+	, _data (0)
+	, _readahead_start (0)
+	, _readahead_end (0)
+{
+	if (chn != 0) {
+		throw failed_constructor ();
+	}
+
+	_channel = chn;
+
+	init_mmap ();
+
+        assert (Glib::file_test (_path, Glib::FILE_TEST_EXISTS));
+	existence_check ();
+}
+
+MmapFileSource::~MmapFileSource ()
+{
+#ifndef PLATFORM_WINDOWS
+	if (_map) {
+		munmap (_map, _map_length);
+	}
+#endif
+}
+
+void
+MmapFileSource::init_mmap ()
+{
+#ifdef PLATFORM_WINDOWS
+	throw failed_constructor ();
+#else
+	int fd = ::open (_path.c_str(), O_RDONLY);
+
+	if (fd < 0) {
+		throw failed_constructor ();
+	}
+
+	Layout layout;
+
+	if (!probe (fd, layout)) {
+		::close (fd);
+		throw failed_constructor ();
+	}
+
+	/* mmap() offsets must be page aligned; map from the page that holds
+	 * the start of the data chunk.
+	 */
+
+	off_t const page = sysconf (_SC_PAGESIZE);
+	off_t const map_offset = (layout.data_offset / page) * page;
+
+	_map_length = (layout.data_offset - map_offset) + layout.frames * sizeof (Sample);
+
+	if (_map_length == 0) {
+		/* an empty file; nothing to map, reads return silence */
+		_map = 0;
+	} else {
+		void* addr = mmap (0, _map_length, PROT_READ, MAP_SHARED, fd, map_offset);
+
+		if (addr == MAP_FAILED) {
+			warning << string_compose (_("MmapFileSource: cannot map \"%1\" (%2)"), _path, strerror (errno)) << endmsg;
+			::close (fd);
+			throw failed_constructor ();
+		}
+
+		_map = (char*) addr;
+		_data = (Sample*) (_map + (layout.data_offset - map_offset));
+
+		madvise (_map, _map_length, MADV_SEQUENTIAL);
+	}
+
+	/* the mapping keeps the file referenced */
+	::close (fd);
+
+	_sample_rate = layout.sample_rate;
+	_length = layout.frames;
+
+	/* as SndFileSource::open() does for files we don't write to */
+	set_timeline_position (layout.bwf ? layout.time_reference : header_position_offset);
+
+	if (layout.bwf) {
+		_flags = Flag (_flags | Broadcast);
+	} else {
+		_flags = Flag (_flags & ~Broadcast);
+	}
+#endif
+}
+
+/** Tell the kernel that we will soon want @param cnt frames from @param start */
+void
+MmapFileSource::advise (framepos_t start, framecnt_t cnt) const
+{
+#ifndef PLATFORM_WINDOWS
+	if (!_map || start >= _length || cnt <= 0) {
+		return;
+	}
+
+	if (start + cnt > _length) {
+		cnt = _length - start;
+	}
+
+	/* madvise() wants a page aligned address */
+
+	uintptr_t const page = sysconf (_SC_PAGESIZE);
+	uintptr_t const from = (uintptr_t) (_data + start);
+	uintptr_t const aligned = (from / page) * page;
+
+	madvise ((void*) aligned, (from - aligned) + cnt * sizeof (Sample), MADV_WILLNEED);
+#endif
+}
+
+/** Keep the kernel reading ahead of the reads that happen at @param start.
+ *  The window is as long as the playback buffers, and is moved on once
+ *  reads get half way through it, or jump out of it after a locate.
+ *  Must be called with _lock held.
+ */
+void
+MmapFileSource::readahead (framepos_t start, framecnt_t cnt) const
+{
+	framecnt_t const window = max ((framecnt_t) (Config->get_audio_playback_buffer_seconds() * _sample_rate), cnt);
+
+	if (start < _readahead_start || start + cnt > _readahead_end - window / 2) {
+		advise (start, window);
+		_readahead_start = start;
+		_readahead_end = start + window;
+	}
+}
+
+/** @return a pointer to the samples for @param cnt frames from @param start,
+ *  or 0 if the range is not entirely within the file.
+ */
+Sample const *
+MmapFileSource::mapped_data (framepos_t start, framecnt_t cnt) const
+{
+	if (!_data || _gain != 1.f || start < 0 || cnt <= 0 || start + cnt > _length) {
+		return 0;
+	}
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+	readahead (start, cnt);
+
+	return _data + start;
+}
+
+void
+MmapFileSource::prefetch (framepos_t start, framecnt_t cnt, AsyncReader&) const
+{
+	/* the kernel does this for us, no need for explicit reads */
+	advise (start, cnt);
+}
+
+framecnt_t
+MmapFileSource::read_unlocked (Sample* dst, framepos_t start, framecnt_t cnt) const
+{
+	assert (cnt >= 0);
+
+	framecnt_t file_cnt;
+
+	if (start >= _length || !_data) {
+		file_cnt = 0;
+	} else if (start + cnt > _length) {
+		file_cnt = _length - start;
+	} else {
+		file_cnt = cnt;
+	}
+
+	if (file_cnt != cnt) {
+		memset (dst + file_cnt, 0, sizeof (Sample) * (cnt - file_cnt));
+	}
+
+	if (file_cnt) {
+		readahead (start, file_cnt);
+
+		if (_gain != 1.f) {
+			Sample const * src = _data + start;
+			for (framecnt_t n = 0; n < file_cnt; ++n) {
+				dst[n] = src[n] * _gain;
+			}
+		} else {
+			memcpy (dst, _data + start, sizeof (Sample) * file_cnt);
+		}
+	}
+
+	return cnt;
+}
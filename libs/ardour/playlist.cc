@@ -384,6 +384,10 @@ Playlist::set_name (const string& str)
 	bool ret =  SessionObject::set_name(str);
 	if (ret) {
 		_set_sort_id ();
+		/* SessionObject::set_name() emits PropertyChanged directly,
+		   without going through send_change()
+		*/
+		state_changed ();
 	}
 	return ret;
 }
@@ -746,6 +750,8 @@ Playlist::flush_notifications (bool from_undo)
 		 return false;
 	 }
 
+	 state_changed ();
+
 	 RegionSortByPosition cmp;
 
 	 if (!first_set_state) {
@@ -756,6 +762,7 @@ Playlist::flush_notifications (bool from_undo)
 	 region->set_position (position, sub_num);
 
 	 regions.insert (upper_bound (regions.begin(), regions.end(), region, cmp), region);
+	 index_region (region);
 	 all_regions.insert (region);
 
 	 possibly_splice_unlocked (position, region->length(), region);
@@ -804,6 +811,8 @@ Playlist::flush_notifications (bool from_undo)
  {
 	 RegionList::iterator i;
 
+	 state_changed ();
+
 	 if (!in_set_state) {
 		 /* unset playlist */
 		 region->set_playlist (boost::weak_ptr<Playlist>());
@@ -818,6 +827,7 @@ Playlist::flush_notifications (bool from_undo)
 			 framecnt_t distance = (*i)->length();
 
 			 regions.erase (i);
+			 unindex_region (region);
 
 			 possibly_splice_unlocked (pos, -distance);
 
@@ -1682,11 +1692,50 @@ Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shar
 		 return;
 	 }
 
+	 /* our state includes that of our regions */
+	 state_changed ();
+
+	 /* keep the index in step with the region's bounds, whether or not
+	    region_changed() decides to act on this change.
+	 */
+	 if (what_changed.contains (Properties::position) || what_changed.contains (Properties::length)) {
+		 reindex_region (region);
+	 }
+
 	 /* this makes a virtual call to the right kind of playlist ... */
 
 	 region_changed (what_changed, region);
  }
 
+/** Caller must hold region_lock for writing */
+void
+Playlist::index_region (boost::shared_ptr<Region> region)
+{
+	Glib::Threads::RWLock::WriterLock il (region_index_lock);
+	region_index.insert (region, region->first_frame(), region->last_frame());
+}
+
+/** Move @param region to its current bounds in the index, if it is there.
+ *  Region calls this directly while its PropertyChanged is suspended, so that
+ *  lookups do not see stale bounds until the deferred change is sent.
+ */
+void
+Playlist::reindex_region (boost::shared_ptr<Region> region)
+{
+	Glib::Threads::RWLock::WriterLock il (region_index_lock);
+	if (region_index.contains (region)) {
+		region_index.insert (region, region->first_frame(), region->last_frame());
+	}
+}
+
+/** Caller must hold region_lock for writing */
+void
+Playlist::unindex_region (boost::shared_ptr<Region> region)
+{
+	Glib::Threads::RWLock::WriterLock il (region_index_lock);
+	region_index.erase (region);
+}
+
  bool
  Playlist::region_changed (const PropertyChange& what_changed, boost::shared_ptr<Region> region)
  {
@@ -1741,6 +1790,10 @@ Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shar
  {
 	 RegionWriteLock rl (this);
 	 regions.clear ();
+	 {
+		 Glib::Threads::RWLock::WriterLock il (region_index_lock);
+		 region_index.clear ();
+	 }
 	 all_regions.clear ();
  }
 
@@ -1770,6 +1823,10 @@ Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shar
 		 }
 
 		 regions.clear ();
+		 {
+			 Glib::Threads::RWLock::WriterLock il (region_index_lock);
+			 region_index.clear ();
+		 }
 
 		 for (set<boost::shared_ptr<Region> >::iterator s = pending_removes.begin(); s != pending_removes.end(); ++s) {
 			 remove_dependents (*s);
@@ -1822,15 +1879,12 @@ Playlist::regions_at (framepos_t frame)
  Playlist::count_regions_at (framepos_t frame) const
  {
 	 RegionReadLock rlock (const_cast<Playlist*>(this));
-	 uint32_t cnt = 0;
+	 vector<boost::shared_ptr<Region> > covering;
 
-	 for (RegionList::const_iterator i = regions.begin(); i != regions.end(); ++i) {
-		 if ((*i)->covers (frame)) {
-			 cnt++;
-		 }
-	 }
+	 Glib::Threads::RWLock::ReaderLock il (region_index_lock);
+	 region_index.find_covering (frame, covering);
 
-	 return cnt;
+	 return covering.size ();
  }
 
  boost::shared_ptr<Region>
@@ -1838,16 +1892,7 @@ Playlist::regions_at (framepos_t frame)
 
  {
 	 RegionReadLock rlock (this);
-	 boost::shared_ptr<RegionList> rlist = find_regions_at (frame);
-	 boost::shared_ptr<Region> region;
-
-	 if (rlist->size()) {
-		 RegionSortByLayer cmp;
-		 rlist->sort (cmp);
-		 region = rlist->back();
-	 }
-
-	 return region;
+	 return top_region_at_locked (frame, false);
  }
 
  boost::shared_ptr<Region>
@@ -1855,31 +1900,33 @@ Playlist::regions_at (framepos_t frame)
 
  {
 	 RegionReadLock rlock (this);
-	 boost::shared_ptr<RegionList> rlist = find_regions_at (frame);
-
-	 for (RegionList::iterator i = rlist->begin(); i != rlist->end(); ) {
-
-		 RegionList::iterator tmp = i;
-
-		 ++tmp;
-
-		 if ((*i)->muted()) {
-			 rlist->erase (i);
-		 }
+	 return top_region_at_locked (frame, true);
+ }
 
-		 i = tmp;
-	 }
+/** Caller must hold lock.
+ *  @return the highest-layered region covering @param frame; of several on the
+ *  same layer, the one that comes last in the region list.
+ */
+boost::shared_ptr<Region>
+Playlist::top_region_at_locked (framepos_t frame, bool unmuted_only)
+{
+	vector<boost::shared_ptr<Region> > covering;
+	boost::shared_ptr<Region> region;
 
-	 boost::shared_ptr<Region> region;
+	Glib::Threads::RWLock::ReaderLock il (region_index_lock);
+	region_index.find_covering (frame, covering);
 
-	 if (rlist->size()) {
-		 RegionSortByLayer cmp;
-		 rlist->sort (cmp);
-		 region = rlist->back();
-	 }
+	for (vector<boost::shared_ptr<Region> >::const_iterator i = covering.begin(); i != covering.end(); ++i) {
+		if (unmuted_only && (*i)->muted()) {
+			continue;
+		}
+		if (!region || (*i)->layer() >= region->layer()) {
+			region = *i;
+		}
+	}
 
-	 return region;
- }
+	return region;
+}
 
 boost::shared_ptr<RegionList>
 Playlist::find_regions_at (framepos_t frame)
@@ -1888,11 +1935,8 @@ Playlist::find_regions_at (framepos_t frame)
 
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-		if ((*i)->covers (frame)) {
-			rlist->push_back (*i);
-		}
-	}
+	Glib::Threads::RWLock::ReaderLock il (region_index_lock);
+	region_index.find_covering (frame, *rlist);
 
 	return rlist;
 }
@@ -1903,11 +1947,8 @@ Playlist::regions_with_start_within (Evoral::Range<framepos_t> range)
 	RegionReadLock rlock (this);
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-		if ((*i)->first_frame() >= range.from && (*i)->first_frame() <= range.to) {
-			rlist->push_back (*i);
-		}
-	}
+	Glib::Threads::RWLock::ReaderLock il (region_index_lock);
+	region_index.find_starting_within (range.from, range.to, *rlist);
 
 	return rlist;
 }
@@ -1943,15 +1984,23 @@ Playlist::regions_touched_locked (framepos_t start, framepos_t end)
 {
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-		if ((*i)->coverage (start, end) != Evoral::OverlapNone) {
-			rlist->push_back (*i);
-		}
-	}
+	Glib::Threads::RWLock::ReaderLock il (region_index_lock);
+	region_index.find_overlapping (start, end, *rlist);
 
 	return rlist;
 }
 
+/** Caller must hold lock.
+ *  Append the regions which have some part within [@param start, @param end]
+ *  to @param result, in order of position, without allocating anything else.
+ */
+void
+Playlist::regions_touched_locked (framepos_t start, framepos_t end, vector<boost::shared_ptr<Region> >& result) const
+{
+	Glib::Threads::RWLock::ReaderLock il (region_index_lock);
+	region_index.find_overlapping (start, end, result);
+}
+
 framepos_t
 Playlist::find_next_transient (framepos_t from, int dir)
 {
@@ -2355,6 +2404,19 @@ Playlist::n_regions() const
 	return regions.size();
 }
 
+/** @return the first region in the playlist's list (not necessarily the
+ *  earliest), or 0 if there are none.
+ */
+boost::shared_ptr<Region>
+Playlist::first_region () const
+{
+	RegionReadLock rlock (const_cast<Playlist *>(this));
+	if (regions.empty ()) {
+		return boost::shared_ptr<Region> ();
+	}
+	return regions.front ();
+}
+
 /** @return true if the all_regions list is empty, ie this playlist
  *  has never had a region added to it.
  */
@@ -2498,6 +2560,8 @@ Playlist::relayer ()
 		return;
 	}
 
+	state_changed ();
+
 	/* Build up a new list of regions on each layer, stored in a set of lists
 	   each of which represent some period of time on some layer.  The idea
 	   is to avoid having to search the entire region list to establish whether
@@ -2802,6 +2866,7 @@ void
 Playlist::set_frozen (bool yn)
 {
 	_frozen = yn;
+	state_changed ();
 }
 
 void
@@ -2964,13 +3029,9 @@ bool
 Playlist::has_region_at (framepos_t const p) const
 {
 	RegionReadLock (const_cast<Playlist *> (this));
+	Glib::Threads::RWLock::ReaderLock il (region_index_lock);
 
-	RegionList::const_iterator i = regions.begin ();
-	while (i != regions.end() && !(*i)->covers (p)) {
-		++i;
-	}
-
-	return (i != regions.end());
+	return region_index.any_covering (p);
 }
 
 /** Look from a session frame time and find the start time of the next region
@@ -3121,6 +3182,7 @@ Playlist::combine (const RegionList& r)
 	add_region (compound_region, earliest_position);
 
 	_combine_ops++;
+	state_changed ();
 
 	thaw ();
 
@@ -3318,6 +3380,7 @@ void
 Playlist::set_orig_track_id (const PBD::ID& id)
 {
 	_orig_track_id = id;
+	state_changed ();
 }
 
 /** Take a list of ranges, coalesce any that can be coalesced, then call
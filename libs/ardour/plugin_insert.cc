@@ -37,6 +37,7 @@
 #include "ardour/plugin.h"
 #include "ardour/plugin_insert.h"
 #include "ardour/port.h"
+#include "ardour/rc_configuration.h"
 
 #ifdef LV2_SUPPORT
 #include "ardour/lv2_plugin.h"
@@ -1132,10 +1133,21 @@ PluginInsert::automation_run (BufferSet& bufs, framepos_t start, framepos_t end,
 		return;
 	}
 
+	/* with an automation interval, only split the cycle on multiples of
+	 * the interval: events in between take effect at the next boundary,
+	 * up to interval - 1 samples late. This only rounds the split points;
+	 * the plugin is still run once for every section that has automation.
+	 */
+	const framecnt_t interval = Config->get_plugin_automation_interval ();
+
 	while (nframes) {
 
 		framecnt_t cnt = min (((framecnt_t) ceil (next_event.when) - start), (framecnt_t) nframes);
 
+		if (interval > 1) {
+			cnt = min (((offset + cnt + interval - 1) / interval) * interval - offset, (framecnt_t) nframes);
+		}
+
 		connect_and_run (bufs, start, start + cnt, speed, cnt, offset, true); // XXX (start + cnt) * speed
 
 		nframes -= cnt;
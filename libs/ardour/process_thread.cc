@@ -50,12 +50,19 @@ ProcessThread::~ProcessThread ()
 {
 }
 
+/** @param numa_local true to move the buffers to the NUMA node that this
+ *  thread is bound to.
+ */
 void
-ProcessThread::get_buffers ()
+ProcessThread::get_buffers (bool numa_local)
 {
         ThreadBuffers* tb = BufferManager::get_thread_buffers ();
 
         assert (tb);
+
+        if (numa_local) {
+                BufferManager::localize_thread_buffers (tb);
+        }
         _private_thread_buffers.set (tb);
 }
 
@@ -1388,6 +1388,22 @@ Region::send_change (const PropertyChange& what_changed)
 		} catch (...) {
 			/* no shared_ptr available, relax; */
 		}
+
+	} else if (what_changed.contains (Properties::position) || what_changed.contains (Properties::length)) {
+
+		/* PropertyChanged is deferred, but our playlist's region index
+		   must follow our bounds now.
+		*/
+
+		boost::shared_ptr<Playlist> pl (_playlist.lock ());
+
+		if (pl) {
+			try {
+				pl->reindex_region (shared_from_this ());
+			} catch (...) {
+				/* no shared_ptr available, relax; */
+			}
+		}
 	}
 }
 
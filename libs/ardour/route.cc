@@ -453,7 +453,9 @@ Route::process_output_buffers (BufferSet& bufs,
 					_initial_delay + latency, longest_session_latency - latency);
 		}
 
+		(*i)->dsp_timing ().start ();
 		(*i)->run (bufs, start_frame - latency, end_frame - latency, speed, nframes, *i != _processors.back());
+		(*i)->dsp_timing ().update ();
 		bufs.set_count ((*i)->output_streams());
 
 		if ((*i)->active ()) {
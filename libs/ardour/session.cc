@@ -230,6 +230,7 @@ Session::Session (AudioEngine &eng,
 	, _current_snapshot_name (snapshot_name)
 	, state_tree (0)
 	, state_was_pending (false)
+	, _pending_state_is_journal (false)
 	, _state_of_the_state (StateOfTheState(CannotSave|InitialConnecting|Loading))
 	, _suspend_save (0)
 	, _save_queued (false)
@@ -1470,6 +1471,8 @@ Session::hookup_io ()
 
 	/* Tell all IO objects to connect themselves together */
 
+	gint64 const connect_start = g_get_monotonic_time ();
+
 	IO::enable_connecting ();
 
 	/* Now tell all "floating" ports to connect to whatever
@@ -1482,6 +1485,8 @@ Session::hookup_io ()
 
 	IOConnectionsComplete (); /* EMIT SIGNAL */
 
+	info << string_compose (_("Session: made connections in %1 ms"), (g_get_monotonic_time () - connect_start) / 1000) << endmsg;
+
 	_state_of_the_state = StateOfTheState (_state_of_the_state & ~InitialConnecting);
 
 	/* now handle the whole enchilada as if it was one
@@ -6553,6 +6558,53 @@ Session::unknown_processors () const
 	return p;
 }
 
+namespace {
+struct ProcessorCost {
+	ProcessorCost (double c, boost::shared_ptr<Processor> p) : cost (c), processor (p) {}
+	bool operator< (ProcessorCost const & other) const { return cost > other.cost; }
+	double cost;
+	boost::shared_ptr<Processor> processor;
+};
+}
+
+vector<boost::shared_ptr<Processor> >
+Session::most_expensive_processors (uint32_t n) const
+{
+	vector<ProcessorCost> costs;
+
+	boost::shared_ptr<RouteList> r = routes.reader ();
+	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+		boost::shared_ptr<Processor> p;
+		for (uint32_t k = 0; (p = (*i)->nth_processor (k)); ++k) {
+			PBD::DurationStats stats;
+			if (p->get_dsp_stats (stats)) {
+				costs.push_back (ProcessorCost (stats.avg_usecs (), p));
+			}
+		}
+	}
+
+	n = min ((size_t) n, costs.size ());
+	partial_sort (costs.begin(), costs.begin() + n, costs.end());
+
+	vector<boost::shared_ptr<Processor> > ret;
+	for (uint32_t k = 0; k < n; ++k) {
+		ret.push_back (costs[k].processor);
+	}
+	return ret;
+}
+
+void
+Session::reset_dsp_stats ()
+{
+	boost::shared_ptr<RouteList> r = routes.reader ();
+	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+		boost::shared_ptr<Processor> p;
+		for (uint32_t k = 0; (p = (*i)->nth_processor (k)); ++k) {
+			p->reset_dsp_stats ();
+		}
+	}
+}
+
 void
 Session::update_latency (bool playback)
 {
@@ -324,8 +324,12 @@ get_id_sorted_playlists (const List& playlists, IDSortedList& id_sorted_playlist
 
 } // anonymous namespace
 
+/** @param only_changed true to save only playlists which have changed
+ *  since mark_saved(); others are saved as a SavedPlaylist node with just
+ *  their ID, to be taken from the state file that was saved then.
+ */
 void
-SessionPlaylists::add_state (XMLNode* node, bool full_state)
+SessionPlaylists::add_state (XMLNode* node, bool full_state, bool only_changed)
 {
 	XMLNode* child = node->add_child ("Playlists");
 
@@ -334,7 +338,9 @@ SessionPlaylists::add_state (XMLNode* node, bool full_state)
 
 	for (IDSortedList::iterator i = id_sorted_playlists.begin (); i != id_sorted_playlists.end (); ++i) {
 		if (!(*i)->hidden ()) {
-			if (full_state) {
+			if (only_changed && !changed_since_saved (*i)) {
+				child->add_child (X_("SavedPlaylist"))->add_property (X_("id"), (*i)->id().to_s());
+			} else if (full_state) {
 				child->add_child_nocopy ((*i)->get_state ());
 			} else {
 				child->add_child_nocopy ((*i)->get_template ());
@@ -351,7 +357,9 @@ SessionPlaylists::add_state (XMLNode* node, bool full_state)
 	     i != id_sorted_unused_playlists.end (); ++i) {
 		if (!(*i)->hidden()) {
 			if (!(*i)->empty()) {
-				if (full_state) {
+				if (only_changed && !changed_since_saved (*i)) {
+					child->add_child (X_("SavedPlaylist"))->add_property (X_("id"), (*i)->id().to_s());
+				} else if (full_state) {
 					child->add_child_nocopy ((*i)->get_state());
 				} else {
 					child->add_child_nocopy ((*i)->get_template());
@@ -361,6 +369,61 @@ SessionPlaylists::add_state (XMLNode* node, bool full_state)
 	}
 }
 
+/** Remember the state of all playlists, as of a state file that has
+ *  just been written.
+ */
+void
+SessionPlaylists::mark_saved ()
+{
+	Glib::Threads::Mutex::Lock lm (lock);
+
+	saved_generations.clear ();
+
+	for (List::iterator i = playlists.begin(); i != playlists.end(); ++i) {
+		saved_generations[(*i)->id()] = (*i)->state_generation ();
+	}
+
+	for (List::iterator i = unused_playlists.begin(); i != unused_playlists.end(); ++i) {
+		saved_generations[(*i)->id()] = (*i)->state_generation ();
+	}
+}
+
+bool
+SessionPlaylists::changed_since_saved (boost::shared_ptr<Playlist> pl) const
+{
+	Generations::const_iterator g = saved_generations.find (pl->id());
+	return g == saved_generations.end() || g->second != pl->state_generation ();
+}
+
+/** Count the playlists that add_state() would save, and how many of those
+ *  have changed since mark_saved().
+ */
+void
+SessionPlaylists::count_changed_since_saved (uint32_t& changed, uint32_t& total) const
+{
+	Glib::Threads::Mutex::Lock lm (lock);
+
+	changed = total = 0;
+
+	for (List::const_iterator i = playlists.begin(); i != playlists.end(); ++i) {
+		if (!(*i)->hidden ()) {
+			++total;
+			if (changed_since_saved (*i)) {
+				++changed;
+			}
+		}
+	}
+
+	for (List::const_iterator i = unused_playlists.begin(); i != unused_playlists.end(); ++i) {
+		if (!(*i)->hidden () && !(*i)->empty ()) {
+			++total;
+			if (changed_since_saved (*i)) {
+				++changed;
+			}
+		}
+	}
+}
+
 /** @return true for `stop cleanup', otherwise false */
 bool
 SessionPlaylists::maybe_delete_unused (boost::function<int(boost::shared_ptr<Playlist>)> ask)
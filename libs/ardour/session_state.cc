@@ -57,12 +57,15 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <sndfile.h>
+
 #include "midi++/mmc.h"
 #include "midi++/port.h"
 
 #include "evoral/SMF.hpp"
 
 #include "pbd/basename.h"
+#include "pbd/cpus.h"
 #include "pbd/debug.h"
 #include "pbd/enumwriter.h"
 #include "pbd/error.h"
@@ -413,6 +416,9 @@ Session::session_loaded ()
 		save_state ("");
 		remove_pending_capture_state ();
 		state_was_pending = false;
+	} else {
+		/* playlists are as in the state file we loaded */
+		playlists->mark_saved ();
 	}
 
 	/* Now, finally, we can fill the playback buffers */
@@ -824,11 +830,35 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		mark_as_clean = false;
 	}
 
+	/* a proper save of the current snapshot is what later pending saves
+	 * can be written as a journal against, saving only what changed since.
+	 */
+	bool const journal_base = !pending && mark_as_clean && !template_only;
+	bool journal = false;
+
+	if (pending && snapshot_name.empty() && Config->get_incremental_safety_backups() && !_state_journal_base.empty()
+	    && Glib::file_test (Glib::build_filename (_session_dir->root_path(), _state_journal_base), Glib::FILE_TEST_EXISTS)) {
+		uint32_t changed;
+		uint32_t total;
+		playlists->count_changed_since_saved (changed, total);
+		/* once most have changed, a journal saves little */
+		journal = changed * 2 < total;
+	}
+
 	if (template_only) {
 		mark_as_clean = false;
 		tree.set_root (&get_template());
 	} else {
-		tree.set_root (&get_state());
+		if (journal_base) {
+			/* anything that changes from here on is newer than the file */
+			_state_journal_base.clear ();
+			playlists->mark_saved ();
+		}
+		tree.set_root (&state (true, journal));
+	}
+
+	if (journal) {
+		tree.root()->add_property (X_("journal-base"), _state_journal_base);
 	}
 
 	if (snapshot_name.empty()) {
@@ -886,6 +916,19 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		}
 	}
 
+	if (journal_base) {
+		_state_journal_base = Glib::path_get_basename (xml_path);
+		/* pending state can only be recovered against the state it was a
+		 * journal of, which has now been replaced (and superseded).
+		 */
+		if (_pending_state_is_journal) {
+			remove_pending_capture_state ();
+		}
+		_pending_state_is_journal = false;
+	} else if (pending) {
+		_pending_state_is_journal = journal;
+	}
+
 	if (!pending) {
 
 		save_history (snapshot_name);
@@ -977,6 +1020,14 @@ Session::load_state (string snapshot_name)
 		return -1;
 	}
 
+	if (state_was_pending && root.property (X_("journal-base"))) {
+		if (resolve_state_journal (*state_tree->root())) {
+			delete state_tree;
+			state_tree = 0;
+			return -1;
+		}
+	}
+
 	XMLProperty const * prop;
 
 	if ((prop = root.property ("version")) == 0) {
@@ -1013,11 +1064,86 @@ Session::load_state (string snapshot_name)
 		}
 	}
 
+	/* later pending saves may refer to the file we loaded, as long as
+	 * they will be read as the same version.
+	 */
+	if (!state_was_pending && Stateful::loading_state_version == CURRENT_SESSION_FILE_VERSION) {
+		_state_journal_base = Glib::path_get_basename (xmlpath);
+	} else {
+		_state_journal_base.clear ();
+	}
+
 	save_snapshot_name (snapshot_name);
 
 	return 0;
 }
 
+/** Pending state saved as a journal has a SavedPlaylist node, holding just
+ *  an ID, for each playlist which had not changed since the last proper
+ *  save. Replace them with the playlists' state from that save's file.
+ */
+int
+Session::resolve_state_journal (XMLNode& root)
+{
+	std::string const base_path = Glib::build_filename (_session_dir->root_path(), root.property (X_("journal-base"))->value());
+	char const * const sections[] = { X_("Playlists"), X_("UnusedPlaylists") };
+	XMLTree base;
+
+	if (!base.read (base_path)) {
+		error << string_compose (_("Could not read session file %1, which the pending state refers to"), base_path) << endmsg;
+		return -1;
+	}
+
+	std::map<std::string, XMLNode const *> saved;
+
+	for (size_t n = 0; n < sizeof (sections) / sizeof (sections[0]); ++n) {
+		XMLNode const * section = find_named_node (*base.root(), sections[n]);
+		if (!section) {
+			continue;
+		}
+		for (XMLNodeConstIterator i = section->children().begin(); i != section->children().end(); ++i) {
+			XMLProperty const * prop = (*i)->property (X_("id"));
+			if (prop) {
+				saved[prop->value()] = *i;
+			}
+		}
+	}
+
+	for (size_t n = 0; n < sizeof (sections) / sizeof (sections[0]); ++n) {
+		XMLNode const * section = find_named_node (root, sections[n]);
+		if (!section) {
+			continue;
+		}
+
+		XMLNode* resolved = new XMLNode (sections[n]);
+
+		for (XMLNodeConstIterator i = section->children().begin(); i != section->children().end(); ++i) {
+			if ((*i)->name() != X_("SavedPlaylist")) {
+				resolved->add_child_copy (**i);
+				continue;
+			}
+
+			XMLProperty const * prop = (*i)->property (X_("id"));
+			std::map<std::string, XMLNode const *>::const_iterator s = prop ? saved.find (prop->value()) : saved.end ();
+
+			if (s == saved.end ()) {
+				error << string_compose (_("Session file %1 has no playlist that the pending state refers to"), base_path) << endmsg;
+				delete resolved;
+				return -1;
+			}
+
+			resolved->add_child_copy (*s->second);
+		}
+
+		root.remove_nodes_and_delete (sections[n]);
+		root.add_child_nocopy (*resolved);
+	}
+
+	root.remove_property (X_("journal-base"));
+
+	return 0;
+}
+
 int
 Session::load_options (const XMLNode& node)
 {
@@ -1051,8 +1177,12 @@ Session::get_template()
 	return state(false);
 }
 
+/** @param only_changed_playlists true to save playlists which have not
+ *  changed since the last proper save as references to that state file.
+ *  Used by incremental pending saves, see resolve_state_journal().
+ */
 XMLNode&
-Session::state (bool full_state)
+Session::state (bool full_state, bool only_changed_playlists)
 {
 	LocaleGuard lg;
 	XMLNode* node = new XMLNode("Session");
@@ -1274,7 +1404,7 @@ Session::state (bool full_state)
 		}
 	}
 
-	playlists->add_state (node, full_state);
+	playlists->add_state (node, full_state, only_changed_playlists);
 
 	child = node->add_child ("RouteGroups");
 	for (list<RouteGroup *>::iterator i = _route_groups.begin(); i != _route_groups.end(); ++i) {
@@ -1343,6 +1473,9 @@ Session::set_state (const XMLNode& node, int version)
 	XMLNode* child;
 	XMLProperty const * prop;
 	int ret = -1;
+	/* how long each phase of loading took, in usecs */
+	gint64 phase_start;
+	gint64 sources_time, regions_time, playlists_time, routes_time;
 
 	_state_of_the_state = StateOfTheState (_state_of_the_state|CannotSave);
 
@@ -1440,6 +1573,8 @@ Session::set_state (const XMLNode& node, int version)
                 _speakers->set_state (*child, version);
         }
 
+	phase_start = g_get_monotonic_time ();
+
 	if ((child = find_named_node (node, "Sources")) == 0) {
 		error << _("Session: XML state has no sources section") << endmsg;
 		goto out;
@@ -1447,6 +1582,8 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	sources_time = g_get_monotonic_time () - phase_start;
+
 	if ((child = find_named_node (node, "TempoMap")) == 0) {
 		error << _("Session: XML state has no Tempo Map section") << endmsg;
 		goto out;
@@ -1467,6 +1604,8 @@ Session::set_state (const XMLNode& node, int version)
 		AudioFileSource::set_header_position_offset (_session_range_location->start());
 	}
 
+	phase_start = g_get_monotonic_time ();
+
 	if ((child = find_named_node (node, "Regions")) == 0) {
 		error << _("Session: XML state has no Regions section") << endmsg;
 		goto out;
@@ -1474,6 +1613,9 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	regions_time = g_get_monotonic_time () - phase_start;
+	phase_start = g_get_monotonic_time ();
+
 	if ((child = find_named_node (node, "Playlists")) == 0) {
 		error << _("Session: XML state has no playlists section") << endmsg;
 		goto out;
@@ -1493,6 +1635,8 @@ Session::set_state (const XMLNode& node, int version)
 		}
 	}
 
+	playlists_time = g_get_monotonic_time () - phase_start;
+
 	if (version >= 3000) {
 		if ((child = find_named_node (node, "Bundles")) == 0) {
 			warning << _("Session: XML state has no bundles section") << endmsg;
@@ -1518,6 +1662,8 @@ Session::set_state (const XMLNode& node, int version)
 		_vca_manager->set_state (*child, version);
 	}
 
+	phase_start = g_get_monotonic_time ();
+
 	if ((child = find_named_node (node, "Routes")) == 0) {
 		error << _("Session: XML state has no routes section") << endmsg;
 		goto out;
@@ -1525,6 +1671,12 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	routes_time = g_get_monotonic_time () - phase_start;
+
+	info << string_compose (_("Session: loaded sources in %1 ms, regions in %2 ms, playlists in %3 ms, tracks/busses in %4 ms"),
+	                        sources_time / 1000, regions_time / 1000, playlists_time / 1000, routes_time / 1000)
+	     << endmsg;
+
 	/* Now that we have Routes and masters loaded, connect them if appropriate */
 
 	Slavable::Assign (_vca_manager); /* EMIT SIGNAL */
@@ -2098,6 +2250,155 @@ Session::reset_write_sources (bool mark_write_complete, bool force)
 	}
 }
 
+namespace {
+
+/** Opens the audio files of a session's sources on several threads,
+ *  ahead of load_sources(), which then only has to announce them in order.
+ *  Only files that libsndfile can open are tried here, since opening a
+ *  source logs its errors and that must only be done by the loading thread.
+ *  Anything else, including sources that might need to ask the user
+ *  something, is left to load_sources(), which deals with it as usual.
+ */
+class ParallelSourceOpener
+{
+  public:
+	ParallelSourceOpener (Session& s, XMLNodeList const & nlist)
+		: session (s)
+		, search_path (s.source_search_path (DataType::AUDIO))
+		, next (0)
+	{
+		for (XMLNodeConstIterator i = nlist.begin(); i != nlist.end(); ++i) {
+			if (is_audio_file (**i)) {
+				index[*i] = nodes.size ();
+				nodes.push_back (*i);
+			}
+		}
+		sources.resize (nodes.size ());
+	}
+
+	void run ()
+	{
+		/* opening files is mostly waiting for the disk, see also SourceFactory::init () */
+		uint32_t const n_threads = min ((uint32_t) nodes.size (), max ((uint32_t) 2, min ((uint32_t) 8, hardware_concurrency ())));
+		vector<Glib::Threads::Thread*> threads;
+
+		for (uint32_t n = 1; n < n_threads; ++n) {
+			try {
+				threads.push_back (Glib::Threads::Thread::create (sigc::mem_fun (*this, &ParallelSourceOpener::work)));
+			} catch (Glib::Threads::ThreadError& err) {
+				break;
+			}
+		}
+
+		work ();
+
+		for (vector<Glib::Threads::Thread*>::iterator t = threads.begin(); t != threads.end(); ++t) {
+			(*t)->join ();
+		}
+	}
+
+	boost::shared_ptr<Source> source (XMLNode const * node) const
+	{
+		map<XMLNode const *, size_t>::const_iterator i = index.find (node);
+		if (i == index.end ()) {
+			return boost::shared_ptr<Source> ();
+		}
+		return sources[i->second];
+	}
+
+	size_t size () const { return nodes.size (); }
+
+  private:
+	static bool is_audio_file (XMLNode const & node)
+	{
+		if (node.name() != X_("Source") || node.property (X_("playlist"))) {
+			return false;
+		}
+		XMLProperty const * prop = node.property (X_("type"));
+		return !prop || DataType (prop->value()) == DataType::AUDIO;
+	}
+
+	/* @return the file that FileSource::find() will use for @param node,
+	 * or an empty string if there is none, or if there is more than one:
+	 * then find() asks the user which file to use, and that can only be
+	 * done by the thread loading the session.
+	 */
+	string file_path (XMLNode const & node) const
+	{
+		XMLProperty const * name = node.property (X_("name"));
+		XMLProperty const * origin = node.property (X_("origin"));
+		string path;
+
+		if (name && Glib::path_is_absolute (name->value())) {
+			path = name->value();
+		} else if (origin && Glib::path_is_absolute (origin->value())) {
+			path = origin->value();
+		} else if (name) {
+			for (vector<string>::const_iterator d = search_path.begin(); d != search_path.end(); ++d) {
+				string const p = Glib::build_filename (*d, name->value());
+				if (Glib::file_test (p, Glib::FILE_TEST_EXISTS|Glib::FILE_TEST_IS_REGULAR)) {
+					if (!path.empty ()) {
+						return string ();
+					}
+					path = p;
+				}
+			}
+		}
+
+		if (!path.empty () && !Glib::file_test (path, Glib::FILE_TEST_EXISTS|Glib::FILE_TEST_IS_REGULAR)) {
+			return string ();
+		}
+
+		return path;
+	}
+
+	/* check, without logging anything, that the source's channel of the
+	 * file can be opened, as SndFileSource::open() will.
+	 */
+	static bool can_open (string const & path, XMLNode const & node)
+	{
+		XMLProperty const * prop = node.property (X_("channel"));
+		int const channel = prop ? atoi (prop->value().c_str()) : 0;
+		SF_INFO info;
+
+		info.format = 0;
+		SNDFILE* sf = sf_open (path.c_str(), SFM_READ, &info);
+
+		if (!sf) {
+			return false;
+		}
+
+		sf_close (sf);
+		return channel >= 0 && channel < info.channels;
+	}
+
+	void work ()
+	{
+		int n;
+		while ((n = g_atomic_int_add (&next, 1)) < (int) nodes.size ()) {
+			string const path = file_path (*nodes[n]);
+			if (path.empty () || !can_open (path, *nodes[n])) {
+				/* load_sources() will try, and tell the user if it fails */
+				continue;
+			}
+			try {
+				sources[n] = SourceFactory::open_audio_file (session, *nodes[n]);
+			} catch (...) {
+				/* the file went away since can_open() */
+			}
+		}
+	}
+
+	Session&                          session;
+	vector<string>                    search_path;
+	vector<XMLNode*>                  nodes;
+	map<XMLNode const *, size_t>      index;
+	vector<boost::shared_ptr<Source> > sources;
+	gint                              next;
+};
+
+}
+
 int
 Session::load_sources (const XMLNode& node)
 {
@@ -2112,11 +2413,34 @@ Session::load_sources (const XMLNode& node)
 
 	set_dirty();
 
+	ParallelSourceOpener opener (*this, nlist);
+
+	if (Config->get_parallel_session_load () && Stateful::loading_state_version >= 3000 && opener.size () > 1) {
+#ifdef PLATFORM_WINDOWS
+		// do not show "insert media" popups (files embedded from removable media).
+		int old_mode = SetErrorMode(SEM_FAILCRITICALERRORS);
+#endif
+		opener.run ();
+#ifdef PLATFORM_WINDOWS
+		SetErrorMode(old_mode);
+#endif
+	}
+
 	for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
 #ifdef PLATFORM_WINDOWS
 		int old_mode = 0;
 #endif
 
+		boost::shared_ptr<Source> opened = opener.source (*niter);
+
+		if (opened) {
+			/* note: do peak building in another thread when loading session state */
+			if ((source = SourceFactory::announce (opened, true)) == 0) {
+				error << _("Session: cannot create Source from XML description.") << endmsg;
+			}
+			continue;
+		}
+
           retry:
 		try {
 #ifdef PLATFORM_WINDOWS
@@ -3895,6 +4219,11 @@ Session::config_changed (std::string p, bool ours)
 	} else if (p == "raid-path") {
 
 		setup_raid_path (config.get_raid_path());
+		_butler->clear_device_cache ();
+
+	} else if (p == "audio-search-path" || p == "midi-search-path") {
+
+		_butler->clear_device_cache ();
 
 	} else if (p == "timecode-format") {
 
@@ -4337,6 +4666,8 @@ Session::rename (const std::string& new_name)
 		}
 	}
 
+	_butler->clear_device_cache ();
+
 	set_snapshot_name (new_name);
 	_name = new_name;
 
@@ -4929,6 +5260,7 @@ Session::save_as (SaveAs& saveas)
 			/* ensure that all existing tracks reset their current capture source paths
 			 */
 			reset_write_sources (true, true);
+			_butler->clear_device_cache ();
 
 			/* the copying above was based on actually discovering files, not just iterating over the sources list.
 			   But if we're going to switch to the new (copied) session, we need to change the paths in the sources also.
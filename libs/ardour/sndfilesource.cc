@@ -29,6 +29,10 @@
 
 #include <sys/stat.h>
 
+#ifndef PLATFORM_WINDOWS
+#include <unistd.h>
+#endif
+
 #include <glib.h>
 #include "pbd/gstdio_compat.h"
 
@@ -36,6 +40,7 @@
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
 
+#include "ardour/async_reader.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/sndfilesource.h"
 #include "ardour/sndfile_helpers.h"
@@ -324,6 +329,10 @@ SndFileSource::init_sndfile ()
 
 	memset (&_info, 0, sizeof(_info));
 
+	_fd = -1;
+	_data_offset = 0;
+	_bytes_per_frame = 0;
+
 	if (destructive()) {
 		xfade_buf = new Sample[xfade_frames];
 		_timeline_position = header_position_offset;
@@ -336,6 +345,13 @@ void
 SndFileSource::close ()
 {
 	if (_sndfile) {
+		{
+			/* prefetch() must not hand the descriptor to the reader
+			 * once sf_close() has closed it.
+			 */
+			Glib::Threads::Mutex::Lock lm (_lock);
+			_fd = -1;
+		}
 		sf_close (_sndfile);
 		_sndfile = 0;
 		file_closed ();
@@ -402,6 +418,8 @@ SndFileSource::open ()
 
 	_length = _info.frames;
 
+	setup_prefetch (fd);
+
 #ifdef HAVE_RF64_RIFF
 	if (_file_is_new && _length == 0 && writable()) {
 		if (_flags & RF64_RIFF) {
@@ -583,6 +601,87 @@ SndFileSource::read_unlocked (Sample *dst, framepos_t start, framecnt_t cnt) con
 	return nread;
 }
 
+/** Work out where the sample data for frame 0 lives in the file, so that
+ *  prefetch() can hand byte ranges to an AsyncReader. This is only possible
+ *  for uncompressed formats; files we are writing to are left alone, since
+ *  what they hold was just written and is still in the page cache.
+ */
+void
+SndFileSource::setup_prefetch (int fd)
+{
+	_fd = -1;
+
+#ifndef PLATFORM_WINDOWS
+	if (writable()) {
+		return;
+	}
+
+	switch (_info.format & SF_FORMAT_TYPEMASK) {
+	case SF_FORMAT_WAV:
+	case SF_FORMAT_WAVEX:
+	case SF_FORMAT_RF64:
+	case SF_FORMAT_W64:
+	case SF_FORMAT_CAF:
+	case SF_FORMAT_AIFF:
+		break;
+	default:
+		return;
+	}
+
+	uint32_t sample_bytes;
+
+	switch (_info.format & SF_FORMAT_SUBMASK) {
+	case SF_FORMAT_PCM_16:
+		sample_bytes = 2;
+		break;
+	case SF_FORMAT_PCM_24:
+		sample_bytes = 3;
+		break;
+	case SF_FORMAT_PCM_32:
+	case SF_FORMAT_FLOAT:
+		sample_bytes = 4;
+		break;
+	case SF_FORMAT_DOUBLE:
+		sample_bytes = 8;
+		break;
+	default:
+		return;
+	}
+
+	/* libsndfile seeks the descriptor to the start of the data chunk for this */
+
+	if (sf_seek (_sndfile, 0, SEEK_SET|SFM_READ) != 0) {
+		return;
+	}
+
+	off_t const offset = lseek (fd, 0, SEEK_CUR);
+
+	if (offset <= 0) {
+		return;
+	}
+
+	_fd = fd;
+	_data_offset = offset;
+	_bytes_per_frame = sample_bytes * _info.channels;
+#endif
+}
+
+void
+SndFileSource::prefetch (framepos_t start, framecnt_t cnt, AsyncReader& reader) const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	if (_fd < 0 || start >= _length || cnt <= 0) {
+		return;
+	}
+
+	if (start + cnt > _length) {
+		cnt = _length - start;
+	}
+
+	reader.add (_fd, _data_offset + (off_t) start * _bytes_per_frame, (size_t) cnt * _bytes_per_frame);
+}
+
 framecnt_t
 SndFileSource::write_unlocked (Sample *data, framecnt_t cnt)
 {
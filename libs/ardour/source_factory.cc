@@ -24,6 +24,7 @@
 
 #include "pbd/error.h"
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 #include "pbd/pthread_utils.h"
 #include "pbd/stacktrace.h"
 
@@ -32,6 +33,8 @@
 #include "ardour/boost_debug.h"
 #include "ardour/midi_playlist.h"
 #include "ardour/midi_playlist_source.h"
+#include "ardour/mmap_file_source.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/source.h"
 #include "ardour/source_factory.h"
 #include "ardour/sndfilesource.h"
@@ -55,7 +58,11 @@ Glib::Threads::Cond SourceFactory::PeaksToBuild;
 Glib::Threads::Mutex SourceFactory::peak_building_lock;
 std::list<boost::weak_ptr<AudioSource> > SourceFactory::files_with_peaks;
 
+PBD::Signal2<void,uint32_t,uint32_t> SourceFactory::PeakBuildingProgress;
+
 static int active_threads = 0;
+static uint32_t peaks_done = 0;
+static uint32_t peaks_queued = 0;
 
 static void
 peak_thread_work ()
@@ -80,14 +87,21 @@ peak_thread_work ()
 		++active_threads;
 		SourceFactory::peak_building_lock.unlock ();
 
-		if (!as) {
-			continue;
+		if (as) {
+			as->setup_peakfile ();
 		}
 
-		as->setup_peakfile ();
 		SourceFactory::peak_building_lock.lock ();
 		--active_threads;
+		uint32_t const done = ++peaks_done;
+		uint32_t const queued = peaks_queued;
+		if (active_threads == 0 && SourceFactory::files_with_peaks.empty()) {
+			/* start counting afresh with the next batch */
+			peaks_done = peaks_queued = 0;
+		}
 		SourceFactory::peak_building_lock.unlock ();
+
+		SourceFactory::PeakBuildingProgress (done, queued); /* EMIT SIGNAL */
 	}
 }
 
@@ -99,10 +113,36 @@ SourceFactory::peak_work_queue_length ()
 	return SourceFactory::files_with_peaks.size () + active_threads;
 }
 
+void
+SourceFactory::prioritize_peakfile (boost::shared_ptr<AudioSource> as)
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+
+	for (std::list<boost::weak_ptr<AudioSource> >::iterator i = files_with_peaks.begin(); i != files_with_peaks.end(); ++i) {
+		if (i->lock() == as) {
+			if (i != files_with_peaks.begin()) {
+				files_with_peaks.splice (files_with_peaks.begin(), files_with_peaks, i);
+			}
+			break;
+		}
+	}
+}
+
 void
 SourceFactory::init ()
 {
-	for (int n = 0; n < 2; ++n) {
+	/* Building peaks is as much I/O as it is CPU work, so more threads
+	 * than cores can help keep the disk(s) busy; but not so many that they
+	 * all compete for the same disk with the butler.
+	 */
+
+	uint32_t n_threads = Config->get_peak_building_threads ();
+
+	if (n_threads == 0) {
+		n_threads = max ((uint32_t) 2, min ((uint32_t) 8, hardware_concurrency ()));
+	}
+
+	for (uint32_t n = 0; n < n_threads; ++n) {
 		Glib::Threads::Thread::create (sigc::ptr_fun (::peak_thread_work));
 	}
 }
@@ -119,7 +159,8 @@ SourceFactory::setup_peakfile (boost::shared_ptr<Source> s, bool async)
 
 			Glib::Threads::Mutex::Lock lm (peak_building_lock);
 			files_with_peaks.push_back (boost::weak_ptr<AudioSource> (as));
-			PeaksToBuild.broadcast ();
+			++peaks_queued;
+			PeaksToBuild.signal ();
 
 		} else {
 
@@ -133,6 +174,56 @@ SourceFactory::setup_peakfile (boost::shared_ptr<Source> s, bool async)
 	return 0;
 }
 
+boost::shared_ptr<Source>
+SourceFactory::open_audio_file (Session& s, const XMLNode& node)
+{
+	if (Config->get_mmap_float_sources()) {
+		try {
+			Source* src = new MmapFileSource (s, node);
+			return boost::shared_ptr<Source> (src);
+		}
+
+		catch (failed_constructor& err) {
+			/* not a mono float file, use libsndfile */
+		}
+	}
+
+	try {
+		Source* src = new SndFileSource (s, node);
+#ifdef BOOST_SP_ENABLE_DEBUG_HOOKS
+		// boost_debug_shared_ptr_mark_interesting (src, "Source");
+#endif
+		return boost::shared_ptr<Source> (src);
+	}
+
+	catch (failed_constructor& err) {
+
+#ifdef HAVE_COREAUDIO
+
+		/* this is allowed to throw */
+
+		Source *src = new CoreAudioSource (s, node);
+#ifdef BOOST_SP_ENABLE_DEBUG_HOOKS
+		// boost_debug_shared_ptr_mark_interesting (src, "Source");
+#endif
+		return boost::shared_ptr<Source> (src);
+#else
+		throw; // rethrow
+#endif
+	}
+}
+
+boost::shared_ptr<Source>
+SourceFactory::announce (boost::shared_ptr<Source> ret, bool defer_peaks)
+{
+	if (setup_peakfile (ret, defer_peaks)) {
+		return boost::shared_ptr<Source>();
+	}
+	ret->check_for_analysis_data_on_disk ();
+	SourceCreated (ret);
+	return ret;
+}
+
 boost::shared_ptr<Source>
 SourceFactory::createSilent (Session& s, const XMLNode& node, framecnt_t nframes, float sr)
 {
@@ -180,44 +271,7 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 
 		} else {
 
-
-			try {
-				Source* src = new SndFileSource (s, node);
-#ifdef BOOST_SP_ENABLE_DEBUG_HOOKS
-				// boost_debug_shared_ptr_mark_interesting (src, "Source");
-#endif
-				boost::shared_ptr<Source> ret (src);
-				if (setup_peakfile (ret, defer_peaks)) {
-					return boost::shared_ptr<Source>();
-				}
-				ret->check_for_analysis_data_on_disk ();
-				SourceCreated (ret);
-				return ret;
-			}
-
-			catch (failed_constructor& err) {
-
-#ifdef HAVE_COREAUDIO
-
-				/* this is allowed to throw */
-
-				Source *src = new CoreAudioSource (s, node);
-#ifdef BOOST_SP_ENABLE_DEBUG_HOOKS
-				// boost_debug_shared_ptr_mark_interesting (src, "Source");
-#endif
-				boost::shared_ptr<Source> ret (src);
-
-				if (setup_peakfile (ret, defer_peaks)) {
-					return boost::shared_ptr<Source>();
-				}
-
-				ret->check_for_analysis_data_on_disk ();
-				SourceCreated (ret);
-				return ret;
-#else
-				throw; // rethrow
-#endif
-			}
+			return announce (open_audio_file (s, node), defer_peaks);
 		}
 	} else if (type == DataType::MIDI) {
 		boost::shared_ptr<SMFSource> src (new SMFSource (s, node));
@@ -242,6 +296,25 @@ SourceFactory::createExternal (DataType type, Session& s, const string& path,
 
 		if (!(flags & Destructive)) {
 
+			if (Config->get_mmap_float_sources()) {
+				try {
+					Source* src = new MmapFileSource (s, path, chn, flags);
+					boost::shared_ptr<Source> ret (src);
+					if (setup_peakfile (ret, defer_peaks)) {
+						return boost::shared_ptr<Source>();
+					}
+					ret->check_for_analysis_data_on_disk ();
+					if (announce) {
+						SourceCreated (ret);
+					}
+					return ret;
+				}
+
+				catch (failed_constructor& err) {
+					/* not a mono float file, use libsndfile */
+				}
+			}
+
 			try {
 
 				Source* src = new SndFileSource (s, path, chn, flags);
@@ -0,0 +1,345 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/* This file is compiled with -mavx512f and must only be called after
+ * FPU::has_avx512f() said so. Partial vectors at either end of a buffer
+ * are handled with masked loads and stores, so there are no scalar
+ * pre- or post-loops.
+ */
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "ardour/mix.h"
+
+/** @return a mask selecting the first @param n (< 16) lanes */
+static inline __mmask16
+tail_mask (uint32_t n)
+{
+	return (__mmask16) ((1U << n) - 1);
+}
+
+/** @return a mask selecting the lanes from @param p up to the next 64 byte boundary,
+ *  limited to @param n lanes, and the number of lanes selected in @param cnt
+ */
+static inline __mmask16
+head_mask (const float* p, uint32_t n, uint32_t& cnt)
+{
+	const uint32_t misalign = (((uintptr_t) p) & 63) / sizeof (float);
+	cnt = misalign ? 16 - misalign : 0;
+	if (cnt > n) {
+		cnt = n;
+	}
+	return tail_mask (cnt);
+}
+
+float
+x86_avx512_compute_peak (const float * buf, uint32_t nsamples, float current)
+{
+	__m512 vcurrent = _mm512_set1_ps (current);
+	__m512 vcurrent2 = vcurrent;
+	uint32_t cnt;
+	__mmask16 m = head_mask (buf, nsamples, cnt);
+
+	if (cnt) {
+		vcurrent = _mm512_max_ps (vcurrent, _mm512_abs_ps (_mm512_maskz_loadu_ps (m, buf)));
+		buf += cnt;
+		nsamples -= cnt;
+	}
+
+	while (nsamples >= 32) {
+		vcurrent  = _mm512_max_ps (vcurrent,  _mm512_abs_ps (_mm512_load_ps (buf)));
+		vcurrent2 = _mm512_max_ps (vcurrent2, _mm512_abs_ps (_mm512_load_ps (buf + 16)));
+		buf += 32;
+		nsamples -= 32;
+	}
+
+	if (nsamples >= 16) {
+		vcurrent = _mm512_max_ps (vcurrent, _mm512_abs_ps (_mm512_load_ps (buf)));
+		buf += 16;
+		nsamples -= 16;
+	}
+
+	if (nsamples) {
+		/* masked-out lanes load as 0, which never exceeds an absolute value */
+		vcurrent2 = _mm512_max_ps (vcurrent2, _mm512_abs_ps (_mm512_maskz_loadu_ps (tail_mask (nsamples), buf)));
+	}
+
+	current = _mm512_reduce_max_ps (_mm512_max_ps (vcurrent, vcurrent2));
+
+	_mm256_zeroupper ();
+
+	return current;
+}
+
+void
+x86_avx512_find_peaks (const float * buf, uint32_t nsamples, float *min, float *max)
+{
+	__m512 vmin = _mm512_set1_ps (*min);
+	__m512 vmax = _mm512_set1_ps (*max);
+	uint32_t cnt;
+	__mmask16 m = head_mask (buf, nsamples, cnt);
+
+	if (cnt) {
+		__m512 work = _mm512_maskz_loadu_ps (m, buf);
+		vmin = _mm512_mask_min_ps (vmin, m, vmin, work);
+		vmax = _mm512_mask_max_ps (vmax, m, vmax, work);
+		buf += cnt;
+		nsamples -= cnt;
+	}
+
+	while (nsamples >= 32) {
+		__m512 work0 = _mm512_load_ps (buf);
+		__m512 work1 = _mm512_load_ps (buf + 16);
+		vmin = _mm512_min_ps (vmin, _mm512_min_ps (work0, work1));
+		vmax = _mm512_max_ps (vmax, _mm512_max_ps (work0, work1));
+		buf += 32;
+		nsamples -= 32;
+	}
+
+	if (nsamples >= 16) {
+		__m512 work = _mm512_load_ps (buf);
+		vmin = _mm512_min_ps (vmin, work);
+		vmax = _mm512_max_ps (vmax, work);
+		buf += 16;
+		nsamples -= 16;
+	}
+
+	if (nsamples) {
+		m = tail_mask (nsamples);
+		__m512 work = _mm512_maskz_loadu_ps (m, buf);
+		vmin = _mm512_mask_min_ps (vmin, m, vmin, work);
+		vmax = _mm512_mask_max_ps (vmax, m, vmax, work);
+	}
+
+	*min = _mm512_reduce_min_ps (vmin);
+	*max = _mm512_reduce_max_ps (vmax);
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512_apply_gain_to_buffer (float * buf, uint32_t nframes, float gain)
+{
+	const __m512 vgain = _mm512_set1_ps (gain);
+	uint32_t cnt;
+	__mmask16 m = head_mask (buf, nframes, cnt);
+
+	if (cnt) {
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (vgain, _mm512_maskz_loadu_ps (m, buf)));
+		buf += cnt;
+		nframes -= cnt;
+	}
+
+	while (nframes >= 16) {
+		_mm512_store_ps (buf, _mm512_mul_ps (vgain, _mm512_load_ps (buf)));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (vgain, _mm512_maskz_loadu_ps (m, buf)));
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512_mix_buffers_with_gain (float * dst, const float * src, uint32_t nframes, float gain)
+{
+	const __m512 vgain = _mm512_set1_ps (gain);
+	uint32_t cnt;
+	__mmask16 m = head_mask (dst, nframes, cnt);
+
+	if (cnt) {
+		__m512 d = _mm512_add_ps (_mm512_maskz_loadu_ps (m, dst), _mm512_mul_ps (vgain, _mm512_maskz_loadu_ps (m, src)));
+		_mm512_mask_storeu_ps (dst, m, d);
+		dst += cnt;
+		src += cnt;
+		nframes -= cnt;
+	}
+
+	while (nframes >= 16) {
+		_mm512_store_ps (dst, _mm512_add_ps (_mm512_load_ps (dst), _mm512_mul_ps (vgain, _mm512_loadu_ps (src))));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		m = tail_mask (nframes);
+		__m512 d = _mm512_add_ps (_mm512_maskz_loadu_ps (m, dst), _mm512_mul_ps (vgain, _mm512_maskz_loadu_ps (m, src)));
+		_mm512_mask_storeu_ps (dst, m, d);
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512_mix_buffers_no_gain (float * dst, const float * src, uint32_t nframes)
+{
+	uint32_t cnt;
+	__mmask16 m = head_mask (dst, nframes, cnt);
+
+	if (cnt) {
+		_mm512_mask_storeu_ps (dst, m, _mm512_add_ps (_mm512_maskz_loadu_ps (m, dst), _mm512_maskz_loadu_ps (m, src)));
+		dst += cnt;
+		src += cnt;
+		nframes -= cnt;
+	}
+
+	while (nframes >= 16) {
+		_mm512_store_ps (dst, _mm512_add_ps (_mm512_load_ps (dst), _mm512_loadu_ps (src)));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_add_ps (_mm512_maskz_loadu_ps (m, dst), _mm512_maskz_loadu_ps (m, src)));
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512_copy_vector (float * dst, const float * src, uint32_t nframes)
+{
+	uint32_t cnt;
+	__mmask16 m = head_mask (dst, nframes, cnt);
+
+	if (cnt) {
+		_mm512_mask_storeu_ps (dst, m, _mm512_maskz_loadu_ps (m, src));
+		dst += cnt;
+		src += cnt;
+		nframes -= cnt;
+	}
+
+	while (nframes >= 16) {
+		_mm512_store_ps (dst, _mm512_loadu_ps (src));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		_mm512_mask_storeu_ps (dst, tail_mask (nframes), _mm512_maskz_loadu_ps (tail_mask (nframes), src));
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512_apply_gain_vector_to_buffer (float * buf, const float * gains, uint32_t nframes, float gain)
+{
+	const __m512 vgain = _mm512_set1_ps (gain);
+	uint32_t cnt;
+	__mmask16 m = head_mask (buf, nframes, cnt);
+
+	if (cnt) {
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, buf), _mm512_mul_ps (vgain, _mm512_maskz_loadu_ps (m, gains))));
+		buf += cnt;
+		gains += cnt;
+		nframes -= cnt;
+	}
+
+	while (nframes >= 16) {
+		_mm512_store_ps (buf, _mm512_mul_ps (_mm512_load_ps (buf), _mm512_mul_ps (vgain, _mm512_loadu_ps (gains))));
+		buf += 16;
+		gains += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, buf), _mm512_mul_ps (vgain, _mm512_maskz_loadu_ps (m, gains))));
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512_mix_buffers_with_gain_vector (float * dst, const float * src, const float * gains, uint32_t nframes)
+{
+	uint32_t cnt;
+	__mmask16 m = head_mask (dst, nframes, cnt);
+
+	if (cnt) {
+		__m512 d = _mm512_add_ps (_mm512_maskz_loadu_ps (m, dst), _mm512_mul_ps (_mm512_maskz_loadu_ps (m, src), _mm512_maskz_loadu_ps (m, gains)));
+		_mm512_mask_storeu_ps (dst, m, d);
+		dst += cnt;
+		src += cnt;
+		gains += cnt;
+		nframes -= cnt;
+	}
+
+	while (nframes >= 16) {
+		_mm512_store_ps (dst, _mm512_add_ps (_mm512_load_ps (dst), _mm512_mul_ps (_mm512_loadu_ps (src), _mm512_loadu_ps (gains))));
+		dst += 16;
+		src += 16;
+		gains += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		m = tail_mask (nframes);
+		__m512 d = _mm512_add_ps (_mm512_maskz_loadu_ps (m, dst), _mm512_mul_ps (_mm512_maskz_loadu_ps (m, src), _mm512_maskz_loadu_ps (m, gains)));
+		_mm512_mask_storeu_ps (dst, m, d);
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512_crossfade_buffers (float * dst, const float * src, const float * gains, uint32_t nframes)
+{
+	/* dst * (1 - g) + src * g == dst + (src - dst) * g */
+	uint32_t cnt;
+	__mmask16 m = head_mask (dst, nframes, cnt);
+
+	if (cnt) {
+		__m512 d = _mm512_maskz_loadu_ps (m, dst);
+		d = _mm512_add_ps (d, _mm512_mul_ps (_mm512_sub_ps (_mm512_maskz_loadu_ps (m, src), d), _mm512_maskz_loadu_ps (m, gains)));
+		_mm512_mask_storeu_ps (dst, m, d);
+		dst += cnt;
+		src += cnt;
+		gains += cnt;
+		nframes -= cnt;
+	}
+
+	while (nframes >= 16) {
+		__m512 d = _mm512_load_ps (dst);
+		_mm512_store_ps (dst, _mm512_add_ps (d, _mm512_mul_ps (_mm512_sub_ps (_mm512_loadu_ps (src), d), _mm512_loadu_ps (gains))));
+		dst += 16;
+		src += 16;
+		gains += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		m = tail_mask (nframes);
+		__m512 d = _mm512_maskz_loadu_ps (m, dst);
+		d = _mm512_add_ps (d, _mm512_mul_ps (_mm512_sub_ps (_mm512_maskz_loadu_ps (m, src), d), _mm512_maskz_loadu_ps (m, gains)));
+		_mm512_mask_storeu_ps (dst, m, d);
+	}
+
+	_mm256_zeroupper ();
+}
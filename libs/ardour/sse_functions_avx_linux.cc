@@ -17,40 +17,378 @@
 
 */
 
+/* This file is compiled with -mavx and must only be called after
+ * FPU::has_avx() said so. Buffers need not be aligned; the loops below
+ * work on unaligned data up to the point where the (first) destination
+ * reaches 32 byte alignment, then use aligned stores.
+ */
+
+#include <immintrin.h>
+#include <stdint.h>
+
 #include "ardour/mix.h"
 
+#define IS_ALIGNED_TO(ptr, bytes) (((uintptr_t)ptr) % (bytes) == 0)
+
+/* horizontal reductions of all eight lanes */
+
+static inline float
+avx_hmax (__m256 x)
+{
+	__m256 t = _mm256_max_ps (x, _mm256_permute2f128_ps (x, x, 1));
+	t = _mm256_max_ps (t, _mm256_shuffle_ps (t, t, _MM_SHUFFLE (1, 0, 3, 2)));
+	t = _mm256_max_ps (t, _mm256_shuffle_ps (t, t, _MM_SHUFFLE (2, 3, 0, 1)));
+	return _mm_cvtss_f32 (_mm256_castps256_ps128 (t));
+}
+
+static inline float
+avx_hmin (__m256 x)
+{
+	__m256 t = _mm256_min_ps (x, _mm256_permute2f128_ps (x, x, 1));
+	t = _mm256_min_ps (t, _mm256_shuffle_ps (t, t, _MM_SHUFFLE (1, 0, 3, 2)));
+	t = _mm256_min_ps (t, _mm256_shuffle_ps (t, t, _MM_SHUFFLE (2, 3, 0, 1)));
+	return _mm_cvtss_f32 (_mm256_castps256_ps128 (t));
+}
+
 float
 x86_sse_avx_compute_peak (const float * buf, uint32_t nsamples, float current)
 {
-	return default_compute_peak (buf, nsamples, current);
+	const __m256 abs_mask = _mm256_castsi256_ps (_mm256_set1_epi32 (0x7fffffff));
+	__m256 vcurrent = _mm256_set1_ps (current);
+
+	/* leading unaligned samples */
+	while (!IS_ALIGNED_TO (buf, 32) && nsamples > 0) {
+		vcurrent = _mm256_max_ps (vcurrent, _mm256_and_ps (_mm256_set1_ps (*buf), abs_mask));
+		++buf;
+		--nsamples;
+	}
+
+	/* two independent accumulators to hide the latency of vmaxps */
+	__m256 vcurrent2 = vcurrent;
+
+	while (nsamples >= 16) {
+		vcurrent  = _mm256_max_ps (vcurrent,  _mm256_and_ps (_mm256_load_ps (buf),     abs_mask));
+		vcurrent2 = _mm256_max_ps (vcurrent2, _mm256_and_ps (_mm256_load_ps (buf + 8), abs_mask));
+		buf += 16;
+		nsamples -= 16;
+	}
+
+	vcurrent = _mm256_max_ps (vcurrent, vcurrent2);
+
+	if (nsamples >= 8) {
+		vcurrent = _mm256_max_ps (vcurrent, _mm256_and_ps (_mm256_load_ps (buf), abs_mask));
+		buf += 8;
+		nsamples -= 8;
+	}
+
+	while (nsamples > 0) {
+		vcurrent = _mm256_max_ps (vcurrent, _mm256_and_ps (_mm256_set1_ps (*buf), abs_mask));
+		++buf;
+		--nsamples;
+	}
+
+	current = avx_hmax (vcurrent);
+
+	/* zero upper 128 bit of 256 bit ymm register to avoid penalties using non-AVX instructions */
+	_mm256_zeroupper ();
+
+	return current;
+}
+
+void
+x86_sse_avx_find_peaks (const float * buf, uint32_t nsamples, float *min, float *max)
+{
+	__m256 vmin = _mm256_set1_ps (*min);
+	__m256 vmax = _mm256_set1_ps (*max);
+
+	while (!IS_ALIGNED_TO (buf, 32) && nsamples > 0) {
+		__m256 work = _mm256_set1_ps (*buf);
+		vmin = _mm256_min_ps (vmin, work);
+		vmax = _mm256_max_ps (vmax, work);
+		++buf;
+		--nsamples;
+	}
+
+	while (nsamples >= 16) {
+		__m256 work0 = _mm256_load_ps (buf);
+		__m256 work1 = _mm256_load_ps (buf + 8);
+		vmin = _mm256_min_ps (vmin, _mm256_min_ps (work0, work1));
+		vmax = _mm256_max_ps (vmax, _mm256_max_ps (work0, work1));
+		buf += 16;
+		nsamples -= 16;
+	}
+
+	if (nsamples >= 8) {
+		__m256 work = _mm256_load_ps (buf);
+		vmin = _mm256_min_ps (vmin, work);
+		vmax = _mm256_max_ps (vmax, work);
+		buf += 8;
+		nsamples -= 8;
+	}
+
+	while (nsamples > 0) {
+		__m256 work = _mm256_set1_ps (*buf);
+		vmin = _mm256_min_ps (vmin, work);
+		vmax = _mm256_max_ps (vmax, work);
+		++buf;
+		--nsamples;
+	}
+
+	*min = avx_hmin (vmin);
+	*max = avx_hmax (vmax);
+
+	_mm256_zeroupper ();
 }
 
 void
 x86_sse_avx_apply_gain_to_buffer (float * buf, uint32_t nframes, float gain)
 {
-	default_apply_gain_to_buffer (buf, nframes, gain);
+	const __m256 vgain = _mm256_set1_ps (gain);
+
+	while (!IS_ALIGNED_TO (buf, 32) && nframes > 0) {
+		*buf *= gain;
+		++buf;
+		--nframes;
+	}
+
+	while (nframes >= 16) {
+		_mm256_store_ps (buf,     _mm256_mul_ps (vgain, _mm256_load_ps (buf)));
+		_mm256_store_ps (buf + 8, _mm256_mul_ps (vgain, _mm256_load_ps (buf + 8)));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		_mm256_store_ps (buf, _mm256_mul_ps (vgain, _mm256_load_ps (buf)));
+		buf += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*buf *= gain;
+		++buf;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
 }
 
 void
 x86_sse_avx_mix_buffers_with_gain (float * dst, const float * src, uint32_t nframes, float gain)
 {
-	default_mix_buffers_with_gain (dst, src, nframes, gain);
+	const __m256 vgain = _mm256_set1_ps (gain);
+
+	while (!IS_ALIGNED_TO (dst, 32) && nframes > 0) {
+		*dst += *src * gain;
+		++dst;
+		++src;
+		--nframes;
+	}
+
+	/* src usually shares dst's alignment, but there is no guarantee */
+	if (IS_ALIGNED_TO (src, 32)) {
+		while (nframes >= 16) {
+			_mm256_store_ps (dst,     _mm256_add_ps (_mm256_load_ps (dst),     _mm256_mul_ps (vgain, _mm256_load_ps (src))));
+			_mm256_store_ps (dst + 8, _mm256_add_ps (_mm256_load_ps (dst + 8), _mm256_mul_ps (vgain, _mm256_load_ps (src + 8))));
+			dst += 16;
+			src += 16;
+			nframes -= 16;
+		}
+	} else {
+		while (nframes >= 16) {
+			_mm256_store_ps (dst,     _mm256_add_ps (_mm256_load_ps (dst),     _mm256_mul_ps (vgain, _mm256_loadu_ps (src))));
+			_mm256_store_ps (dst + 8, _mm256_add_ps (_mm256_load_ps (dst + 8), _mm256_mul_ps (vgain, _mm256_loadu_ps (src + 8))));
+			dst += 16;
+			src += 16;
+			nframes -= 16;
+		}
+	}
+
+	if (nframes >= 8) {
+		_mm256_store_ps (dst, _mm256_add_ps (_mm256_load_ps (dst), _mm256_mul_ps (vgain, _mm256_loadu_ps (src))));
+		dst += 8;
+		src += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*dst += *src * gain;
+		++dst;
+		++src;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
 }
 
 void
 x86_sse_avx_mix_buffers_no_gain (float * dst, const float * src, uint32_t nframes)
 {
-	default_mix_buffers_no_gain (dst, src, nframes);
+	while (!IS_ALIGNED_TO (dst, 32) && nframes > 0) {
+		*dst += *src;
+		++dst;
+		++src;
+		--nframes;
+	}
+
+	if (IS_ALIGNED_TO (src, 32)) {
+		while (nframes >= 16) {
+			_mm256_store_ps (dst,     _mm256_add_ps (_mm256_load_ps (dst),     _mm256_load_ps (src)));
+			_mm256_store_ps (dst + 8, _mm256_add_ps (_mm256_load_ps (dst + 8), _mm256_load_ps (src + 8)));
+			dst += 16;
+			src += 16;
+			nframes -= 16;
+		}
+	} else {
+		while (nframes >= 16) {
+			_mm256_store_ps (dst,     _mm256_add_ps (_mm256_load_ps (dst),     _mm256_loadu_ps (src)));
+			_mm256_store_ps (dst + 8, _mm256_add_ps (_mm256_load_ps (dst + 8), _mm256_loadu_ps (src + 8)));
+			dst += 16;
+			src += 16;
+			nframes -= 16;
+		}
+	}
+
+	if (nframes >= 8) {
+		_mm256_store_ps (dst, _mm256_add_ps (_mm256_load_ps (dst), _mm256_loadu_ps (src)));
+		dst += 8;
+		src += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*dst += *src;
+		++dst;
+		++src;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
 }
 
 void
 x86_sse_avx_copy_vector (float * dst, const float * src, uint32_t nframes)
 {
-	default_copy_vector (dst, src, nframes);
+	while (!IS_ALIGNED_TO (dst, 32) && nframes > 0) {
+		*dst++ = *src++;
+		--nframes;
+	}
+
+	while (nframes >= 16) {
+		_mm256_store_ps (dst,     _mm256_loadu_ps (src));
+		_mm256_store_ps (dst + 8, _mm256_loadu_ps (src + 8));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		_mm256_store_ps (dst, _mm256_loadu_ps (src));
+		dst += 8;
+		src += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*dst++ = *src++;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
 }
 
 void
-x86_sse_avx_find_peaks (const float * buf, uint32_t nsamples, float *min, float *max)
+x86_sse_avx_apply_gain_vector_to_buffer (float * buf, const float * gains, uint32_t nframes, float gain)
 {
-	default_find_peaks (buf, nsamples, min, max);
+	const __m256 vgain = _mm256_set1_ps (gain);
+
+	while (!IS_ALIGNED_TO (buf, 32) && nframes > 0) {
+		*buf++ *= *gains++ * gain;
+		--nframes;
+	}
+
+	/* gains come from a Curve's table, and rarely share buf's alignment */
+	while (nframes >= 16) {
+		_mm256_store_ps (buf,     _mm256_mul_ps (_mm256_load_ps (buf),     _mm256_mul_ps (vgain, _mm256_loadu_ps (gains))));
+		_mm256_store_ps (buf + 8, _mm256_mul_ps (_mm256_load_ps (buf + 8), _mm256_mul_ps (vgain, _mm256_loadu_ps (gains + 8))));
+		buf += 16;
+		gains += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		_mm256_store_ps (buf, _mm256_mul_ps (_mm256_load_ps (buf), _mm256_mul_ps (vgain, _mm256_loadu_ps (gains))));
+		buf += 8;
+		gains += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*buf++ *= *gains++ * gain;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_sse_avx_mix_buffers_with_gain_vector (float * dst, const float * src, const float * gains, uint32_t nframes)
+{
+	while (!IS_ALIGNED_TO (dst, 32) && nframes > 0) {
+		*dst++ += *src++ * *gains++;
+		--nframes;
+	}
+
+	while (nframes >= 16) {
+		_mm256_store_ps (dst,     _mm256_add_ps (_mm256_load_ps (dst),     _mm256_mul_ps (_mm256_loadu_ps (src),     _mm256_loadu_ps (gains))));
+		_mm256_store_ps (dst + 8, _mm256_add_ps (_mm256_load_ps (dst + 8), _mm256_mul_ps (_mm256_loadu_ps (src + 8), _mm256_loadu_ps (gains + 8))));
+		dst += 16;
+		src += 16;
+		gains += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		_mm256_store_ps (dst, _mm256_add_ps (_mm256_load_ps (dst), _mm256_mul_ps (_mm256_loadu_ps (src), _mm256_loadu_ps (gains))));
+		dst += 8;
+		src += 8;
+		gains += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*dst++ += *src++ * *gains++;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_sse_avx_crossfade_buffers (float * dst, const float * src, const float * gains, uint32_t nframes)
+{
+	/* dst * (1 - g) + src * g == dst + (src - dst) * g */
+
+	while (!IS_ALIGNED_TO (dst, 32) && nframes > 0) {
+		*dst += (*src++ - *dst) * *gains++;
+		++dst;
+		--nframes;
+	}
+
+	while (nframes >= 8) {
+		const __m256 d = _mm256_load_ps (dst);
+		_mm256_store_ps (dst, _mm256_add_ps (d, _mm256_mul_ps (_mm256_sub_ps (_mm256_loadu_ps (src), d), _mm256_loadu_ps (gains))));
+		dst += 8;
+		src += 8;
+		gains += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*dst += (*src++ - *dst) * *gains++;
+		++dst;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
 }
@@ -117,3 +117,63 @@ x86_sse_find_peaks(const ARDOUR::Sample* buf, ARDOUR::pframes_t nframes, float *
 
 
 
+
+/* per-sample gain kernels: neither buffer is assumed to be aligned */
+
+void
+x86_sse_apply_gain_vector_to_buffer(float* buf, const float* gains, uint32_t nframes, float gain)
+{
+	const __m128 vgain = _mm_set1_ps(gain);
+
+	while (nframes >= 8) {
+		_mm_storeu_ps(buf,     _mm_mul_ps(_mm_loadu_ps(buf),     _mm_mul_ps(vgain, _mm_loadu_ps(gains))));
+		_mm_storeu_ps(buf + 4, _mm_mul_ps(_mm_loadu_ps(buf + 4), _mm_mul_ps(vgain, _mm_loadu_ps(gains + 4))));
+		buf += 8;
+		gains += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*buf++ *= *gains++ * gain;
+		--nframes;
+	}
+}
+
+void
+x86_sse_mix_buffers_with_gain_vector(float* dst, const float* src, const float* gains, uint32_t nframes)
+{
+	while (nframes >= 8) {
+		_mm_storeu_ps(dst,     _mm_add_ps(_mm_loadu_ps(dst),     _mm_mul_ps(_mm_loadu_ps(src),     _mm_loadu_ps(gains))));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(_mm_loadu_ps(src + 4), _mm_loadu_ps(gains + 4))));
+		dst += 8;
+		src += 8;
+		gains += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*dst++ += *src++ * *gains++;
+		--nframes;
+	}
+}
+
+void
+x86_sse_crossfade_buffers(float* dst, const float* src, const float* gains, uint32_t nframes)
+{
+	/* dst * (1 - g) + src * g == dst + (src - dst) * g */
+
+	while (nframes >= 4) {
+		__m128 d = _mm_loadu_ps(dst);
+		_mm_storeu_ps(dst, _mm_add_ps(d, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(src), d), _mm_loadu_ps(gains))));
+		dst += 4;
+		src += 4;
+		gains += 4;
+		nframes -= 4;
+	}
+
+	while (nframes > 0) {
+		*dst += (*src++ - *dst) * *gains++;
+		++dst;
+		--nframes;
+	}
+}
@@ -0,0 +1,231 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include <glibmm/miscutils.h>
+#include <glibmm/timer.h>
+
+#include "pbd/compose.h"
+#include "pbd/xml++.h"
+
+#include "ardour/audio_track.h"
+#include "ardour/audiofilesource.h"
+#include "ardour/export_channel.h"
+#include "ardour/export_channel_configuration.h"
+#include "ardour/export_filename.h"
+#include "ardour/export_format_specification.h"
+#include "ardour/export_handler.h"
+#include "ardour/export_status.h"
+#include "ardour/export_timespan.h"
+#include "ardour/io.h"
+#include "ardour/playlist.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/region.h"
+#include "ardour/region_factory.h"
+#include "ardour/session.h"
+#include "ardour/sndfilesource.h"
+#include "ardour/source_factory.h"
+
+#include "export_timespans_test.h"
+#include "test_util.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (ExportTimespansTest);
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+/* the ranges that are exported; the gap between them is well inside the
+   export pre-roll, so with chaining enabled they are exported in one pass.
+*/
+static framepos_t const range_start[] = { 1000, 12000 };
+static framepos_t const range_end[]   = { 11000, 21000 };
+static int const n_ranges = 2;
+
+void
+ExportTimespansTest::setUp ()
+{
+	TestNeedingSession::setUp ();
+
+	list<boost::shared_ptr<AudioTrack> > tracks = _session->new_audio_track (1, 1, NULL, 1, "Test", PresentationInfo::max_order, Normal);
+	CPPUNIT_ASSERT_EQUAL (size_t (1), tracks.size ());
+	_track = tracks.front ();
+
+	/* Give the track a ramp, so that every exported sample is different */
+
+	std::string const test_wav_path = Glib::build_filename (new_test_output_dir ("export_timespans"), "ramp.wav");
+	boost::shared_ptr<Source> source = SourceFactory::createWritable (DataType::AUDIO, *_session, test_wav_path, false, get_test_sample_rate ());
+	boost::shared_ptr<SndFileSource> s = boost::dynamic_pointer_cast<SndFileSource> (source);
+	CPPUNIT_ASSERT (s);
+
+	framecnt_t const signal_length = 32768;
+	vector<Sample> ramp (signal_length);
+	for (framecnt_t i = 0; i < signal_length; ++i) {
+		ramp[i] = (i + 1) / (float) signal_length;
+	}
+	s->write (&ramp[0], signal_length);
+
+	PropertyList plist;
+	plist.add (Properties::start, 0);
+	plist.add (Properties::length, signal_length);
+	boost::shared_ptr<Region> region = RegionFactory::create (source, plist);
+	_track->playlist()->add_region (region, 0);
+}
+
+void
+ExportTimespansTest::tearDown ()
+{
+	_track.reset ();
+	Config->set_export_chain_timespans (true);
+
+	TestNeedingSession::tearDown ();
+}
+
+/** Export each of our ranges from the track's output to a float WAV in @param dir,
+ *  returning the files' paths in @param paths.
+ */
+void
+ExportTimespansTest::export_ranges (std::string const & dir, bool chain, vector<std::string> & paths)
+{
+	Config->set_export_chain_timespans (chain);
+
+	boost::shared_ptr<ExportHandler> handler = _session->get_export_handler ();
+	ExportChannelConfigPtr ccp = handler->add_channel_config ();
+	boost::shared_ptr<AudioGrapher::BroadcastInfo> b;
+
+	XMLTree tree;
+	tree.read_buffer (string_compose (
+"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+"<ExportFormatSpecification name=\"TEST-WAV-FLOAT\" id=\"8c7f37a4-4bd2-4e5a-9a7e-2d3d5d0c5d61\">"
+"  <Encoding id=\"F_WAV\" type=\"T_Sndfile\" extension=\"wav\" name=\"WAV\" has-sample-format=\"true\" channel-limit=\"256\"/>"
+"  <SampleRate rate=\"%1\"/>"
+"  <SRCQuality quality=\"SRC_SincBest\"/>"
+"  <EncodingOptions>"
+"    <Option name=\"sample-format\" value=\"SF_Float\"/>"
+"    <Option name=\"dithering\" value=\"D_None\"/>"
+"    <Option name=\"tag-metadata\" value=\"false\"/>"
+"    <Option name=\"tag-support\" value=\"false\"/>"
+"    <Option name=\"broadcast-info\" value=\"false\"/>"
+"  </EncodingOptions>"
+"  <Processing>"
+"    <Normalize enabled=\"false\" target=\"0\"/>"
+"    <Silence>"
+"      <Start>"
+"        <Trim enabled=\"false\"/>"
+"        <Add enabled=\"false\">"
+"          <Duration format=\"Timecode\" hours=\"0\" minutes=\"0\" seconds=\"0\" frames=\"0\"/>"
+"        </Add>"
+"      </Start>"
+"      <End>"
+"        <Trim enabled=\"false\"/>"
+"        <Add enabled=\"false\">"
+"          <Duration format=\"Timecode\" hours=\"0\" minutes=\"0\" seconds=\"0\" frames=\"0\"/>"
+"        </Add>"
+"      </End>"
+"    </Silence>"
+"  </Processing>"
+"</ExportFormatSpecification>", _session->nominal_frame_rate ()));
+
+	ExportFormatSpecPtr fmp = handler->add_format (*tree.root ());
+	fmp->set_soundcloud_upload (false);
+
+	PortExportChannel* channel = new PortExportChannel ();
+	channel->add_port (_track->output()->audio (0));
+	ccp->register_channel (ExportChannelPtr (channel));
+
+	vector<ExportFilenamePtr> filenames;
+
+	for (int n = 0; n < n_ranges; ++n) {
+		ExportTimespanPtr tsp = handler->add_timespan ();
+		tsp->set_range (range_start[n], range_end[n]);
+		tsp->set_range_id (string_compose ("range%1", n));
+		tsp->set_name (string_compose ("range%1", n));
+
+		ExportFilenamePtr fnp = handler->add_filename ();
+		fnp->set_folder (dir);
+		fnp->set_timespan (tsp);
+		fnp->include_label = false;
+		fnp->include_session = false;
+		filenames.push_back (fnp);
+
+		handler->add_export_config (tsp, ccp, fmp, fnp, b);
+	}
+
+	handler->do_export ();
+
+	boost::shared_ptr<ExportStatus> status = _session->get_export_status ();
+
+	for (int i = 0; status->running () && i < 3000; ++i) {
+		Glib::usleep (10000);
+	}
+
+	CPPUNIT_ASSERT (!status->running ());
+	CPPUNIT_ASSERT (!status->aborted ());
+
+	paths.clear ();
+	for (vector<ExportFilenamePtr>::const_iterator i = filenames.begin(); i != filenames.end(); ++i) {
+		paths.push_back ((*i)->get_path (fmp));
+	}
+
+	status->finish ();
+}
+
+void
+ExportTimespansTest::read_export (std::string const & path, vector<Sample> & data)
+{
+	boost::shared_ptr<AudioFileSource> source = boost::dynamic_pointer_cast<AudioFileSource> (
+		SourceFactory::createExternal (DataType::AUDIO, *_session, path, 0, Source::Flag (0), false));
+	CPPUNIT_ASSERT (source);
+
+	data.resize (source->length (0));
+	CPPUNIT_ASSERT_EQUAL (framecnt_t (data.size ()), source->read (&data[0], 0, data.size ()));
+}
+
+/** Chaining timespans saves relocating between them; it must not change
+ *  what is exported.
+ */
+void
+ExportTimespansTest::chainedTest ()
+{
+	std::string const chained_dir = new_test_output_dir ("export_chained");
+	std::string const separate_dir = new_test_output_dir ("export_separate");
+
+	vector<std::string> chained_paths;
+	vector<std::string> separate_paths;
+
+	export_ranges (chained_dir, true, chained_paths);
+	export_ranges (separate_dir, false, separate_paths);
+
+	for (int n = 0; n < n_ranges; ++n) {
+		vector<Sample> chained;
+		vector<Sample> separate;
+
+		read_export (chained_paths[n], chained);
+		read_export (separate_paths[n], separate);
+
+		CPPUNIT_ASSERT_EQUAL (size_t (range_end[n] - range_start[n]), chained.size ());
+		CPPUNIT_ASSERT_EQUAL (separate.size (), chained.size ());
+
+		bool silent = true;
+		for (size_t i = 0; i < chained.size (); ++i) {
+			CPPUNIT_ASSERT_EQUAL (separate[i], chained[i]);
+			if (chained[i] != 0) {
+				silent = false;
+			}
+		}
+		CPPUNIT_ASSERT (!silent);
+	}
+}
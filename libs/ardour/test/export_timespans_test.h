@@ -0,0 +1,47 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "ardour/types.h"
+#include "test_needing_session.h"
+
+namespace ARDOUR {
+	class AudioTrack;
+}
+
+class ExportTimespansTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (ExportTimespansTest);
+	CPPUNIT_TEST (chainedTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void chainedTest ();
+
+private:
+	void export_ranges (std::string const & dir, bool chain, std::vector<std::string> & paths);
+	void read_export (std::string const & path, std::vector<ARDOUR::Sample> &);
+
+	boost::shared_ptr<ARDOUR::AudioTrack> _track;
+};
@@ -0,0 +1,70 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "ardour/playlist.h"
+#include "ardour/region.h"
+#include "playlist_region_index_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PlaylistRegionIndexTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+void
+PlaylistRegionIndexTest::moveTest ()
+{
+	_playlist->add_region (_r[0], 0);
+	_playlist->add_region (_r[1], 1000);
+
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), _playlist->count_regions_at (50));
+	CPPUNIT_ASSERT_EQUAL (uint32_t (0), _playlist->count_regions_at (550));
+
+	_r[0]->set_position (500);
+
+	CPPUNIT_ASSERT_EQUAL (uint32_t (0), _playlist->count_regions_at (50));
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), _playlist->count_regions_at (550));
+	CPPUNIT_ASSERT (_playlist->top_region_at (550) == _r[0]);
+}
+
+/* A region that moves while its PropertyChanged is suspended must be
+   found at its new position before the change is sent.
+*/
+void
+PlaylistRegionIndexTest::suspendedMoveTest ()
+{
+	_playlist->add_region (_r[0], 0);
+	_playlist->add_region (_r[1], 1000);
+
+	_r[0]->suspend_property_changes ();
+	_r[0]->set_position (500);
+
+	CPPUNIT_ASSERT_EQUAL (uint32_t (0), _playlist->count_regions_at (50));
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), _playlist->count_regions_at (550));
+
+	boost::shared_ptr<RegionList> rl = _playlist->regions_touched (450, 650);
+	CPPUNIT_ASSERT_EQUAL (size_t (1), rl->size ());
+	CPPUNIT_ASSERT (rl->front () == _r[0]);
+
+	_r[0]->set_length (300, 0);
+
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), _playlist->count_regions_at (750));
+
+	_r[0]->resume_property_changes ();
+
+	CPPUNIT_ASSERT_EQUAL (uint32_t (0), _playlist->count_regions_at (50));
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), _playlist->count_regions_at (750));
+}
@@ -0,0 +1,183 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sndfile.h>
+
+#include "pbd/timing.h"
+
+#include "ardour/async_reader.h"
+
+/* Compare a butler-like refill pass over many tracks done with plain
+ * synchronous libsndfile reads against the same pass preceded by a batch
+ * of AsyncReader prefetches.
+ *
+ * usage: async_read [tracks [seconds-per-file [directory]]]
+ *
+ * The files are mono 32 bit float WAV at 48kHz. Their pages are dropped
+ * from the page cache (POSIX_FADV_DONTNEED) before every run, so the
+ * numbers reflect the disk rather than memory; this only works for clean
+ * pages, so the files are fsync()ed after creation.
+ */
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static const int rate = 48000;
+static const int chunk = 65536; /* frames per track per pass */
+
+struct File {
+	int      fd;
+	SNDFILE* sf;
+	off_t    data_offset;
+	sf_count_t frames;
+};
+
+static bool
+create (string const & path, int seconds)
+{
+	SF_INFO info;
+	memset (&info, 0, sizeof (info));
+	info.samplerate = rate;
+	info.channels = 1;
+	info.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+	SNDFILE* sf = sf_open (path.c_str(), SFM_WRITE, &info);
+	if (!sf) {
+		cerr << "cannot create " << path << ": " << sf_strerror (0) << endl;
+		return false;
+	}
+
+	vector<float> buf (rate);
+	for (int i = 0; i < rate; ++i) {
+		buf[i] = (rand () / (float) RAND_MAX) * 2.f - 1.f;
+	}
+	for (int s = 0; s < seconds; ++s) {
+		sf_write_float (sf, &buf[0], rate);
+	}
+
+	sf_write_sync (sf);
+	sf_close (sf);
+	return true;
+}
+
+static bool
+open_file (string const & path, File& f)
+{
+	SF_INFO info;
+	memset (&info, 0, sizeof (info));
+
+	if ((f.fd = ::open (path.c_str(), O_RDONLY)) < 0) {
+		return false;
+	}
+	if (!(f.sf = sf_open_fd (f.fd, SFM_READ, &info, true))) {
+		return false;
+	}
+
+	/* as SndFileSource::setup_prefetch() */
+	sf_seek (f.sf, 0, SEEK_SET|SFM_READ);
+	f.data_offset = lseek (f.fd, 0, SEEK_CUR);
+	f.frames = info.frames;
+	return true;
+}
+
+static void
+drop_caches (vector<File> const & files)
+{
+	for (vector<File>::const_iterator f = files.begin(); f != files.end(); ++f) {
+		posix_fadvise (f->fd, 0, 0, POSIX_FADV_DONTNEED);
+	}
+}
+
+/** @return microseconds taken to read all of every file, one chunk per track per pass */
+static uint64_t
+run (vector<File>& files, AsyncReader* reader)
+{
+	vector<float> buf (chunk);
+	sf_count_t const frames = files.front().frames;
+
+	drop_caches (files);
+
+	Timing t;
+	t.start ();
+
+	for (sf_count_t pos = 0; pos < frames; pos += chunk) {
+
+		sf_count_t const cnt = min ((sf_count_t) chunk, frames - pos);
+
+		if (reader) {
+			for (vector<File>::iterator f = files.begin(); f != files.end(); ++f) {
+				reader->add (f->fd, f->data_offset + pos * sizeof (float), cnt * sizeof (float));
+			}
+			reader->submit ();
+		}
+
+		for (vector<File>::iterator f = files.begin(); f != files.end(); ++f) {
+			sf_seek (f->sf, pos, SEEK_SET|SFM_READ);
+			if (sf_read_float (f->sf, &buf[0], cnt) != cnt) {
+				cerr << "short read\n";
+			}
+		}
+
+		if (reader) {
+			reader->wait ();
+		}
+	}
+
+	t.update ();
+	return t.elapsed ();
+}
+
+int
+main (int argc, char* argv[])
+{
+	int const tracks = argc > 1 ? atoi (argv[1]) : 256;
+	int const seconds = argc > 2 ? atoi (argv[2]) : 10;
+	string const dir = argc > 3 ? argv[3] : "/tmp";
+
+	AsyncReader reader (tracks * 4);
+
+	if (!reader.usable ()) {
+		cerr << "No asynchronous I/O backend available.\n";
+		return 0;
+	}
+
+	vector<string> paths;
+	vector<File> files (tracks);
+
+	for (int i = 0; i < tracks; ++i) {
+		char name[64];
+		snprintf (name, sizeof (name), "/async_read_%d.wav", i);
+		paths.push_back (dir + name);
+		if (!create (paths.back(), seconds) || !open_file (paths.back(), files[i])) {
+			cerr << "cannot set up " << paths.back() << endl;
+			return 1;
+		}
+	}
+
+	double const mb = (double) tracks * seconds * rate * sizeof (float) / 1048576.0;
+
+	cout << tracks << " tracks, " << seconds << " s each, " << mb << " MB total\n";
+
+	for (int pass = 0; pass < 3; ++pass) {
+		uint64_t const sync_usecs = run (files, 0);
+		uint64_t const async_usecs = run (files, &reader);
+
+		cout << "synchronous: " << sync_usecs / 1000 << " ms (" << mb / (sync_usecs / 1e6) << " MB/s), "
+		     << reader.backend () << " prefetch: " << async_usecs / 1000 << " ms (" << mb / (async_usecs / 1e6) << " MB/s)"
+		     << endl;
+	}
+
+	for (int i = 0; i < tracks; ++i) {
+		sf_close (files[i].sf);
+		unlink (paths[i].c_str());
+	}
+
+	return 0;
+}
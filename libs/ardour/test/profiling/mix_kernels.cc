@@ -0,0 +1,334 @@
+#ifdef WAF_BUILD
+#include "libardour-config.h"
+#endif
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "pbd/fpu.h"
+#include "pbd/malign.h"
+#include "pbd/timing.h"
+
+#include "ardour/mix.h"
+#include "ardour/runtime_functions.h"
+
+/* Compare every optimized mix/peak kernel against its default_* counterpart,
+ * both for correctness and for speed. Buffer sizes span the usual range of
+ * process-cycle lengths; the source buffer is deliberately offset by one
+ * sample for the "unaligned" runs.
+ */
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+struct KernelSet {
+	string                  name;
+	compute_peak_t          compute_peak;
+	find_peaks_t            find_peaks;
+	apply_gain_to_buffer_t  apply_gain_to_buffer;
+	mix_buffers_with_gain_t mix_buffers_with_gain;
+	mix_buffers_no_gain_t   mix_buffers_no_gain;
+	copy_vector_t           copy_vector;
+	apply_gain_vector_to_buffer_t  apply_gain_vector_to_buffer;
+	mix_buffers_with_gain_vector_t mix_buffers_with_gain_vector;
+	crossfade_buffers_t            crossfade_buffers;
+};
+
+static const uint32_t max_frames = 8192;
+static const int iterations = 20000;
+
+static float* ref_dst;
+static float* opt_dst;
+static float* src;
+static float* gains;
+
+static void
+fill (float* buf, uint32_t n, unsigned seed)
+{
+	srand (seed);
+	for (uint32_t i = 0; i < n; ++i) {
+		buf[i] = (rand () / (float) RAND_MAX) * 2.f - 1.f;
+	}
+}
+
+static bool
+same (float const* a, float const* b, uint32_t n)
+{
+	for (uint32_t i = 0; i < n; ++i) {
+		if (fabsf (a[i] - b[i]) > 1e-6f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void
+report (string const& kernel, string const& set, uint32_t nframes, bool aligned, uint64_t ref_usecs, uint64_t opt_usecs, bool ok)
+{
+	cout << setw (22) << kernel
+	     << setw (8) << set
+	     << setw (6) << nframes
+	     << (aligned ? "   aligned" : " unaligned")
+	     << setw (10) << ref_usecs << "us"
+	     << setw (10) << opt_usecs << "us"
+	     << setw (8) << fixed << setprecision (2) << (opt_usecs ? (double) ref_usecs / opt_usecs : 0.0) << "x"
+	     << (ok ? "" : "  MISMATCH")
+	     << endl;
+}
+
+template<typename F>
+static uint64_t
+time_it (F f)
+{
+	Timing t;
+	t.start ();
+	for (int i = 0; i < iterations; ++i) {
+		f ();
+	}
+	t.update ();
+	return t.elapsed ();
+}
+
+struct PeakRun {
+	compute_peak_t fn; float const* buf; uint32_t n; float* result;
+	void operator() () { *result = fn (buf, n, 0.f); }
+};
+
+struct FindPeaksRun {
+	find_peaks_t fn; float const* buf; uint32_t n; float* mn; float* mx;
+	void operator() () { *mn = 1.f; *mx = -1.f; fn (buf, n, mn, mx); }
+};
+
+struct GainRun {
+	apply_gain_to_buffer_t fn; float* buf; uint32_t n;
+	void operator() () { fn (buf, n, 1.0001f); }
+};
+
+struct MixGainRun {
+	mix_buffers_with_gain_t fn; float* dst; float const* src; uint32_t n;
+	void operator() () { fn (dst, src, n, 0.5f); }
+};
+
+struct MixRun {
+	mix_buffers_no_gain_t fn; float* dst; float const* src; uint32_t n;
+	void operator() () { fn (dst, src, n); }
+};
+
+struct GainVectorRun {
+	apply_gain_vector_to_buffer_t fn; float* buf; float const* gains; uint32_t n;
+	void operator() () { fn (buf, gains, n, 1.0001f); }
+};
+
+struct MixGainVectorRun {
+	mix_buffers_with_gain_vector_t fn; float* dst; float const* src; float const* gains; uint32_t n;
+	void operator() () { fn (dst, src, gains, n); }
+};
+
+struct CopyRun {
+	copy_vector_t fn; float* dst; float const* src; uint32_t n;
+	void operator() () { fn (dst, src, n); }
+};
+
+static void
+bench (KernelSet const& ref, KernelSet const& opt, uint32_t nframes, bool aligned)
+{
+	float const* s = aligned ? src : src + 1;
+	bool ok;
+	uint64_t rt, ot;
+
+	{
+		float r = 0, o = 0;
+		PeakRun rr = { ref.compute_peak, s, nframes, &r };
+		PeakRun orr = { opt.compute_peak, s, nframes, &o };
+		rt = time_it (rr);
+		ot = time_it (orr);
+		report ("compute_peak", opt.name, nframes, aligned, rt, ot, r == o);
+	}
+
+	{
+		float rmin, rmax, omin, omax;
+		FindPeaksRun rr = { ref.find_peaks, s, nframes, &rmin, &rmax };
+		FindPeaksRun orr = { opt.find_peaks, s, nframes, &omin, &omax };
+		rt = time_it (rr);
+		ot = time_it (orr);
+		report ("find_peaks", opt.name, nframes, aligned, rt, ot, rmin == omin && rmax == omax);
+	}
+
+	{
+		fill (ref_dst, nframes, 2);
+		fill (opt_dst, nframes, 2);
+		ref.apply_gain_to_buffer (ref_dst, nframes, 0.25f);
+		opt.apply_gain_to_buffer (opt_dst, nframes, 0.25f);
+		ok = same (ref_dst, opt_dst, nframes);
+		GainRun rr = { ref.apply_gain_to_buffer, ref_dst, nframes };
+		GainRun orr = { opt.apply_gain_to_buffer, opt_dst, nframes };
+		rt = time_it (rr);
+		ot = time_it (orr);
+		report ("apply_gain_to_buffer", opt.name, nframes, aligned, rt, ot, ok);
+	}
+
+	{
+		fill (ref_dst, nframes, 3);
+		fill (opt_dst, nframes, 3);
+		ref.mix_buffers_with_gain (ref_dst, s, nframes, 0.5f);
+		opt.mix_buffers_with_gain (opt_dst, s, nframes, 0.5f);
+		ok = same (ref_dst, opt_dst, nframes);
+		MixGainRun rr = { ref.mix_buffers_with_gain, ref_dst, s, nframes };
+		MixGainRun orr = { opt.mix_buffers_with_gain, opt_dst, s, nframes };
+		rt = time_it (rr);
+		ot = time_it (orr);
+		report ("mix_buffers_with_gain", opt.name, nframes, aligned, rt, ot, ok);
+	}
+
+	{
+		fill (ref_dst, nframes, 4);
+		fill (opt_dst, nframes, 4);
+		ref.mix_buffers_no_gain (ref_dst, s, nframes);
+		opt.mix_buffers_no_gain (opt_dst, s, nframes);
+		ok = same (ref_dst, opt_dst, nframes);
+		MixRun rr = { ref.mix_buffers_no_gain, ref_dst, s, nframes };
+		MixRun orr = { opt.mix_buffers_no_gain, opt_dst, s, nframes };
+		rt = time_it (rr);
+		ot = time_it (orr);
+		report ("mix_buffers_no_gain", opt.name, nframes, aligned, rt, ot, ok);
+	}
+
+	{
+		ref.copy_vector (ref_dst, s, nframes);
+		opt.copy_vector (opt_dst, s, nframes);
+		ok = same (ref_dst, opt_dst, nframes);
+		CopyRun rr = { ref.copy_vector, ref_dst, s, nframes };
+		CopyRun orr = { opt.copy_vector, opt_dst, s, nframes };
+		rt = time_it (rr);
+		ot = time_it (orr);
+		report ("copy_vector", opt.name, nframes, aligned, rt, ot, ok);
+	}
+
+	{
+		fill (ref_dst, nframes, 5);
+		fill (opt_dst, nframes, 5);
+		ref.apply_gain_vector_to_buffer (ref_dst, gains, nframes, 0.5f);
+		opt.apply_gain_vector_to_buffer (opt_dst, gains, nframes, 0.5f);
+		ok = same (ref_dst, opt_dst, nframes);
+		GainVectorRun rr = { ref.apply_gain_vector_to_buffer, ref_dst, gains, nframes };
+		GainVectorRun orr = { opt.apply_gain_vector_to_buffer, opt_dst, gains, nframes };
+		rt = time_it (rr);
+		ot = time_it (orr);
+		report ("apply_gain_vector", opt.name, nframes, aligned, rt, ot, ok);
+	}
+
+	{
+		fill (ref_dst, nframes, 6);
+		fill (opt_dst, nframes, 6);
+		ref.mix_buffers_with_gain_vector (ref_dst, s, gains, nframes);
+		opt.mix_buffers_with_gain_vector (opt_dst, s, gains, nframes);
+		ok = same (ref_dst, opt_dst, nframes);
+		MixGainVectorRun rr = { ref.mix_buffers_with_gain_vector, ref_dst, s, gains, nframes };
+		MixGainVectorRun orr = { opt.mix_buffers_with_gain_vector, opt_dst, s, gains, nframes };
+		rt = time_it (rr);
+		ot = time_it (orr);
+		report ("mix_with_gain_vector", opt.name, nframes, aligned, rt, ot, ok);
+	}
+
+	{
+		fill (ref_dst, nframes, 7);
+		fill (opt_dst, nframes, 7);
+		ref.crossfade_buffers (ref_dst, s, gains, nframes);
+		opt.crossfade_buffers (opt_dst, s, gains, nframes);
+		ok = same (ref_dst, opt_dst, nframes);
+		MixGainVectorRun rr = { ref.crossfade_buffers, ref_dst, s, gains, nframes };
+		MixGainVectorRun orr = { opt.crossfade_buffers, opt_dst, s, gains, nframes };
+		rt = time_it (rr);
+		ot = time_it (orr);
+		report ("crossfade_buffers", opt.name, nframes, aligned, rt, ot, ok);
+	}
+}
+
+int
+main (int argc, char* argv[])
+{
+	KernelSet def = {
+		"default",
+		default_compute_peak, default_find_peaks, default_apply_gain_to_buffer,
+		default_mix_buffers_with_gain, default_mix_buffers_no_gain, default_copy_vector,
+		default_apply_gain_vector_to_buffer, default_mix_buffers_with_gain_vector, default_crossfade_buffers
+	};
+
+	vector<KernelSet> sets;
+
+#if defined (ARCH_X86) && defined (BUILD_SSE_OPTIMIZATIONS)
+	FPU* fpu = FPU::instance ();
+
+	if (fpu->has_sse ()) {
+		KernelSet k = {
+			"sse",
+			x86_sse_compute_peak, x86_sse_find_peaks, x86_sse_apply_gain_to_buffer,
+			x86_sse_mix_buffers_with_gain, x86_sse_mix_buffers_no_gain, default_copy_vector,
+			x86_sse_apply_gain_vector_to_buffer, x86_sse_mix_buffers_with_gain_vector, x86_sse_crossfade_buffers
+		};
+		sets.push_back (k);
+	}
+	if (fpu->has_avx ()) {
+		KernelSet k = {
+			"avx",
+			x86_sse_avx_compute_peak, x86_sse_avx_find_peaks, x86_sse_avx_apply_gain_to_buffer,
+			x86_sse_avx_mix_buffers_with_gain, x86_sse_avx_mix_buffers_no_gain, x86_sse_avx_copy_vector,
+			x86_sse_avx_apply_gain_vector_to_buffer, x86_sse_avx_mix_buffers_with_gain_vector, x86_sse_avx_crossfade_buffers
+		};
+		sets.push_back (k);
+	}
+#ifdef HAVE_AVX512F
+	if (fpu->has_avx512f ()) {
+		KernelSet k = {
+			"avx512",
+			x86_avx512_compute_peak, x86_avx512_find_peaks, x86_avx512_apply_gain_to_buffer,
+			x86_avx512_mix_buffers_with_gain, x86_avx512_mix_buffers_no_gain, x86_avx512_copy_vector,
+			x86_avx512_apply_gain_vector_to_buffer, x86_avx512_mix_buffers_with_gain_vector, x86_avx512_crossfade_buffers
+		};
+		sets.push_back (k);
+	}
+#endif
+#endif
+
+	if (sets.empty ()) {
+		cerr << "No optimized kernels available on this machine.\n";
+		return 0;
+	}
+
+	cache_aligned_malloc ((void**) &ref_dst, max_frames * sizeof (float));
+	cache_aligned_malloc ((void**) &opt_dst, max_frames * sizeof (float));
+	cache_aligned_malloc ((void**) &src, (max_frames + 1) * sizeof (float));
+	fill (src, max_frames + 1, 1);
+	/* gains, like a fade, lie in [0, 1] */
+	cache_aligned_malloc ((void**) &gains, max_frames * sizeof (float));
+	for (uint32_t i = 0; i < max_frames; ++i) {
+		gains[i] = i / (float) max_frames;
+	}
+
+	cout << setw (22) << "kernel" << setw (8) << "set" << setw (6) << "n" << "          "
+	     << setw (12) << "default" << setw (12) << "optimized" << setw (9) << "speedup" << endl;
+
+	static const uint32_t sizes[] = { 64, 256, 1024, 8191 };
+
+	for (vector<KernelSet>::const_iterator k = sets.begin (); k != sets.end (); ++k) {
+		for (size_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); ++i) {
+			bench (def, *k, sizes[i], true);
+			/* the SSE assembler routines need src and dst to share their alignment */
+			if (k->name != "sse") {
+				bench (def, *k, sizes[i], false);
+			}
+		}
+	}
+
+	cache_aligned_free (ref_dst);
+	cache_aligned_free (opt_dst);
+	cache_aligned_free (src);
+	cache_aligned_free (gains);
+
+	return 0;
+}
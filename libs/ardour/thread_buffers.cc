@@ -38,6 +38,7 @@ ThreadBuffers::ThreadBuffers ()
 	, send_gain_automation_buffer (0)
 	, pan_automation_buffer (0)
 	, npan_buffers (0)
+	, _custom (0)
 {
 }
 
@@ -49,6 +50,8 @@ ThreadBuffers::ensure_buffers (ChanCount howmany, size_t custom)
 	/* this is all protected by the process lock in the Session
 	 */
 
+	_custom = custom;
+
 	/* we always need at least 1 midi buffer */
 	if (howmany.n_midi() < 1) {
 		howmany.set_midi(1);
@@ -90,6 +93,37 @@ ThreadBuffers::ensure_buffers (ChanCount howmany, size_t custom)
 	allocate_pan_automation_buffers (audio_buffer_size, howmany.n_audio(), false);
 }
 
+/** Free all of our buffers and allocate them again, at their current sizes,
+ *  from the calling thread.  Under Linux's default (first touch) NUMA policy
+ *  their memory then comes from the node that this thread is running on.
+ */
+void
+ThreadBuffers::reallocate ()
+{
+	ChanCount const howmany = scratch_buffers->available ();
+
+	if (howmany.n_audio() == 0 && howmany.n_midi() <= 1) {
+		/* ensure_buffers() would not allocate anything for this */
+		return;
+	}
+
+	BufferSet** sets[] = { &silent_buffers, &scratch_buffers, &noinplace_buffers, &route_buffers, &mix_buffers };
+
+	for (size_t n = 0; n < sizeof (sets) / sizeof (sets[0]); ++n) {
+		delete *sets[n];
+		*sets[n] = new BufferSet;
+	}
+
+	for (uint32_t i = 0; i < npan_buffers; ++i) {
+		delete [] pan_automation_buffer[i];
+	}
+	delete [] pan_automation_buffer;
+	pan_automation_buffer = 0;
+	npan_buffers = 0;
+
+	ensure_buffers (howmany, _custom);
+}
+
 void
 ThreadBuffers::allocate_pan_automation_buffers (framecnt_t nframes, uint32_t howmany, bool force)
 {
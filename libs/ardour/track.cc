@@ -618,6 +618,18 @@ Track::do_refill ()
 	return _diskstream->do_refill ();
 }
 
+int
+Track::do_refill_with_buffers (Sample* mixdown_buffer, float* gain_buffer)
+{
+	return _diskstream->do_refill_with_buffers (mixdown_buffer, gain_buffer);
+}
+
+void
+Track::prefetch (AsyncReader& reader)
+{
+	_diskstream->prefetch (reader);
+}
+
 int
 Track::do_flush (RunContext c, bool force)
 {
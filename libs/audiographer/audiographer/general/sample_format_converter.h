@@ -46,6 +46,14 @@ class LIBAUDIOGRAPHER_API SampleFormatConverter
 	/// Set whether or not clipping to [-1.0, 1.0] should occur when TOut = float. Clipping is off by default
 	void set_clip_floats (bool yn) { clip_floats = yn; }
 
+	/** Set whether or not all conversion should be done by gdither.
+	  * By default 8 bit, 16 bit and 24 bit integer output is converted by
+	  * vectorized routines, which are bit-exact with gdither when not dithering.
+	  * Dithered output uses a different noise source than gdither.
+	  * \n RT safe
+	  */
+	void set_use_gdither (bool yn) { use_gdither = yn; }
+
 	/// Processes data without modifying it
 	void process (ProcessContext<float> const & c_in);
 
@@ -55,14 +63,39 @@ class LIBAUDIOGRAPHER_API SampleFormatConverter
   private:
 	void reset();
 	void init_common (framecnt_t max_frames); // not-template-specialized part of init
+	void init_quantizer (int type, int data_width);
+	void quantize (float const * data, framecnt_t frames);
 	void check_frame_and_channel_count (framecnt_t frames, ChannelCount channels_);
 
+	/// Parameters of the integer conversion, as used by gdither
+	struct Quantizer {
+		float   scale;
+		float   bias;
+		float   clamp_l;
+		float   clamp_u;
+		int32_t post_scale;
+	};
+
+	/// Error feedback of noise shaping, per channel
+	struct ShapedState {
+		uint32_t phase;
+		float    buffer[8];
+	};
+
 	ChannelCount channels;
 	GDither      dither;
 	framecnt_t   data_out_size;
 	TOut *       data_out;
 
 	bool         clip_floats;
+	bool         use_gdither;
+
+	bool         can_quantize;
+	int          dither_type;
+	Quantizer    quantizer;
+	float *      noise;        ///< one frame of the previous cycle's noise (for D_Tri), then this cycle's
+	ShapedState * shaped_state;
+	uint32_t     rng[4];
 
 };
 
@@ -0,0 +1,64 @@
+#ifndef AUDIOGRAPHER_THREAD_POOL_H
+#define AUDIOGRAPHER_THREAD_POOL_H
+
+#include <glib.h>
+#include <glibmm/threads.h>
+#include <vector>
+
+#include "pbd/semutils.h"
+
+#include "audiographer/visibility.h"
+
+namespace AudioGrapher
+{
+
+/** A fixed set of threads that run batches of tasks.
+  * Threads are started once and sleep between batches. A batch is handed
+  * out by an atomic counter, without allocating anything, and the thread
+  * that submits it works on it as well until every task has finished.
+  */
+class LIBAUDIOGRAPHER_API ThreadPool
+{
+  public:
+	/// A task, called with the argument given to \a run() and the task's index
+	typedef void (*Task) (void * arg, unsigned int index);
+
+	/** Constructor
+	  * \n Not RT safe
+	  * \param n_threads number of threads besides the one calling \a run()
+	  */
+	ThreadPool (unsigned int n_threads);
+	~ThreadPool ();
+
+	/// Number of threads in the pool, not counting the caller of \a run()
+	unsigned int size () const { return threads.size (); }
+
+	/** Runs \a task for every index in [0, \a n_tasks) and returns once all have finished.
+	  * Tasks must not throw.
+	  * \n RT safe
+	  */
+	void run (Task task, void * arg, unsigned int n_tasks);
+
+  private:
+	void thread_main ();
+	void work ();
+	void done (gint count);
+
+	std::vector<Glib::Threads::Thread *> threads;
+
+	Glib::Threads::Mutex run_mutex;
+	PBD::Semaphore wake_sem;
+	PBD::Semaphore done_sem;
+
+	Task   task;
+	void * task_arg;
+	gint   n_tasks;
+	gint   next_task;
+	/// tasks left, plus the threads that were woken up and are not done yet
+	gint   pending;
+	gint   quit;
+};
+
+} // namespace
+
+#endif // AUDIOGRAPHER_THREAD_POOL_H
@@ -1,16 +1,14 @@
 #ifndef AUDIOGRAPHER_THREADER_H
 #define AUDIOGRAPHER_THREADER_H
 
-#include <glibmm/threadpool.h>
-#include <glibmm/timeval.h>
-#include <sigc++/slot.h>
+#include <glibmm/threads.h>
 #include <boost/format.hpp>
 
-#include <glib.h>
 #include <vector>
 #include <algorithm>
 
 #include "audiographer/visibility.h"
+#include "audiographer/general/thread_pool.h"
 #include "audiographer/source.h"
 #include "audiographer/sink.h"
 #include "audiographer/exception.h"
@@ -43,12 +41,10 @@ class /*LIBAUDIOGRAPHER_API*/ Threader : public Source<T>, public Sink<T>
 	/** Constructor
 	  * \n RT safe
 	  * \param thread_pool a thread pool from which all tasks are scheduled
-	  * \param wait_timeout_milliseconds maximum time allowed for threads to use in processing
 	  */
-	Threader (Glib::ThreadPool & thread_pool, long wait_timeout_milliseconds = 500)
+	Threader (ThreadPool & thread_pool)
 	  : thread_pool (thread_pool)
-	  , readers (0)
-	  , wait_timeout (wait_timeout_milliseconds)
+	  , context (0)
 	{ }
 
 	virtual ~Threader () {}
@@ -65,63 +61,41 @@ class /*LIBAUDIOGRAPHER_API*/ Threader : public Source<T>, public Sink<T>
 		outputs.erase (new_end, outputs.end());
 	}
 
-	/// Processes context concurrently by scheduling each output separately to the given thread pool
+	/// Processes context concurrently by running each output as a task of the given thread pool
 	void process (ProcessContext<T> const & c)
 	{
-		wait_mutex.lock();
-
 		exception.reset();
 
-		unsigned int outs = outputs.size();
-		g_atomic_int_add (&readers, outs);
-		for (unsigned int i = 0; i < outs; ++i) {
-			thread_pool.push (sigc::bind (sigc::mem_fun (this, &Threader::process_output), c, i));
-		}
+		context = &c;
+		thread_pool.run (&Threader::process_output, this, outputs.size());
+		context = 0;
 
-		wait();
+		if (exception) {
+			throw *exception;
+		}
 	}
 
 	using Sink<T>::process;
 
   private:
 
-	void wait()
-	{
-		while (g_atomic_int_get (&readers) != 0) {
-			gint64 end_time = g_get_monotonic_time () + (wait_timeout * G_TIME_SPAN_MILLISECOND);
-			wait_cond.wait_until(wait_mutex, end_time);
-		}
-
-		wait_mutex.unlock();
-
-		if (exception) {
-			throw *exception;
-		}
-	}
-
-	void process_output(ProcessContext<T> const & c, unsigned int output)
+	static void process_output (void * arg, unsigned int output)
 	{
+		Threader * self = static_cast<Threader *> (arg);
 		try {
-			outputs[output]->process (c);
+			self->outputs[output]->process (*self->context);
 		} catch (std::exception const & e) {
 			// Only first exception will be passed on
-			exception_mutex.lock();
-			if(!exception) { exception.reset (new ThreaderException (*this, e)); }
-			exception_mutex.unlock();
-		}
-
-		if (g_atomic_int_dec_and_test (&readers)) {
-			wait_cond.signal();
+			self->exception_mutex.lock();
+			if(!self->exception) { self->exception.reset (new ThreaderException (*self, e)); }
+			self->exception_mutex.unlock();
 		}
 	}
 
 	OutputVec outputs;
 
-	Glib::ThreadPool & thread_pool;
-        Glib::Threads::Mutex wait_mutex;
-        Glib::Threads::Cond  wait_cond;
-	gint        readers;
-	long        wait_timeout;
+	ThreadPool & thread_pool;
+	ProcessContext<T> const * context;
 
         Glib::Threads::Mutex exception_mutex;
 	boost::shared_ptr<ThreaderException> exception;
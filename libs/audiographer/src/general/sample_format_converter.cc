@@ -24,18 +24,182 @@
 #include "audiographer/type_utils.h"
 #include "private/gdither/gdither.h"
 
+#include <cmath>
+#include <cstring>
 #include <boost/format.hpp>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace AudioGrapher
 {
 
+/* Vectorized float to integer conversion.
+ *
+ * These compute the same as gdither's inner loop for the 8 bit, 16 bit and
+ * 24-in-32 bit cases: scale, add bias, subtract dither, round to nearest
+ * and clamp. Clamping is done before rounding, in float, which gives the
+ * same result because the clamp limits are integers.
+ *
+ * Dither noise comes from four interleaved xorshift generators that are
+ * run for a whole block at once. The SSE2 and the plain C++ code produce
+ * the same noise and the same output.
+ */
+
+namespace {
+
+/* Lipshitz's minimally audible FIR, as in gdither */
+const float shaped_bs[] = { 2.033f, -2.165f, 1.959f, -1.590f, 0.6149f };
+const uint32_t shaped_mask = 7; // ShapedState::buffer has 8 elements
+
+template <typename TOut> inline TOut
+clamp_and_round (float tmp, float lo, float hi, int32_t post_scale)
+{
+	/* written so that NaN ends up at the lower limit, as with SSE min/max */
+	if (!(tmp >= lo)) {
+		tmp = lo;
+	} else if (tmp > hi) {
+		tmp = hi;
+	}
+	return (TOut) (lrintf (tmp) * post_scale);
+}
+
+#ifdef __SSE2__
+template <typename TOut> inline void store4 (TOut * y, __m128i v);
+
+template <> inline void
+store4<int32_t> (int32_t * y, __m128i v)
+{
+	_mm_storeu_si128 ((__m128i *) y, v);
+}
+
+template <> inline void
+store4<int16_t> (int16_t * y, __m128i v)
+{
+	_mm_storel_epi64 ((__m128i *) y, _mm_packs_epi32 (v, v));
+}
+
+template <> inline void
+store4<uint8_t> (uint8_t * y, __m128i v)
+{
+	v = _mm_packs_epi32 (v, v);
+	int32_t const w = _mm_cvtsi128_si32 (_mm_packus_epi16 (v, v));
+	memcpy (y, &w, sizeof (w));
+}
+#endif
+
+/** Fill \a buf with uniform noise in [offset, offset + 1) */
+void
+fill_noise (float * buf, uint32_t n, uint32_t * rng, float offset)
+{
+	uint32_t i = 0;
+#ifdef __SSE2__
+	__m128i s = _mm_loadu_si128 ((__m128i const *) rng);
+	__m128i const one = _mm_set1_epi32 (0x3f800000);
+	__m128 const off = _mm_set1_ps (offset - 1.f);
+	for (; i + 4 <= n; i += 4) {
+		s = _mm_xor_si128 (s, _mm_slli_epi32 (s, 13));
+		s = _mm_xor_si128 (s, _mm_srli_epi32 (s, 17));
+		s = _mm_xor_si128 (s, _mm_slli_epi32 (s, 5));
+		__m128 const f = _mm_castsi128_ps (_mm_or_si128 (_mm_srli_epi32 (s, 9), one));
+		_mm_storeu_ps (buf + i, _mm_add_ps (f, off));
+	}
+	_mm_storeu_si128 ((__m128i *) rng, s);
+#endif
+	for (; i < n; ++i) {
+		uint32_t & s = rng[i & 3];
+		s ^= s << 13;
+		s ^= s >> 17;
+		s ^= s << 5;
+		uint32_t const bits = (s >> 9) | 0x3f800000;
+		float f;
+		memcpy (&f, &bits, sizeof (f));
+		buf[i] = f + (offset - 1.f);
+	}
+}
+
+enum BlockDither {
+	BlockNone,
+	BlockRect, // subtract noise[i]
+	BlockTri   // subtract noise[i] - prev[i]
+};
+
+template <typename TOut, int D, typename Q>
+void
+quantize_block (TOut * y, float const * x, float const * noise, float const * prev, uint32_t n, Q const & q)
+{
+	uint32_t i = 0;
+#ifdef __SSE2__
+	__m128 const scale = _mm_set1_ps (q.scale);
+	__m128 const bias = _mm_set1_ps (q.bias);
+	__m128 const lo = _mm_set1_ps (q.clamp_l);
+	__m128 const hi = _mm_set1_ps (q.clamp_u);
+	__m128i const shift = _mm_cvtsi32_si128 (q.post_scale == 256 ? 8 : 0);
+	for (; i + 4 <= n; i += 4) {
+		__m128 v = _mm_add_ps (_mm_mul_ps (_mm_loadu_ps (x + i), scale), bias);
+		if (D == BlockRect) {
+			v = _mm_sub_ps (v, _mm_loadu_ps (noise + i));
+		} else if (D == BlockTri) {
+			v = _mm_sub_ps (v, _mm_sub_ps (_mm_loadu_ps (noise + i), _mm_loadu_ps (prev + i)));
+		}
+		v = _mm_min_ps (_mm_max_ps (v, lo), hi);
+		store4<TOut> (y + i, _mm_sll_epi32 (_mm_cvtps_epi32 (v), shift));
+	}
+#endif
+	for (; i < n; ++i) {
+		float tmp = x[i] * q.scale + q.bias;
+		if (D == BlockRect) {
+			tmp -= noise[i];
+		} else if (D == BlockTri) {
+			tmp -= noise[i] - prev[i];
+		}
+		y[i] = clamp_and_round<TOut> (tmp, q.clamp_l, q.clamp_u, q.post_scale);
+	}
+}
+
+/* Noise shaping feeds each sample's rounding error into the next ones of
+ * the same channel, so only the noise is computed ahead.
+ */
+template <typename TOut, typename Q, typename S>
+void
+quantize_shaped (TOut * y, float const * x, float const * noise, uint32_t n, uint32_t channels, S * state, Q const & q)
+{
+	for (uint32_t c = 0; c < channels; ++c) {
+		S & ss (state[c]);
+		for (uint32_t i = c; i < n; i += channels) {
+			float tmp = x[i] * q.scale + q.bias;
+			float const ideal = tmp;
+
+			ss.buffer[ss.phase] = noise[i] * 0.5f;
+			tmp += ss.buffer[ss.phase] * shaped_bs[0]
+			     + ss.buffer[(ss.phase - 1) & shaped_mask] * shaped_bs[1]
+			     + ss.buffer[(ss.phase - 2) & shaped_mask] * shaped_bs[2]
+			     + ss.buffer[(ss.phase - 3) & shaped_mask] * shaped_bs[3]
+			     + ss.buffer[(ss.phase - 4) & shaped_mask] * shaped_bs[4];
+
+			ss.phase = (ss.phase + 1) & shaped_mask;
+			ss.buffer[ss.phase] = (float) lrintf (tmp) - ideal;
+
+			y[i] = clamp_and_round<TOut> (tmp, q.clamp_l, q.clamp_u, q.post_scale);
+		}
+	}
+}
+
+} // anonymous namespace
+
 template <typename TOut>
 SampleFormatConverter<TOut>::SampleFormatConverter (ChannelCount channels) :
   channels (channels),
   dither (0),
   data_out_size (0),
   data_out (0),
-  clip_floats (false)
+  clip_floats (false),
+  use_gdither (false),
+  can_quantize (false),
+  dither_type (D_None),
+  noise (0),
+  shaped_state (0)
 {
 }
 
@@ -64,6 +228,7 @@ SampleFormatConverter<int32_t>::init (framecnt_t max_frames, int type, int data_
 
 	init_common (max_frames);
 	dither = gdither_new ((GDitherType) type, channels, GDither32bit, data_width);
+	init_quantizer (type, data_width);
 }
 
 template <>
@@ -77,6 +242,7 @@ SampleFormatConverter<int16_t>::init (framecnt_t max_frames, int type, int data_
 	}
 	init_common (max_frames);
 	dither = gdither_new ((GDitherType) type, channels, GDither16bit, data_width);
+	init_quantizer (type, data_width);
 }
 
 template <>
@@ -90,6 +256,7 @@ SampleFormatConverter<uint8_t>::init (framecnt_t max_frames, int type, int data_
 	}
 	init_common (max_frames);
 	dither = gdither_new ((GDitherType) type, channels, GDither8bit, data_width);
+	init_quantizer (type, data_width);
 }
 
 template <typename TOut>
@@ -106,6 +273,84 @@ SampleFormatConverter<TOut>::init_common (framecnt_t max_frames)
 	}
 }
 
+/* Only the full-width cases are done here, like gdither's fast paths;
+ * anything else is left to gdither.
+ */
+template <typename TOut>
+void
+SampleFormatConverter<TOut>::init_quantizer (int type, int data_width)
+{
+	switch (sizeof (TOut) * 8) {
+	case 8:
+		can_quantize = (data_width == 8);
+		quantizer.scale = 128.0f;
+		quantizer.bias = 128.0f;
+		quantizer.clamp_l = 0.0f;
+		quantizer.clamp_u = 255.0f;
+		quantizer.post_scale = 1;
+		break;
+	case 16:
+		can_quantize = (data_width == 16);
+		quantizer.scale = 32768.0f;
+		quantizer.bias = 0.0f;
+		quantizer.clamp_l = -32768.0f;
+		quantizer.clamp_u = 32767.0f;
+		quantizer.post_scale = 1;
+		break;
+	case 32:
+		can_quantize = (data_width == 24);
+		quantizer.scale = 8388608.0f;
+		quantizer.bias = 0.0f;
+		quantizer.clamp_l = -8388608.0f;
+		quantizer.clamp_u = 8388607.0f;
+		quantizer.post_scale = 256;
+		break;
+	default:
+		can_quantize = false;
+		break;
+	}
+
+	dither_type = type;
+
+	rng[0] = 23232323;
+	rng[1] = 0x9e3779b9;
+	rng[2] = 0x7f4a7c15;
+	rng[3] = 0x85ebca6b;
+
+	noise = new float[data_out_size + channels];
+	memset (noise, 0, sizeof (float) * channels);
+
+	if (type == D_Shaped) {
+		shaped_state = new ShapedState[channels];
+		memset (shaped_state, 0, sizeof (ShapedState) * channels);
+	}
+}
+
+template <typename TOut>
+void
+SampleFormatConverter<TOut>::quantize (float const * data, framecnt_t frames)
+{
+	switch (dither_type) {
+	case D_None:
+		quantize_block<TOut, BlockNone> (data_out, data, 0, 0, frames, quantizer);
+		break;
+	case D_Rect:
+		fill_noise (noise, frames, rng, 0.f);
+		quantize_block<TOut, BlockRect> (data_out, data, noise, 0, frames, quantizer);
+		break;
+	case D_Tri:
+		/* each sample's noise minus the previous one of the same channel */
+		fill_noise (noise + channels, frames, rng, -0.5f);
+		quantize_block<TOut, BlockTri> (data_out, data, noise + channels, noise, frames, quantizer);
+		memmove (noise, noise + frames, sizeof (float) * channels);
+		break;
+	case D_Shaped:
+		fill_noise (noise, frames, rng, 0.f);
+		quantize_shaped<TOut> (data_out, data, noise, frames, channels, shaped_state, quantizer);
+		break;
+	}
+}
+
 template <typename TOut>
 SampleFormatConverter<TOut>::~SampleFormatConverter ()
 {
@@ -121,6 +366,12 @@ SampleFormatConverter<TOut>::reset()
 		dither = 0;
 	}
 
+	delete[] noise;
+	noise = 0;
+	delete[] shaped_state;
+	shaped_state = 0;
+	can_quantize = false;
+
 	delete[] data_out;
 	data_out_size = 0;
 	data_out = 0;
@@ -139,8 +390,12 @@ SampleFormatConverter<TOut>::process (ProcessContext<float> const & c_in)
 
 	/* Do conversion */
 
-	for (uint32_t chn = 0; chn < c_in.channels(); ++chn) {
-		gdither_runf (dither, chn, c_in.frames_per_channel (), data, data_out);
+	if (can_quantize && !use_gdither) {
+		quantize (data, c_in.frames ());
+	} else {
+		for (uint32_t chn = 0; chn < c_in.channels(); ++chn) {
+			gdither_runf (dither, chn, c_in.frames_per_channel (), data, data_out);
+		}
 	}
 
 	/* Write forward */
@@ -191,6 +446,13 @@ SampleFormatConverter<float>::process (ProcessContext<float> const & c_in)
 	process (c);
 }
 
+/* float output is never quantized, see init() */
+template<>
+void
+SampleFormatConverter<float>::quantize (float const *, framecnt_t)
+{
+}
+
 template<typename TOut>
 void
 SampleFormatConverter<TOut>::check_frame_and_channel_count (framecnt_t frames, ChannelCount channels_)
@@ -0,0 +1,125 @@
+/*
+    Copyright (C) 2017 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include <algorithm>
+
+#include "audiographer/general/thread_pool.h"
+
+namespace AudioGrapher
+{
+
+ThreadPool::ThreadPool (unsigned int n_threads)
+	: wake_sem ("audiographer_wake", 0)
+	, done_sem ("audiographer_done", 0)
+	, task (0)
+	, task_arg (0)
+	, n_tasks (0)
+	, next_task (0)
+	, pending (0)
+	, quit (0)
+{
+	for (unsigned int i = 0; i < n_threads; ++i) {
+		threads.push_back (Glib::Threads::Thread::create (sigc::mem_fun (*this, &ThreadPool::thread_main)));
+	}
+}
+
+ThreadPool::~ThreadPool ()
+{
+	g_atomic_int_set (&quit, 1);
+
+	for (unsigned int i = 0; i < threads.size(); ++i) {
+		wake_sem.signal ();
+	}
+	for (std::vector<Glib::Threads::Thread *>::iterator i = threads.begin(); i != threads.end(); ++i) {
+		(*i)->join ();
+	}
+}
+
+void
+ThreadPool::run (Task t, void * arg, unsigned int n)
+{
+	if (n == 0) {
+		return;
+	}
+
+	Glib::Threads::Mutex::Lock lm (run_mutex);
+
+	/* The caller takes one share of the work, so at most n - 1 threads
+	 * have anything to do. Every thread woken up here counts as pending
+	 * until it has left work(), so that none of them is still looking at
+	 * this batch when the next one is set up.
+	 */
+	unsigned int const wakeups = std::min<unsigned int> (n - 1, threads.size());
+
+	task = t;
+	task_arg = arg;
+	n_tasks = n;
+	g_atomic_int_set (&pending, n + wakeups);
+	g_atomic_int_set (&next_task, 0);
+
+	for (unsigned int i = 0; i < wakeups; ++i) {
+		wake_sem.signal ();
+	}
+
+	work ();
+
+	done_sem.wait ();
+}
+
+void
+ThreadPool::thread_main ()
+{
+	while (true) {
+		wake_sem.wait ();
+
+		if (g_atomic_int_get (&quit)) {
+			return;
+		}
+
+		work ();
+		done (1);
+	}
+}
+
+void
+ThreadPool::work ()
+{
+	gint finished = 0;
+
+	while (true) {
+		gint const i = g_atomic_int_add (&next_task, 1);
+		if (i >= n_tasks) {
+			break;
+		}
+		task (task_arg, i);
+		++finished;
+	}
+
+	done (finished);
+}
+
+void
+ThreadPool::done (gint count)
+{
+	if (count > 0 && g_atomic_int_add (&pending, -count) == count) {
+		done_sem.signal ();
+	}
+}
+
+} // namespace
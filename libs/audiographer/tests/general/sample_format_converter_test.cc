@@ -1,5 +1,7 @@
 #include "tests/utils.h"
 
+#include <cmath>
+
 #include "audiographer/general/sample_format_converter.h"
 
 using namespace AudioGrapher;
@@ -15,6 +17,8 @@ class SampleFormatConverterTest : public CppUnit::TestFixture
   CPPUNIT_TEST (testInt16);
   CPPUNIT_TEST (testUint8);
   CPPUNIT_TEST (testChannelCount);
+  CPPUNIT_TEST (testGditherBitExact);
+  CPPUNIT_TEST (testDitherRange);
   CPPUNIT_TEST_SUITE_END ();
 
   public:
@@ -204,8 +208,71 @@ class SampleFormatConverterTest : public CppUnit::TestFixture
 		CPPUNIT_ASSERT (TestUtils::array_filled(sink->get_array(), pc.frames()));
 	}
 
+	void testGditherBitExact()
+	{
+		// Include some clipping and values that round to even
+		random_data[10] = -1.5;
+		random_data[20] = 1.5;
+		random_data[30] = 0.5f / 32768;
+		random_data[40] = 2.5f / 8388608;
+
+		// Each stereo and mono
+		for (ChannelCount chn = 1; chn <= 2; ++chn) {
+			framecnt_t const n = frames - (frames % chn);
+			CPPUNIT_ASSERT (converts_like_gdither<int32_t> (chn, n, 24));
+			CPPUNIT_ASSERT (converts_like_gdither<int16_t> (chn, n, 16));
+			CPPUNIT_ASSERT (converts_like_gdither<uint8_t> (chn, n, 8));
+		}
+	}
+
+	void testDitherRange()
+	{
+		boost::shared_ptr<SampleFormatConverter<int16_t> > converter (new SampleFormatConverter<int16_t>(1));
+		boost::shared_ptr<VectorSink<int16_t> > sink (new VectorSink<int16_t>());
+
+		int const types[] = { D_Rect, D_Tri };
+		for (unsigned t = 0; t < 2; ++t) {
+			converter->init (frames, types[t], 16);
+			converter->add_output (sink);
+
+			ProcessContext<float> pc(random_data, frames, 1);
+			converter->process (pc);
+			CPPUNIT_ASSERT_EQUAL (frames, (framecnt_t) sink->get_data().size());
+
+			// dither noise is less than one LSB, plus rounding
+			for (framecnt_t i = 0; i < frames; ++i) {
+				float const ideal = random_data[i] * 32768.f;
+				CPPUNIT_ASSERT (std::fabs (sink->get_data()[i] - ideal) <= 1.5f);
+			}
+			converter->clear_outputs ();
+		}
+	}
+
   private:
 
+	/// Compare the default conversion with gdither's, with dithering disabled
+	template<typename T>
+	bool converts_like_gdither (ChannelCount chn, framecnt_t n, int data_width)
+	{
+		boost::shared_ptr<SampleFormatConverter<T> > converter (new SampleFormatConverter<T>(chn));
+		boost::shared_ptr<SampleFormatConverter<T> > reference (new SampleFormatConverter<T>(chn));
+		boost::shared_ptr<VectorSink<T> > sink (new VectorSink<T>());
+		boost::shared_ptr<VectorSink<T> > reference_sink (new VectorSink<T>());
+
+		converter->init (n, D_None, data_width);
+		converter->add_output (sink);
+		reference->init (n, D_None, data_width);
+		reference->set_use_gdither (true);
+		reference->add_output (reference_sink);
+
+		ProcessContext<float> pc(random_data, n, chn);
+		converter->process (pc);
+		reference->process (pc);
+
+		return sink->get_data().size() == (size_t) n
+			&& TestUtils::array_equals (sink->get_array(), reference_sink->get_array(), n);
+	}
+
 	float * random_data;
 	framecnt_t frames;
 };
@@ -0,0 +1,129 @@
+#include "tests/utils.h"
+
+#include <iostream>
+#include <glib.h>
+
+#include "audiographer/general/sample_format_converter.h"
+#include "audiographer/general/threader.h"
+
+using namespace AudioGrapher;
+
+/* Exports one source to 16 formats, once through a Threader and once
+ * calling each converter in turn, and prints how long each took.
+ * Asserts only that every format got the data.
+ */
+class ThreaderBenchmark : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE (ThreaderBenchmark);
+  CPPUNIT_TEST (testSixteenFormats);
+  CPPUNIT_TEST_SUITE_END ();
+
+  public:
+	void setUp()
+	{
+		channels = 2;
+		frames = 8192 * channels;
+		cycles = 350; // ~60 seconds at 48kHz
+		random_data = TestUtils::init_random_data (frames, 1.0);
+
+		thread_pool = new ThreadPool (3);
+		threader.reset (new Threader<float> (*thread_pool));
+
+		int const dither[] = { D_None, D_Rect, D_Tri, D_Shaped };
+
+		for (unsigned int i = 0; i < 4; ++i) {
+			add_format<int32_t> (dither[i], 32);
+			add_format<int32_t> (dither[i], 24);
+			add_format<int16_t> (dither[i], 16);
+		}
+		add_format<uint8_t> (D_None, 8);
+		add_format<uint8_t> (D_Tri, 8);
+		add_format<float> (D_None, 32);
+		add_format<float> (D_None, 32);
+	}
+
+	void tearDown()
+	{
+		delete [] random_data;
+
+		threader.reset ();
+		formats.clear ();
+		sinks.clear ();
+		delete thread_pool;
+	}
+
+	void testSixteenFormats()
+	{
+		CPPUNIT_ASSERT_EQUAL ((size_t) 16, formats.size ());
+
+		ProcessContext<float> c (random_data, frames, channels);
+
+		gint64 start = g_get_monotonic_time ();
+		for (unsigned int n = 0; n < cycles; ++n) {
+			threader->process (c);
+		}
+		gint64 const threaded = g_get_monotonic_time () - start;
+
+		start = g_get_monotonic_time ();
+		for (unsigned int n = 0; n < cycles; ++n) {
+			for (FormatList::iterator i = formats.begin(); i != formats.end(); ++i) {
+				(*i)->process (c);
+			}
+		}
+		gint64 const serial = g_get_monotonic_time () - start;
+
+		std::cout << std::endl
+		          << "16 formats, " << cycles << " x " << frames / channels << " frames: "
+		          << "threaded (3 threads + caller) " << threaded / 1000 << " ms, "
+		          << "serial " << serial / 1000 << " ms"
+		          << std::endl;
+
+		for (SinkList::iterator i = sinks.begin(); i != sinks.end(); ++i) {
+			CPPUNIT_ASSERT_EQUAL (frames, (*i)->frames ());
+		}
+	}
+
+  private:
+
+	struct CountingSink
+	{
+		virtual ~CountingSink () {}
+		virtual framecnt_t frames () const = 0;
+	};
+
+	template<typename T>
+	struct FormatSink : public VectorSink<T>, public CountingSink
+	{
+		framecnt_t frames () const { return VectorSink<T>::data.size (); }
+	};
+
+	template<typename T>
+	void add_format (int dither_type, int data_width)
+	{
+		boost::shared_ptr<SampleFormatConverter<T> > converter (new SampleFormatConverter<T> (channels));
+		boost::shared_ptr<FormatSink<T> > sink (new FormatSink<T> ());
+
+		converter->init (frames, dither_type, data_width);
+		converter->add_output (sink);
+		threader->add_output (converter);
+
+		formats.push_back (converter);
+		sinks.push_back (sink);
+	}
+
+	typedef std::vector<boost::shared_ptr<Sink<float> > > FormatList;
+	typedef std::vector<boost::shared_ptr<CountingSink> > SinkList;
+
+	ThreadPool * thread_pool;
+	boost::shared_ptr<Threader<float> > threader;
+
+	FormatList formats;
+	SinkList sinks;
+
+	float * random_data;
+	framecnt_t frames;
+	ChannelCount channels;
+	unsigned int cycles;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION (ThreaderBenchmark);
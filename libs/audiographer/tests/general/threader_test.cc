@@ -22,7 +22,7 @@ class ThreaderTest : public CppUnit::TestFixture
 		zero_data = new float[frames];
 		memset (zero_data, 0, frames * sizeof(float));
 
-		thread_pool = new Glib::ThreadPool (3);
+		thread_pool = new ThreadPool (3);
 		threader.reset (new Threader<float> (*thread_pool));
 
 		sink_a.reset (new VectorSink<float>());
@@ -40,7 +40,6 @@ class ThreaderTest : public CppUnit::TestFixture
 		delete [] random_data;
 		delete [] zero_data;
 
-		thread_pool->shutdown();
 		delete thread_pool;
 	}
 
@@ -135,7 +134,7 @@ class ThreaderTest : public CppUnit::TestFixture
 	}
 
   private:
-	Glib::ThreadPool * thread_pool;
+	ThreadPool * thread_pool;
 
 	boost::shared_ptr<Threader<float> > threader;
 	boost::shared_ptr<VectorSink<float> > sink_a;
@@ -1364,8 +1364,11 @@ DummyAudioBackend::main_process_thread ()
 				Glib::usleep (100); // don't hog cpu
 			}
 		} else {
+			/* no need to pause: when freewheeling, the Session waits
+			 * for the butler itself, and a faster-than-realtime render
+			 * wants all the CPU it can get.
+			 */
 			_dsp_load = 1.0f;
-			Glib::usleep (100); // don't hog cpu
 		}
 
 		/* beginning of next cycle */
@@ -21,6 +21,7 @@
 
 #include <cassert>
 #include <list>
+#include <vector>
 #include <stdint.h>
 
 #include <boost/pool/pool.hpp>
@@ -28,6 +29,7 @@
 
 #include <glibmm/threads.h>
 
+#include "pbd/rcu.h"
 #include "pbd/signals.h"
 
 #include "evoral/visibility.h"
@@ -83,6 +85,31 @@ public:
 	typedef EventList::const_iterator const_iterator;
 	typedef EventList::const_reverse_iterator const_reverse_iterator;
 
+	/** A copy of the events, sorted by time, in contiguous arrays.
+	 *
+	 *  EventList is what gets edited: its iterators stay valid while
+	 *  other points are added and removed, which editors rely on. All
+	 *  evaluation is done on Points instead, with binary searches.
+	 *
+	 *  Points are rebuilt when they are next read after the list has
+	 *  changed, so a series of edits costs one rebuild, and published
+	 *  read-copy-update style, so realtime readers can use them
+	 *  without taking the lock.
+	 */
+	struct Points {
+		std::vector<double> when;
+		std::vector<double> value;
+		std::vector<double> coeff; ///< Curve coefficients, 4 per point, or empty if not solved
+
+		size_t size () const { return when.size (); }
+		bool empty () const { return when.empty (); }
+
+		/** @return index of the first point at or after @param x */
+		size_t lower_bound (double x) const;
+		/** @return index of the first point after @param x */
+		size_t upper_bound (double x) const;
+	};
+
 	ControlList (const Parameter& id, const ParameterDescriptor& desc);
 	ControlList (const ControlList&);
 	ControlList (const ControlList&, double start, double end);
@@ -217,56 +244,42 @@ public:
 	 */
 	double eval (double where) {
 		Glib::Threads::RWLock::ReaderLock lm (_lock);
-		return unlocked_eval (where);
+		return points_eval (*current_points (), where);
 	}
 
-	/** realtime safe version of eval, may fail if read-lock cannot be taken
+	/** realtime safe version of eval, which does not need the lock
 	 * @param where absolute time in samples
-	 * @param ok boolean reference if returned value is valid
+	 * @param ok boolean reference if returned value is valid (always true)
 	 * @returns parameter value
 	 */
 	double rt_safe_eval (double where, bool& ok) {
-
-		Glib::Threads::RWLock::ReaderLock lm (_lock, Glib::Threads::TRY_LOCK);
-
-		if ((ok = lm.locked())) {
-			return unlocked_eval (where);
-		} else {
-			return 0.0;
-		}
+		ok = true;
+		return points_eval (*points (), where);
 	}
 
 	static inline bool time_comparator (const ControlEvent* a, const ControlEvent* b) {
 		return a->when < b->when;
 	}
 
-	/** Lookup cache for eval functions, range contains equivalent values */
-	struct LookupCache {
-		LookupCache() : left(-1) {}
-		double left;  /* leftmost x coordinate used when finding "range" */
-		std::pair<ControlList::const_iterator,ControlList::const_iterator> range;
-	};
-
-	/** Lookup cache for point finding, range contains points after left */
-	struct SearchCache {
-		SearchCache () : left(-1) {}
-		double left;  /* leftmost x coordinate used when finding "first" */
-		ControlList::const_iterator first;
-	};
-
 	const EventList& events() const { return _events; }
 	double default_value() const { return _default_value; }
 
+	/** @return the most recently published Points. Any thread may call
+	 *  this, and use the result for as long as it likes, without holding
+	 *  the lock. Editors publish when they are done, or on thaw() if the
+	 *  list is frozen; this never rebuilds anything, so it is realtime safe.
+	 */
+	boost::shared_ptr<const Points> points () const;
+
+	/** As points(), but first brings them up to date if a change has not
+	 *  been published yet. Not realtime safe; the lock must be held.
+	 */
+	boost::shared_ptr<const Points> current_points () const;
+
 	// FIXME: const violations for Curve
 	Glib::Threads::RWLock& lock()       const { return _lock; }
-	LookupCache& lookup_cache() const { return _lookup_cache; }
-	SearchCache& search_cache() const { return _search_cache; }
 
-	/** Called by locked entry point and various private
-	 * locations where we already hold the lock.
-	 *
-	 * FIXME: Should this be private?  Curve needs it..
-	 */
+	/** As eval(), for callers that already hold the lock. */
 	double unlocked_eval (double x) const;
 
 	bool rt_safe_earliest_event (double start, double& x, double& y, bool start_inclusive=false) const;
@@ -318,10 +331,15 @@ public:
 
 protected:
 
-	/** Called by unlocked_eval() to handle cases of 3 or more control points. */
-	double multipoint_eval (double x) const;
+	double points_eval (Points const &, double x) const;
+
+	/** Called by points_eval() to handle cases of 3 or more control points. */
+	double multipoint_eval (Points const &, double x) const;
 
-	void build_search_cache_if_necessary (double start) const;
+	/** Publish new Points if the list has changed. _lock must be held,
+	 *  for writing unless the caller is a non-realtime reader.
+	 */
+	void update_points () const;
 
 	boost::shared_ptr<ControlList> cut_copy_clear (double, double, int op);
 	bool erase_range_internal (double start, double end, EventList &);
@@ -334,11 +352,12 @@ protected:
 
 	void _x_scale (double factor);
 
-	mutable LookupCache   _lookup_cache;
-	mutable SearchCache   _search_cache;
-
 	mutable Glib::Threads::RWLock _lock;
 
+	mutable SerializedRCUManager<Points> _points;
+	mutable Glib::Threads::Mutex _points_lock; ///< serializes update_points()
+	mutable gint                 _points_dirty; ///< set if _events has changed since _points were built
+
 	Parameter             _parameter;
 	ParameterDescriptor   _desc;
 	InterpolationStyle    _interpolation;
@@ -20,20 +20,28 @@
 #define EVORAL_CURVE_HPP
 
 #include <inttypes.h>
+#include <vector>
+#include <boost/shared_ptr.hpp>
 #include <boost/utility.hpp>
+#include <glibmm/threads.h>
 
 #include "evoral/visibility.h"
+#include "evoral/ControlList.hpp"
 
 namespace Evoral {
 
-class ControlList;
-
 class LIBEVORAL_API Curve : public boost::noncopyable
 {
 public:
 	Curve (const ControlList& cl);
 
 	bool rt_safe_get_vector (double x0, double x1, float *arg, int32_t veclen);
+
+	/** As rt_safe_get_vector(), but brings the list's Points up to date
+	 *  first.  The result is kept, so asking for the same range again
+	 *  (as AudioRegion::read_at() does for each channel of a region) is
+	 *  a copy until the list is next changed.
+	 */
 	void get_vector (double x0, double x1, float *arg, int32_t veclen);
 
 	void solve ();
@@ -41,12 +49,28 @@ public:
 	void mark_dirty() const { _dirty = true; }
 
 private:
-	double multipoint_eval (double x);
+	double multipoint_eval (ControlList::Points const &, size_t lo, double x);
 
-	void _get_vector (double x0, double x1, float *arg, int32_t veclen);
+	void _get_vector (ControlList::Points const &, double x0, double x1, float *arg, int32_t veclen);
 
 	mutable bool       _dirty;
 	const ControlList& _list;
+
+	/** The most recent get_vector() result */
+	struct Rendered {
+		Rendered () : x0 (0), x1 (0) {}
+
+		boost::shared_ptr<const ControlList::Points> points; ///< what it was computed from
+		double             x0;
+		double             x1;
+		std::vector<float> values;
+	};
+
+	/** longest get_vector() result that is kept */
+	static const int32_t max_rendered = 65536;
+
+	Rendered             _rendered;
+	Glib::Threads::Mutex _rendered_lock;
 };
 
 } // namespace Evoral
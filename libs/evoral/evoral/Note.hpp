@@ -105,7 +105,12 @@ public:
 	inline const Event<Time>& off_event() const { return _off_event; }
 
 private:
-	// Event buffers are self-contained
+	/* The events do not own their buffers: a model may hold millions of
+	 * notes, and two heap allocations of 3 bytes each per note add up.
+	 */
+	uint8_t _on_event_buffer[3];
+	uint8_t _off_event_buffer[3];
+
 	Event<Time> _on_event;
 	Event<Time> _off_event;
 };
@@ -323,9 +323,12 @@ protected:
 		return 0;
 	}
 
-	typedef std::multiset<NotePtr, NoteNumberComparator>  Pitches;
-	inline       Pitches& pitches(uint8_t chan)       { return _pitches[chan&0xf]; }
-	inline const Pitches& pitches(uint8_t chan) const { return _pitches[chan&0xf]; }
+	/** The notes of one pitch on one channel, in the order they were added. */
+	typedef std::vector<NotePtr> Pitches;
+	inline const Pitches& pitches(uint8_t chan, uint8_t note) const {
+		const std::vector<Pitches>& c (_pitches[chan&0xf]);
+		return c.empty() ? _no_pitches : c[note&0x7f];
+	}
 
 	virtual void control_list_marked_dirty ();
 
@@ -341,15 +344,19 @@ private:
 	void append_sysex_unlocked(const Event<Time>& ev, Evoral::event_id_t);
 	void append_patch_change_unlocked(const PatchChange<Time>&, Evoral::event_id_t);
 
+	void add_pitch_unlocked (const NotePtr&);
+	bool remove_pitch_unlocked (const constNotePtr&);
+
 	void get_notes_by_pitch (Notes&, NoteOperator, uint8_t val, int chan_mask = 0) const;
 	void get_notes_by_velocity (Notes&, NoteOperator, uint8_t val, int chan_mask = 0) const;
 
 	const TypeMap& _type_map;
 
-	Notes        _notes;       // notes indexed by time
-	Pitches      _pitches[16]; // notes indexed by channel+pitch
-	SysExes      _sysexes;
-	PatchChanges _patch_changes;
+	Notes                _notes;       // notes indexed by time
+	std::vector<Pitches> _pitches[16]; // notes indexed by channel+pitch (empty until the channel has notes)
+	Pitches              _no_pitches;
+	SysExes              _sysexes;
+	PatchChanges         _patch_changes;
 
 	typedef std::multiset<NotePtr, EarlierNoteComparator> WriteNotes;
 	WriteNotes _write_notes[16];
@@ -27,6 +27,7 @@
 #define isnan_local std::isnan
 #endif
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
@@ -52,7 +53,9 @@ inline bool event_time_less_than (ControlEvent* a, ControlEvent* b)
 }
 
 ControlList::ControlList (const Parameter& id, const ParameterDescriptor& desc)
-	: _parameter(id)
+	: _points (new Points)
+	, _points_dirty (0)
+	, _parameter(id)
 	, _desc(desc)
 	, _curve(0)
 {
@@ -62,11 +65,6 @@ ControlList::ControlList (const Parameter& id, const ParameterDescriptor& desc)
 	_min_yval = desc.lower;
 	_max_yval = desc.upper;
 	_default_value = desc.normal;
-	_lookup_cache.left = -1;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
-	_search_cache.left = -1;
-	_search_cache.first = _events.end();
 	_sort_pending = false;
 	new_write_pass = true;
 	_in_write_pass = false;
@@ -76,7 +74,9 @@ ControlList::ControlList (const Parameter& id, const ParameterDescriptor& desc)
 }
 
 ControlList::ControlList (const ControlList& other)
-	: _parameter(other._parameter)
+	: _points (new Points)
+	, _points_dirty (0)
+	, _parameter(other._parameter)
 	, _desc(other._desc)
 	, _interpolation(other._interpolation)
 	, _curve(0)
@@ -86,9 +86,6 @@ ControlList::ControlList (const ControlList& other)
 	_min_yval = other._min_yval;
 	_max_yval = other._max_yval;
 	_default_value = other._default_value;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
-	_search_cache.first = _events.end();
 	_sort_pending = false;
 	new_write_pass = true;
 	_in_write_pass = false;
@@ -102,7 +99,9 @@ ControlList::ControlList (const ControlList& other)
 }
 
 ControlList::ControlList (const ControlList& other, double start, double end)
-	: _parameter(other._parameter)
+	: _points (new Points)
+	, _points_dirty (0)
+	, _parameter(other._parameter)
 	, _desc(other._desc)
 	, _interpolation(other._interpolation)
 	, _curve(0)
@@ -112,9 +111,6 @@ ControlList::ControlList (const ControlList& other, double start, double end)
 	_min_yval = other._min_yval;
 	_max_yval = other._max_yval;
 	_default_value = other._default_value;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
-	_search_cache.first = _events.end();
 	_sort_pending = false;
 
 	/* now grab the relevant points, and shift them back if necessary */
@@ -212,6 +208,10 @@ ControlList::maybe_signal_changed ()
 
 	if (_frozen) {
 		_changed_when_thawed = true;
+	} else {
+		/* publish the change here, so that realtime readers never have to */
+		Glib::Threads::RWLock::WriterLock lm (_lock);
+		update_points ();
 	}
 }
 
@@ -258,6 +258,10 @@ ControlList::_x_scale (double factor)
 	}
 
 	mark_dirty ();
+
+	if (!_frozen) {
+		update_points ();
+	}
 }
 
 struct ControlEventTimeComparator {
@@ -341,6 +345,10 @@ ControlList::fast_simple_add (double when, double value)
 	_events.insert (_events.end(), new ControlEvent (when, value));
 
 	mark_dirty ();
+
+	if (!_frozen) {
+		update_points ();
+	}
 }
 
 void
@@ -465,42 +473,47 @@ ControlList::editor_add (double when, double value, bool with_guard)
 	/* this is for making changes from a graphical line editor
 	*/
 
-	ControlEvent cp (when, 0.0f);
-	iterator i = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
+	{
+		Glib::Threads::RWLock::WriterLock lm (_lock);
 
-	if (i != _events.end () && (*i)->when == when) {
-		return false;
-	}
+		ControlEvent cp (when, 0.0f);
+		iterator i = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
 
-	if (_events.empty()) {
+		if (i != _events.end () && (*i)->when == when) {
+			return false;
+		}
 
-		/* as long as the point we're adding is not at zero,
-		 * add an "anchor" point there.
-		 */
+		if (_events.empty()) {
 
-		if (when >= 1) {
-			_events.insert (_events.end(), new ControlEvent (0, value));
-			DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added value %2 at zero\n", this, value));
+			/* as long as the point we're adding is not at zero,
+			 * add an "anchor" point there.
+			 */
+
+			if (when >= 1) {
+				_events.insert (_events.end(), new ControlEvent (0, value));
+				DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added value %2 at zero\n", this, value));
+			}
 		}
-	}
 
-	insert_position = when;
-	if (with_guard) {
-		if (when > 64) {
-			add_guard_point (when - 64);
+		insert_position = when;
+		if (with_guard) {
+			if (when > 64) {
+				add_guard_point (when - 64);
+			}
+			maybe_add_insert_guard (when);
 		}
-		maybe_add_insert_guard (when);
-	}
 
-	iterator result;
-	DEBUG_TRACE (DEBUG::ControlList, string_compose ("editor_add: actually add when= %1 value= %2\n", when, value));
-	result = _events.insert (i, new ControlEvent (when, value));
+		iterator result;
+		DEBUG_TRACE (DEBUG::ControlList, string_compose ("editor_add: actually add when= %1 value= %2\n", when, value));
+		result = _events.insert (i, new ControlEvent (when, value));
 
-	if (i == result) {
-		return false;
+		if (i == result) {
+			return false;
+		}
+
+		mark_dirty ();
 	}
 
-	mark_dirty ();
 	maybe_signal_changed ();
 
 	return true;
@@ -943,17 +956,15 @@ ControlList::thaw ()
 			unlocked_invalidate_insert_iterator ();
 			_sort_pending = false;
 		}
+
+		update_points ();
 	}
 }
 
 void
 ControlList::mark_dirty () const
 {
-	_lookup_cache.left = -1;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
-	_search_cache.left = -1;
-	_search_cache.first = _events.end();
+	g_atomic_int_set (&_points_dirty, 1);
 
 	if (_curve) {
 		_curve->mark_dirty();
@@ -1166,40 +1177,122 @@ ControlList::truncate_start (double overall_length)
 	maybe_signal_changed ();
 }
 
+size_t
+ControlList::Points::lower_bound (double x) const
+{
+	return std::lower_bound (when.begin(), when.end(), x) - when.begin();
+}
+
+size_t
+ControlList::Points::upper_bound (double x) const
+{
+	return std::upper_bound (when.begin(), when.end(), x) - when.begin();
+}
+
+/** Rebuild the Points from the event list, if it has changed since the last
+ *  rebuild. Nothing happens while a sort is pending, since the events may be
+ *  out of order; thaw() rebuilds them.
+ *
+ *  Editors call this with _lock held for writing, once they are done, and
+ *  thaw() does for edits made while frozen. Non-realtime readers may call
+ *  it (via current_points()) with _lock held for reading.
+ */
+void
+ControlList::update_points () const
+{
+	Glib::Threads::Mutex::Lock lm (_points_lock);
+
+	if (!g_atomic_int_get (&_points_dirty) || _sort_pending) {
+		return;
+	}
+
+	g_atomic_int_set (&_points_dirty, 0);
+
+	const size_t npoints = _events.size();
+	const bool curved = _interpolation == Curved && npoints > 2;
+
+	if (curved) {
+		if (_curve) {
+			_curve->solve ();
+		} else {
+			/* someone may evaluate us with a Curve of their own */
+			Curve (*this).solve ();
+		}
+	}
+
+	/* everything is replaced, so don't copy the old Points */
+	boost::shared_ptr<Points> p = _points.write_new ();
+
+	p->when.resize (npoints);
+	p->value.resize (npoints);
+
+	if (curved) {
+		p->coeff.resize (npoints * 4, 0.0);
+	}
+
+	size_t n = 0;
+
+	for (const_iterator i = _events.begin(); i != _events.end(); ++i, ++n) {
+		p->when[n] = (*i)->when;
+		p->value[n] = (*i)->value;
+		if (curved && (*i)->coeff) {
+			std::copy ((*i)->coeff, (*i)->coeff + 4, &p->coeff[n * 4]);
+		}
+	}
+
+	_points.update (p);
+}
+
+boost::shared_ptr<const ControlList::Points>
+ControlList::points () const
+{
+	return _points.reader ();
+}
+
+/** @return Points for the list as it is now. Must be called with _lock held
+ *  (for reading, at least); realtime code should use points() instead.
+ */
+boost::shared_ptr<const ControlList::Points>
+ControlList::current_points () const
+{
+	if (g_atomic_int_get (&_points_dirty)) {
+		update_points ();
+	}
+	return _points.reader ();
+}
+
 double
 ControlList::unlocked_eval (double x) const
 {
-	pair<EventList::iterator,EventList::iterator> range;
-	int32_t npoints;
+	return points_eval (*current_points (), x);
+}
+
+double
+ControlList::points_eval (Points const & p, double x) const
+{
+	const size_t npoints = p.size();
 	double lpos, upos;
 	double lval, uval;
 	double fraction;
 
-	const_iterator length_check_iter = _events.begin();
-	for (npoints = 0; npoints < 4; ++npoints, ++length_check_iter) {
-		if (length_check_iter == _events.end()) {
-			break;
-		}
-	}
-
 	switch (npoints) {
 	case 0:
 		return _default_value;
 
 	case 1:
-		return _events.front()->value;
+		return p.value[0];
 
 	case 2:
-		if (x >= _events.back()->when) {
-			return _events.back()->value;
-		} else if (x <= _events.front()->when) {
-			return _events.front()->value;
+		if (x >= p.when[1]) {
+			return p.value[1];
+		} else if (x <= p.when[0]) {
+			return p.value[0];
 		}
 
-		lpos = _events.front()->when;
-		lval = _events.front()->value;
-		upos = _events.back()->when;
-		uval = _events.back()->value;
+		lpos = p.when[0];
+		lval = p.value[0];
+		upos = p.when[1];
+		uval = p.value[1];
 
 		if (_interpolation == Discrete) {
 			return lval;
@@ -1210,13 +1303,13 @@ ControlList::unlocked_eval (double x) const
 		return lval + (fraction * (uval - lval));
 
 	default:
-		if (x >= _events.back()->when) {
-			return _events.back()->value;
-		} else if (x <= _events.front()->when) {
-			return _events.front()->value;
+		if (x >= p.when[npoints - 1]) {
+			return p.value[npoints - 1];
+		} else if (x <= p.when[0]) {
+			return p.value[0];
 		}
 
-		return multipoint_eval (x);
+		return multipoint_eval (p, x);
 	}
 
 	abort(); /*NOTREACHED*/ /* stupid gcc */
@@ -1224,103 +1317,47 @@ ControlList::unlocked_eval (double x) const
 }
 
 double
-ControlList::multipoint_eval (double x) const
+ControlList::multipoint_eval (Points const & p, double x) const
 {
 	double upos, lpos;
 	double uval, lval;
 	double fraction;
 
-	/* "Stepped" lookup (no interpolation) */
-	/* FIXME: no cache.  significant? */
-	if (_interpolation == Discrete) {
-		const ControlEvent cp (x, 0);
-		EventList::const_iterator i = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
+	const size_t lo = p.lower_bound (x);
 
-		// shouldn't have made it to multipoint_eval
-		assert(i != _events.end());
+	// shouldn't have made it to multipoint_eval
+	assert (lo < p.size());
 
-		if (i == _events.begin() || (*i)->when == x)
-			return (*i)->value;
-		else
-			return (*(--i))->value;
+	/* "Stepped" lookup (no interpolation) */
+	if (_interpolation == Discrete) {
+		if (lo == 0 || p.when[lo] == x) {
+			return p.value[lo];
+		} else {
+			return p.value[lo - 1];
+		}
 	}
 
-	/* Only do the range lookup if x is in a different range than last time
-	 * this was called (or if the lookup cache has been marked "dirty" (left<0) */
-	if ((_lookup_cache.left < 0) ||
-	    ((_lookup_cache.left > x) ||
-	     (_lookup_cache.range.first == _events.end()) ||
-	     ((*_lookup_cache.range.second)->when < x))) {
-
-		const ControlEvent cp (x, 0);
-
-		_lookup_cache.range = equal_range (_events.begin(), _events.end(), &cp, time_comparator);
+	if (p.when[lo] == x) {
+		/* x is a control point in the data */
+		return p.value[lo];
 	}
 
-	pair<const_iterator,const_iterator> range = _lookup_cache.range;
-
-	if (range.first == range.second) {
-
-		/* x does not exist within the list as a control point */
-
-		_lookup_cache.left = x;
-
-		if (range.first != _events.begin()) {
-			--range.first;
-			lpos = (*range.first)->when;
-			lval = (*range.first)->value;
-		}  else {
-			/* we're before the first point */
-			// return _default_value;
-			return _events.front()->value;
-		}
-
-		if (range.second == _events.end()) {
-			/* we're after the last point */
-			return _events.back()->value;
-		}
-
-		upos = (*range.second)->when;
-		uval = (*range.second)->value;
-
-		/* linear interpolation betweeen the two points
-		   on either side of x
-		*/
-
-		fraction = (double) (x - lpos) / (double) (upos - lpos);
-		return lval + (fraction * (uval - lval));
-
+	if (lo == 0) {
+		/* we're before the first point */
+		return p.value[0];
 	}
 
-	/* x is a control point in the data */
-	_lookup_cache.left = -1;
-	return (*range.first)->value;
-}
-
-void
-ControlList::build_search_cache_if_necessary (double start) const
-{
-	if (_events.empty()) {
-		/* Empty, nothing to cache, move to end. */
-		_search_cache.first = _events.end();
-		_search_cache.left = 0;
-		return;
-	} else if ((_search_cache.left < 0) || (_search_cache.left > start)) {
-		/* Marked dirty (left < 0), or we're too far forward, re-search. */
-
-		const ControlEvent start_point (start, 0);
-
-		_search_cache.first = lower_bound (_events.begin(), _events.end(), &start_point, time_comparator);
-		_search_cache.left = start;
-	}
+	/* linear interpolation betweeen the two points
+	   on either side of x
+	*/
 
-	/* We now have a search cache that is not too far right, but it may be too
-	   far left and need to be advanced. */
+	lpos = p.when[lo - 1];
+	lval = p.value[lo - 1];
+	upos = p.when[lo];
+	uval = p.value[lo];
 
-	while (_search_cache.first != end() && (*_search_cache.first)->when < start) {
-		++_search_cache.first;
-	}
-	_search_cache.left = start;
+	fraction = (double) (x - lpos) / (double) (upos - lpos);
+	return lval + (fraction * (uval - lval));
 }
 
 /** Get the earliest event after \a start using the current interpolation style.
@@ -1333,12 +1370,7 @@ ControlList::build_search_cache_if_necessary (double start) const
 bool
 ControlList::rt_safe_earliest_event (double start, double& x, double& y, bool inclusive) const
 {
-	// FIXME: It would be nice if this was unnecessary..
-	Glib::Threads::RWLock::ReaderLock lm(_lock, Glib::Threads::TRY_LOCK);
-	if (!lm.locked()) {
-		return false;
-	}
-
+	/* works on the current Points, so no lock is needed */
 	return rt_safe_earliest_event_unlocked (start, x, y, inclusive);
 }
 
@@ -1371,35 +1403,20 @@ ControlList::rt_safe_earliest_event_unlocked (double start, double& x, double& y
 bool
 ControlList::rt_safe_earliest_event_discrete_unlocked (double start, double& x, double& y, bool inclusive) const
 {
-	build_search_cache_if_necessary (start);
+	boost::shared_ptr<const Points> p = points ();
 
-	if (_search_cache.first != _events.end()) {
-		const ControlEvent* const first = *_search_cache.first;
-
-		const bool past_start = (inclusive ? first->when >= start : first->when > start);
-
-		/* Earliest points is in range, return it */
-		if (past_start) {
-
-			x = first->when;
-			y = first->value;
-
-			/* Move left of cache to this point
-			 * (Optimize for immediate call this cycle within range) */
-			_search_cache.left = x;
-			++_search_cache.first;
-
-			assert(x >= start);
-			return true;
-
-		} else {
-			return false;
-		}
+	const size_t i = inclusive ? p->lower_bound (start) : p->upper_bound (start);
 
+	if (i == p->size()) {
 		/* No points in range */
-	} else {
 		return false;
 	}
+
+	x = p->when[i];
+	y = p->value[i];
+
+	assert (inclusive ? x >= start : x > start);
+	return true;
 }
 
 /** Get the earliest time the line crosses an integer (Linear interpolation).
@@ -1414,115 +1431,102 @@ ControlList::rt_safe_earliest_event_linear_unlocked (double start, double& x, do
 {
 	// cout << "earliest_event(start: " << start << ", x: " << x << ", y: " << y << ", inclusive: " << inclusive <<  ")" << endl;
 
-	const_iterator length_check_iter = _events.begin();
-	if (_events.empty()) { // 0 events
+	boost::shared_ptr<const Points> p = points ();
+	const size_t npoints = p->size();
+
+	if (npoints == 0) {
 		return false;
-	} else if (_events.end() == ++length_check_iter) { // 1 event
+	} else if (npoints == 1) {
 		return rt_safe_earliest_event_discrete_unlocked (start, x, y, inclusive);
 	}
 
-	// Hack to avoid infinitely repeating the same event
-	build_search_cache_if_necessary (start);
+	size_t i = p->lower_bound (start);
 
-	if (_search_cache.first != _events.end()) {
+	if (i == npoints) {
+		/* No points in the future, so no steps (towards them) in the future */
+		return false;
+	}
 
-		const ControlEvent* first = NULL;
-		const ControlEvent* next = NULL;
+	size_t first;
 
-		if (_search_cache.first == _events.begin() || (*_search_cache.first)->when <= start) {
-			/* Step is after first */
-			first = *_search_cache.first;
-			++_search_cache.first;
-			if (_search_cache.first == _events.end()) {
-				return false;
-			}
-			next = *_search_cache.first;
+	if (p->when[i] == start) {
+		/* Step is after first. If there are several points at start
+		 * (a jump), step from the last of them.
+		 */
+		first = p->upper_bound (start) - 1;
+	} else if (i == 0) {
+		/* Step is after first */
+		first = 0;
+	} else {
+		/* Step is before first */
+		first = i - 1;
+	}
 
-		} else {
-			/* Step is before first */
-			const_iterator prev = _search_cache.first;
-			--prev;
-			first = *prev;
-			next = *_search_cache.first;
-		}
+	const size_t next = first + 1;
 
-		if (inclusive && first->when == start) {
-			x = first->when;
-			y = first->value;
-			/* Move left of cache to this point
-			 * (Optimize for immediate call this cycle within range) */
-			_search_cache.left = x;
+	if (next == npoints) {
+		return false;
+	}
+
+	const double first_when = p->when[first];
+	const double first_value = p->value[first];
+	const double next_when = p->when[next];
+	const double next_value = p->value[next];
+
+	if (inclusive && first_when == start) {
+		x = first_when;
+		y = first_value;
+		return true;
+	} else if (next_when < start || (!inclusive && next_when == start)) {
+		/* "Next" is before the start, no points left. */
+		return false;
+	}
+
+	if (fabs(first_value - next_value) <= 1) {
+		if (next_when > start) {
+			x = next_when;
+			y = next_value;
 			return true;
-		} else if (next->when < start || (!inclusive && next->when == start)) {
-			/* "Next" is before the start, no points left. */
+		} else {
 			return false;
 		}
+	}
 
-		if (fabs(first->value - next->value) <= 1) {
-			if (next->when > start) {
-				x = next->when;
-				y = next->value;
-				/* Move left of cache to this point
-				 * (Optimize for immediate call this cycle within range) */
-				_search_cache.left = x;
-				return true;
-			} else {
-				return false;
-			}
-		}
-
-		const double slope = (next->value - first->value) / (double)(next->when - first->when);
-		//cerr << "start y: " << start_y << endl;
-
-		//y = first->value + (slope * fabs(start - first->when));
-		y = first->value;
+	const double slope = (next_value - first_value) / (double)(next_when - first_when);
 
-		if (first->value < next->value) // ramping up
-			y = ceil(y);
-		else // ramping down
-			y = floor(y);
+	y = first_value;
 
-		x = first->when + (y - first->value) / (double)slope;
+	if (first_value < next_value) // ramping up
+		y = ceil(y);
+	else // ramping down
+		y = floor(y);
 
-		while ((inclusive && x < start) || (x <= start && y != next->value)) {
+	x = first_when + (y - first_value) / (double)slope;
 
-			if (first->value < next->value) // ramping up
-				y += 1.0;
-			else // ramping down
-				y -= 1.0;
+	while ((inclusive && x < start) || (x <= start && y != next_value)) {
 
-			x = first->when + (y - first->value) / (double)slope;
-		}
+		if (first_value < next_value) // ramping up
+			y += 1.0;
+		else // ramping down
+			y -= 1.0;
 
-		/*cerr << first->value << " @ " << first->when << " ... "
-		  << next->value << " @ " << next->when
-		  << " = " << y << " @ " << x << endl;*/
+		x = first_when + (y - first_value) / (double)slope;
+	}
 
-		assert(    (y >= first->value && y <= next->value)
-		           || (y <= first->value && y >= next->value) );
+	assert(    (y >= first_value && y <= next_value)
+	           || (y <= first_value && y >= next_value) );
 
+	const bool past_start = (inclusive ? x >= start : x > start);
 
-		const bool past_start = (inclusive ? x >= start : x > start);
-		if (past_start) {
-			/* Move left of cache to this point
-			 * (Optimize for immediate call this cycle within range) */
-			_search_cache.left = x;
-			assert(inclusive ? x >= start : x > start);
-			return true;
+	if (!past_start) {
+		if (inclusive) {
+			x = next_when;
 		} else {
-			if (inclusive) {
-				x = next->when;
-			} else {
-				x = start;
-			}
-			_search_cache.left = x;
-			return true;
+			x = start;
 		}
-
-	} else {
-		/* No points in the future, so no steps (towards them) in the future */
-		return false;
 	}
+
+	return true;
 }
 
 
@@ -1779,7 +1783,14 @@ ControlList::set_interpolation (InterpolationStyle s)
 		return;
 	}
 
-	_interpolation = s;
+	{
+		Glib::Threads::RWLock::WriterLock lm (_lock);
+		_interpolation = s;
+		/* Curved needs coefficients, the others don't */
+		g_atomic_int_set (&_points_dirty, 1);
+		update_points ();
+	}
+
 	InterpolationChanged (s); /* EMIT SIGNAL */
 }
 
@@ -20,6 +20,7 @@
 #include <float.h>
 #include <cmath>
 #include <climits>
+#include <cstring>
 #include <cfloat>
 #include <cmath>
 #include <vector>
@@ -171,25 +172,46 @@ Curve::solve ()
 bool
 Curve::rt_safe_get_vector (double x0, double x1, float *vec, int32_t veclen)
 {
-	Glib::Threads::RWLock::ReaderLock lm(_list.lock(), Glib::Threads::TRY_LOCK);
-
-	if (!lm.locked()) {
-		return false;
-	} else {
-		_get_vector (x0, x1, vec, veclen);
-		return true;
-	}
+	/* the list's Points are immutable, so no lock is needed */
+	_get_vector (*_list.points(), x0, x1, vec, veclen);
+	return true;
 }
 
 void
 Curve::get_vector (double x0, double x1, float *vec, int32_t veclen)
 {
-	Glib::Threads::RWLock::ReaderLock lm(_list.lock());
-	_get_vector (x0, x1, vec, veclen);
+	boost::shared_ptr<const ControlList::Points> p;
+
+	{
+		Glib::Threads::RWLock::ReaderLock lm (_list.lock());
+		p = _list.current_points ();
+	}
+
+	/* the Points are immutable, so the lock is only needed for _rendered;
+	 * if another thread is using it, don't wait, just do the work.
+	 */
+
+	Glib::Threads::Mutex::Lock lm (_rendered_lock, Glib::Threads::TRY_LOCK);
+
+	if (lm.locked() && _rendered.points == p && _rendered.x0 == x0 && _rendered.x1 == x1 && _rendered.values.size() == (size_t) veclen) {
+		memcpy (vec, &_rendered.values[0], sizeof (float) * veclen);
+		return;
+	}
+
+	_get_vector (*p, x0, x1, vec, veclen);
+
+	/* trivial lists are quicker to compute than to copy */
+
+	if (lm.locked() && p->size() > 1 && veclen > 0 && veclen <= max_rendered) {
+		_rendered.points = p;
+		_rendered.x0 = x0;
+		_rendered.x1 = x1;
+		_rendered.values.assign (vec, vec + veclen);
+	}
 }
 
 void
-Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
+Curve::_get_vector (ControlList::Points const & p, double x0, double x1, float *vec, int32_t veclen)
 {
 	double rx, lx, hx, max_x, min_x;
 	int32_t i;
@@ -200,7 +222,7 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 		return;
 	}
 
-	if ((npoints = _list.events().size()) == 0) {
+	if ((npoints = p.size()) == 0) {
 		/* no events in list, so just fill the entire array with the default value */
 		for (int32_t i = 0; i < veclen; ++i) {
 			vec[i] = _list.default_value();
@@ -210,20 +232,20 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 
 	if (npoints == 1) {
 		for (int32_t i = 0; i < veclen; ++i) {
-			vec[i] = _list.events().front()->value;
+			vec[i] = p.value[0];
 		}
 		return;
 	}
 
 	/* events is now known not to be empty */
 
-	max_x = _list.events().back()->when;
-	min_x = _list.events().front()->when;
+	max_x = p.when[npoints-1];
+	min_x = p.when[0];
 
 	if (x0 > max_x) {
 		/* totally past the end - just fill the entire array with the final value */
 		for (int32_t i = 0; i < veclen; ++i) {
-			vec[i] = _list.events().back()->value;
+			vec[i] = p.value[npoints-1];
 		}
 		return;
 	}
@@ -233,7 +255,7 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 		 * the initial value.
 		 */
 		for (int32_t i = 0; i < veclen; ++i) {
-			vec[i] = _list.events().front()->value;
+			vec[i] = p.value[0];
 		}
 		return;
 	}
@@ -252,7 +274,7 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 		fill_len = min (fill_len, (int64_t)veclen);
 
 		for (i = 0; i < fill_len; ++i) {
-			vec[i] = _list.events().front()->value;
+			vec[i] = p.value[0];
 		}
 
 		veclen -= fill_len;
@@ -268,7 +290,7 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 		float val;
 
 		fill_len = min (fill_len, (int64_t)veclen);
-		val = _list.events().back()->value;
+		val = p.value[npoints-1];
 
 		for (i = veclen - fill_len; i < veclen; ++i) {
 			vec[i] = val;
@@ -290,11 +312,11 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 		*/
 
 		/* gradient of the line */
-		double const m_num = _list.events().back()->value - _list.events().front()->value;
-		double const m_den = _list.events().back()->when - _list.events().front()->when;
+		double const m_num = p.value[npoints-1] - p.value[0];
+		double const m_den = p.when[npoints-1] - p.when[0];
 
 		/* y intercept of the line */
-		double const c = double (_list.events().back()->value) - (m_num * _list.events().back()->when / m_den);
+		double const c = double (p.value[npoints-1]) - (m_num * p.when[npoints-1] / m_den);
 
 		/* dx that we are using */
 		double dx_num = 0;
@@ -312,9 +334,9 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 		return;
 	}
 
-	if (_dirty) {
-		solve ();
-	}
+	/* coefficients for Curved interpolation were computed when the Points
+	 * were built, see ControlList::update_points()
+	 */
 
 	rx = lx;
 
@@ -323,84 +345,77 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 		dx = (hx - lx) / (veclen - 1);
 	}
 
+	/* unless x1 < x0, rx only ever increases, so rather than searching
+	 * the Points for each value, walk forward through them.
+	 */
+
+	size_t lo = p.lower_bound (rx);
+
 	for (i = 0; i < veclen; ++i, rx += dx) {
-		vec[i] = multipoint_eval (rx);
+		if (dx < 0) {
+			lo = p.lower_bound (rx);
+		} else {
+			while (lo < (size_t) npoints && p.when[lo] < rx) {
+				++lo;
+			}
+		}
+		vec[i] = multipoint_eval (p, lo, rx);
 	}
 }
 
+/** @param lo index of the first point at or after @param x */
 double
-Curve::multipoint_eval (double x)
+Curve::multipoint_eval (ControlList::Points const & p, size_t lo, double x)
 {
-	pair<ControlList::EventList::const_iterator,ControlList::EventList::const_iterator> range;
-
-	ControlList::LookupCache& lookup_cache = _list.lookup_cache();
-
-	if ((lookup_cache.left < 0) ||
-	    ((lookup_cache.left > x) ||
-	     (lookup_cache.range.first == _list.events().end()) ||
-	     ((*lookup_cache.range.second)->when < x))) {
-
-		ControlEvent cp (x, 0.0);
-
-		lookup_cache.range = equal_range (_list.events().begin(), _list.events().end(), &cp, ControlList::time_comparator);
-	}
-
-	range = lookup_cache.range;
-
 	/* EITHER
 
-	   a) x is an existing control point, so first == existing point, second == next point
+	   a) x is an existing control point, so lo is that point
 
 	   OR
 
-	   b) x is between control points, so range is empty (first == second, points to where
-	       to insert x)
+	   b) x is between control points, so lo is the point after x
 
 	*/
 
-	if (range.first == range.second) {
+	const size_t npoints = p.size();
 
-		/* x does not exist within the list as a control point */
+	if (lo < npoints && p.when[lo] == x) {
+		/* x is a control point in the data */
+		return p.value[lo];
+	}
 
-		lookup_cache.left = x;
+	/* x does not exist within the list as a control point */
 
-		if (range.first == _list.events().begin()) {
-			/* we're before the first point */
-			// return default_value;
-			return _list.events().front()->value;
-		}
+	if (lo == 0) {
+		/* we're before the first point */
+		// return default_value;
+		return p.value[0];
+	}
 
-		if (range.second == _list.events().end()) {
-			/* we're after the last point */
-			return _list.events().back()->value;
-		}
+	if (lo == npoints) {
+		/* we're after the last point */
+		return p.value[npoints-1];
+	}
 
-		ControlEvent* after = (*range.second);
-		range.second--;
-		ControlEvent* before = (*range.second);
+	const size_t after = lo;
+	const size_t before = lo - 1;
 
-		double vdelta = after->value - before->value;
+	double vdelta = p.value[after] - p.value[before];
 
-		if (vdelta == 0.0) {
-			return before->value;
-		}
+	if (vdelta == 0.0) {
+		return p.value[before];
+	}
 
-		double tdelta = x - before->when;
-		double trange = after->when - before->when;
+	double tdelta = x - p.when[before];
+	double trange = p.when[after] - p.when[before];
 
-		if (_list.interpolation() == ControlList::Curved && after->coeff) {
-				ControlEvent* ev = after;
-				double x2 = x * x;
-				return ev->coeff[0] + (ev->coeff[1] * x) + (ev->coeff[2] * x2) + (ev->coeff[3] * x2 * x);
-		} else {
-			return before->value + (vdelta * (tdelta / trange));
-		}
+	if (_list.interpolation() == ControlList::Curved && !p.coeff.empty()) {
+			double const * coeff = &p.coeff[after * 4];
+			double x2 = x * x;
+			return coeff[0] + (coeff[1] * x) + (coeff[2] * x2) + (coeff[3] * x2 * x);
+	} else {
+		return p.value[before] + (vdelta * (tdelta / trange));
 	}
-
-	/* x is a control point in the data */
-	/* invalidate the cached range because its not usable */
-	lookup_cache.left = -1;
-	return (*range.first)->value;
 }
 
 } // namespace Evoral
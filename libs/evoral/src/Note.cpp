@@ -17,6 +17,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <glib.h>
@@ -30,8 +31,8 @@ namespace Evoral {
 
 template<typename Time>
 Note<Time>::Note(uint8_t chan, Time t, Time l, uint8_t n, uint8_t v)
-	: _on_event (MIDI_EVENT, t, 3, NULL, true)
-	, _off_event (MIDI_EVENT, t + l, 3, NULL, true)
+	: _on_event (MIDI_EVENT, t, 3, _on_event_buffer, false)
+	, _off_event (MIDI_EVENT, t + l, 3, _off_event_buffer, false)
 {
 	assert(chan < 16);
 
@@ -54,22 +55,13 @@ Note<Time>::Note(uint8_t chan, Time t, Time l, uint8_t n, uint8_t v)
 
 template<typename Time>
 Note<Time>::Note(const Note<Time>& copy)
-	: _on_event(copy._on_event, true)
-	, _off_event(copy._off_event, true)
+	: _on_event (MIDI_EVENT, copy.time(), 3, _on_event_buffer, false)
+	, _off_event (MIDI_EVENT, copy.end_time(), 3, _off_event_buffer, false)
 {
-	set_id (copy.id());
+	memcpy (_on_event_buffer, copy._on_event_buffer, 3);
+	memcpy (_off_event_buffer, copy._off_event_buffer, 3);
 
-	assert(_on_event.buffer());
-	assert(_off_event.buffer());
-	/*
-	  assert(copy._on_event.size == 3);
-	  _on_event.buffer = _on_event_buffer;
-	  memcpy(_on_event_buffer, copy._on_event_buffer, 3);
-
-	  assert(copy._off_event.size == 3);
-	  _off_event.buffer = _off_event_buffer;
-	  memcpy(_off_event_buffer, copy._off_event_buffer, 3);
-	*/
+	set_id (copy.id());
 
 	assert(time() == copy.time());
 	assert(end_time() == copy.end_time());
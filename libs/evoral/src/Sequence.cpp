@@ -23,6 +23,10 @@
 #include <stdexcept>
 #include <stdint.h>
 #include <cstdio>
+#include <cstring>
+
+#include <boost/make_shared.hpp>
+#include <boost/pool/pool_alloc.hpp>
 
 #if __clang__
 #include "evoral/Note.hpp"
@@ -57,6 +61,38 @@ static double const time_between_interpolated_controller_outputs = 1.0 / 256;
 
 namespace Evoral {
 
+/** Notes made by a Sequence are allocated together with their reference
+ * count, from a pool shared by all sequences.
+ */
+template<typename Time>
+static boost::shared_ptr<Note<Time> >
+make_note (uint8_t chan, Time time, Time length, uint8_t note, uint8_t velocity)
+{
+	return boost::allocate_shared<Note<Time> > (boost::fast_pool_allocator<Note<Time> > (), chan, time, length, note, velocity);
+}
+
+template<typename Time>
+static boost::shared_ptr<Note<Time> >
+make_note (const Note<Time>& copy)
+{
+	return boost::allocate_shared<Note<Time> > (boost::fast_pool_allocator<Note<Time> > (), copy);
+}
+
+/** Copy one of a note's events into @a ev. A note's events do not own their
+ * buffers (see Note), so Event::assign() would leave @a ev pointing into the
+ * note; @a ev keeps (or allocates) its own buffer instead.
+ */
+template<typename Time>
+static void
+copy_note_event (Event<Time>& ev, const Event<Time>& note_ev)
+{
+	ev.realloc (note_ev.size ());
+	memcpy (ev.buffer (), note_ev.buffer (), note_ev.size ());
+	ev.set_event_type (note_ev.event_type ());
+	ev.set_time (note_ev.time ());
+	ev.set_id (note_ev.id ());
+}
+
 // Read iterator (const_iterator)
 
 template<typename Time>
@@ -285,13 +321,13 @@ Sequence<Time>::const_iterator::set_event()
 	switch (_type) {
 	case NOTE_ON:
 		DEBUG_TRACE(DEBUG::Sequence, "iterator = note on\n");
-		_event->assign ((*_note_iter)->on_event());
+		copy_note_event (*_event, (*_note_iter)->on_event());
 		_active_notes.push(*_note_iter);
 		break;
 	case NOTE_OFF:
 		DEBUG_TRACE(DEBUG::Sequence, "iterator = note off\n");
 		assert(!_active_notes.empty());
-		_event->assign (_active_notes.top()->off_event());
+		copy_note_event (*_event, _active_notes.top()->off_event());
 		// We don't pop the active note until we increment past it
 		break;
 	case SYSEX:
@@ -492,8 +528,9 @@ Sequence<Time>::Sequence(const Sequence<Time>& other)
 	, _highest_note(other._highest_note)
 {
 	for (typename Notes::const_iterator i = other._notes.begin(); i != other._notes.end(); ++i) {
-		NotePtr n (new Note<Time> (**i));
+		NotePtr n (make_note (**i));
 		_notes.insert (n);
+		add_pitch_unlocked (n);
 	}
 
 	for (typename SysExes::const_iterator i = other._sysexes.begin(); i != other._sysexes.end(); ++i) {
@@ -611,6 +648,9 @@ Sequence<Time>::clear()
 {
 	WriteLock lock(write_lock());
 	_notes.clear();
+	for (int i = 0; i < 16; ++i) {
+		_pitches[i].clear();
+	}
 	for (Controls::iterator li = _controls.begin(); li != _controls.end(); ++li)
 		li->second->list()->clear();
 }
@@ -662,13 +702,15 @@ Sequence<Time>::end_write (StuckNoteOption option, Time when)
 				break;
 			case DeleteStuckNotes:
 				cerr << "WARNING: Stuck note lost: " << (*n)->note() << endl;
+				remove_pitch_unlocked (*n);
 				_notes.erase(n);
 				break;
 			case ResolveStuckNotes:
 				if (when <= (*n)->time()) {
 					cerr << "WARNING: Stuck note resolution - end time @ "
 					     << when << " is before note on: " << (**n) << endl;
-					_notes.erase (*n);
+					remove_pitch_unlocked (*n);
+					_notes.erase (n);
 				} else {
 					(*n)->set_length (when - (*n)->time());
 					cerr << "WARNING: resolved note-on with no note-off to generate " << (**n) << endl;
@@ -712,7 +754,7 @@ Sequence<Time>::add_note_unlocked(const NotePtr note, void* arg)
 		_highest_note = note->note();
 
 	_notes.insert (note);
-	_pitches[note->channel()].insert (note);
+	add_pitch_unlocked (note);
 
 	_edited = true;
 
@@ -724,7 +766,6 @@ void
 Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 {
 	bool erased = false;
-	bool id_matched = false;
 
 	DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1 remove note #%2 %3 @ %4\n", this, note->id(), (int)note->note(), note->time()));
 
@@ -798,7 +839,6 @@ Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 				}
 
 				erased = true;
-				id_matched = true;
 				break;
 			}
 		}
@@ -806,53 +846,64 @@ Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 
 	if (erased) {
 
-		Pitches& p (pitches (note->channel()));
-
-		typename Pitches::iterator j;
+		if (!remove_pitch_unlocked (note)) {
+			warning << string_compose ("erased note %1 not found in pitches for channel %2", *note, (int) note->channel()) << endmsg;
+		}
 
-		/* if we had to ID-match above, we can't expect to find it in
-		 * pitches via note comparison either. so do another linear
-		 * search to locate it. otherwise, we can use the note index
-		 * to potentially speed things up.
-		 */
+		_edited = true;
 
-		if (id_matched) {
+	} else {
+		cerr << "Unable to find note to erase matching " << *note.get() << endmsg;
+	}
+}
 
-			for (j = p.begin(); j != p.end(); ++j) {
-				if ((*j)->id() == note->id()) {
-					p.erase (j);
-					break;
-				}
-			}
+template<typename Time>
+void
+Sequence<Time>::add_pitch_unlocked (const NotePtr& note)
+{
+	std::vector<Pitches>& c (_pitches[note->channel()]);
 
-		} else {
+	if (c.empty()) {
+		c.resize (128);
+	}
 
-			/* Now find the same note in the "pitches" list (which indexes
-			 * notes by channel+time. We care only about its note number
-			 * so the search_note has all other properties unset.
-			 */
+	c[note->note()].push_back (note);
+}
 
-			NotePtr search_note (new Note<Time>(0, Time(), Time(), note->note(), 0));
+template<typename Time>
+bool
+Sequence<Time>::remove_pitch_unlocked (const constNotePtr& note)
+{
+	std::vector<Pitches>& c (_pitches[note->channel()]);
 
-			for (j = p.lower_bound (search_note); j != p.end() && (*j)->note() == note->note(); ++j) {
+	if (c.empty()) {
+		return false;
+	}
 
-				if ((*j) == note) {
-					DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1\terasing pitch %2 @ %3\n", this, (int)(*j)->note(), (*j)->time()));
-					p.erase (j);
-					break;
-				}
-			}
-		}
+	Pitches& p (c[note->note()]);
 
-		if (j == p.end()) {
-			warning << string_compose ("erased note %1 not found in pitches for channel %2", *note, (int) note->channel()) << endmsg;
+	for (typename Pitches::iterator j = p.begin(); j != p.end(); ++j) {
+		if (*j == note) {
+			DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1\terasing pitch %2 @ %3\n", this, (int)(*j)->note(), (*j)->time()));
+			p.erase (j);
+			return true;
 		}
+	}
 
-		_edited = true;
+	/* the note's pitch may have been changed since it was added, so
+	 * look for it by ID in all of its channel's pitches.
+	 */
 
-	} else {
-		cerr << "Unable to find note to erase matching " << *note.get() << endmsg;
+	for (typename std::vector<Pitches>::iterator pi = c.begin(); pi != c.end(); ++pi) {
+		for (typename Pitches::iterator j = pi->begin(); j != pi->end(); ++j) {
+			if ((*j)->id() == note->id()) {
+				pi->erase (j);
+				return true;
+			}
+		}
 	}
+
+	return false;
 }
 
 template<typename Time>
@@ -988,7 +1039,7 @@ Sequence<Time>::append_note_on_unlocked (const Event<Time>& ev, event_id_t evid)
 		return;
 	}
 
-	NotePtr note(new Note<Time>(ev.channel(), ev.time(), Time(), ev.note(), ev.velocity()));
+	NotePtr note (make_note (ev.channel(), ev.time(), Time(), ev.note(), ev.velocity()));
 	note->set_id (evid);
 
 	add_note_unlocked (note);
@@ -1129,11 +1180,9 @@ template<typename Time>
 bool
 Sequence<Time>::contains_unlocked (const NotePtr& note) const
 {
-	const Pitches& p (pitches (note->channel()));
-	NotePtr search_note(new Note<Time>(0, Time(), Time(), note->note()));
+	const Pitches& p (pitches (note->channel(), note->note()));
 
-	for (typename Pitches::const_iterator i = p.lower_bound (search_note);
-	     i != p.end() && (*i)->note() == note->note(); ++i) {
+	for (typename Pitches::const_iterator i = p.begin(); i != p.end(); ++i) {
 
 		if (**i == *note) {
 			return true;
@@ -1158,11 +1207,9 @@ Sequence<Time>::overlaps_unlocked (const NotePtr& note, const NotePtr& without)
 	Time sa = note->time();
 	Time ea  = note->end_time();
 
-	const Pitches& p (pitches (note->channel()));
-	NotePtr search_note(new Note<Time>(0, Time(), Time(), note->note()));
+	const Pitches& p (pitches (note->channel(), note->note()));
 
-	for (typename Pitches::const_iterator i = p.lower_bound (search_note);
-	     i != p.end() && (*i)->note() == note->note(); ++i) {
+	for (typename Pitches::const_iterator i = p.begin(); i != p.end(); ++i) {
 
 		if (without && (**i) == *without) {
 			continue;
@@ -1187,6 +1234,13 @@ void
 Sequence<Time>::set_notes (const typename Sequence<Time>::Notes& n)
 {
 	_notes = n;
+
+	for (int i = 0; i < 16; ++i) {
+		_pitches[i].clear();
+	}
+	for (typename Notes::const_iterator i = _notes.begin(); i != _notes.end(); ++i) {
+		add_pitch_unlocked (*i);
+	}
 }
 
 // CONST iterator implementations (x3)
@@ -1196,7 +1250,7 @@ template<typename Time>
 typename Sequence<Time>::Notes::const_iterator
 Sequence<Time>::note_lower_bound (Time t) const
 {
-	NotePtr search_note(new Note<Time>(0, t, Time(), 0, 0));
+	NotePtr search_note (make_note<Time> (0, t, Time(), 0, 0));
 	typename Sequence<Time>::Notes::const_iterator i = _notes.lower_bound(search_note);
 	assert(i == _notes.end() || (*i)->time() >= t);
 	return i;
@@ -1231,7 +1285,7 @@ template<typename Time>
 typename Sequence<Time>::Notes::iterator
 Sequence<Time>::note_lower_bound (Time t)
 {
-	NotePtr search_note(new Note<Time>(0, t, Time(), 0, 0));
+	NotePtr search_note (make_note<Time> (0, t, Time(), 0, 0));
 	typename Sequence<Time>::Notes::iterator i = _notes.lower_bound(search_note);
 	assert(i == _notes.end() || (*i)->time() >= t);
 	return i;
@@ -1292,44 +1346,40 @@ Sequence<Time>::get_notes_by_pitch (Notes& n, NoteOperator op, uint8_t val, int
 			continue;
 		}
 
-		const Pitches& p (pitches (c));
-		NotePtr search_note(new Note<Time>(0, Time(), Time(), val, 0));
-		typename Pitches::const_iterator i;
-		switch (op) {
-		case PitchEqual:
-			i = p.lower_bound (search_note);
-			while (i != p.end() && (*i)->note() == val) {
-				n.insert (*i);
-			}
-			break;
-		case PitchLessThan:
-			i = p.upper_bound (search_note);
-			while (i != p.end() && (*i)->note() < val) {
-				n.insert (*i);
-			}
-			break;
-		case PitchLessThanOrEqual:
-			i = p.upper_bound (search_note);
-			while (i != p.end() && (*i)->note() <= val) {
-				n.insert (*i);
-			}
-			break;
-		case PitchGreater:
-			i = p.lower_bound (search_note);
-			while (i != p.end() && (*i)->note() > val) {
-				n.insert (*i);
-			}
-			break;
-		case PitchGreaterThanOrEqual:
-			i = p.lower_bound (search_note);
-			while (i != p.end() && (*i)->note() >= val) {
-				n.insert (*i);
+		if (_pitches[c].empty()) {
+			continue;
+		}
+
+		for (int pitch = 0; pitch < 128; ++pitch) {
+
+			bool match;
+
+			switch (op) {
+			case PitchEqual:
+				match = (pitch == val);
+				break;
+			case PitchLessThan:
+				match = (pitch < val);
+				break;
+			case PitchLessThanOrEqual:
+				match = (pitch <= val);
+				break;
+			case PitchGreater:
+				match = (pitch > val);
+				break;
+			case PitchGreaterThanOrEqual:
+				match = (pitch >= val);
+				break;
+
+			default:
+				//fatal << string_compose (_("programming error: %1 %2", X_("get_notes_by_pitch() called with illegal operator"), op)) << endmsg;
+				abort(); /* NOTREACHED*/
 			}
-			break;
 
-		default:
-			//fatal << string_compose (_("programming error: %1 %2", X_("get_notes_by_pitch() called with illegal operator"), op)) << endmsg;
-			abort(); /* NOTREACHED*/
+			if (match) {
+				const Pitches& p (pitches (c, pitch));
+				n.insert (p.begin(), p.end());
+			}
 		}
 	}
 }
@@ -75,11 +75,14 @@ CurveTest::rtGet ()
 		// Write-lock list
 		Glib::Threads::RWLock::WriterLock lm(cl->lock());
 
-		// Attempt to get vector in RT (expect failure)
-		CPPUNIT_ASSERT (!cl->curve().rt_safe_get_vector (1024.0, 2047.0, vec, 1024));
+		// Get vector in RT (expect success, the lock is not needed)
+		CPPUNIT_ASSERT (cl->curve().rt_safe_get_vector (1024.0, 2047.0, vec, 1024));
+		for (int i = 0; i < 1024; ++i) {
+			CPPUNIT_ASSERT_EQUAL (42.0f, vec[i]);
+		}
 	}
 
-	// Attempt to get vector in RT (expect success)
+	// Get vector in RT (expect success)
 	CPPUNIT_ASSERT (cl->curve().rt_safe_get_vector (1024.0, 2047.0, vec, 1024));
 	for (int i = 0; i < 1024; ++i) {
 		CPPUNIT_ASSERT_EQUAL (42.0f, vec[i]);
@@ -293,6 +296,97 @@ CurveTest::ctrlListEval ()
 	CPPUNIT_ASSERT_EQUAL(9.0, cl->unlocked_eval(999.));
 }
 
+void
+CurveTest::ctrlListPoints ()
+{
+	boost::shared_ptr<Evoral::ControlList> cl = TestCtrlList();
+	double x, y;
+
+	cl->set_interpolation (ControlList::Discrete);
+
+	// a jump from 4 to 6 at 100
+	cl->fast_simple_add (   0.0 , 2.0);
+	cl->fast_simple_add ( 100.0 , 4.0);
+	cl->fast_simple_add ( 100.0 , 6.0);
+	cl->fast_simple_add ( 200.0 , 0.0);
+
+	boost::shared_ptr<const ControlList::Points> p = cl->points ();
+	CPPUNIT_ASSERT_EQUAL ((size_t) 4, p->size ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, p->lower_bound (100.));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 3, p->upper_bound (100.));
+
+	bool ok;
+	CPPUNIT_ASSERT_EQUAL (6.0, cl->rt_safe_eval (150., ok));
+	CPPUNIT_ASSERT (ok);
+
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event (0., x, y, true));
+	CPPUNIT_ASSERT_EQUAL (0.0, x);
+	CPPUNIT_ASSERT_EQUAL (2.0, y);
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event (x, x, y, false));
+	CPPUNIT_ASSERT_EQUAL (100.0, x);
+	CPPUNIT_ASSERT_EQUAL (4.0, y);
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event (x, x, y, false));
+	CPPUNIT_ASSERT_EQUAL (200.0, x);
+	CPPUNIT_ASSERT_EQUAL (0.0, y);
+	CPPUNIT_ASSERT (!cl->rt_safe_earliest_event (x, x, y, false));
+
+	cl->set_interpolation (ControlList::Linear);
+
+	CPPUNIT_ASSERT_EQUAL (3.0, cl->rt_safe_eval (150., ok));
+
+	// the ramp down from 100 starts after the jump
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event (100., x, y, false));
+	CPPUNIT_ASSERT_EQUAL (5.0, y);
+	CPPUNIT_ASSERT (x > 100. && x < 200.);
+
+	// readers keep the points they have while the list changes
+	cl->fast_simple_add ( 300.0 , 8.0);
+
+	CPPUNIT_ASSERT_EQUAL ((size_t) 4, p->size ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) 5, cl->points ()->size ());
+	CPPUNIT_ASSERT_EQUAL (4.0, cl->rt_safe_eval (250., ok));
+}
+
+void
+CurveTest::getVectorAgain ()
+{
+	boost::shared_ptr<Evoral::ControlList> cl = TestCtrlList();
+	float vec[256];
+	float ref[256];
+
+	cl->create_curve ();
+	cl->fast_simple_add (   0.0 , 0.0);
+	cl->fast_simple_add (  40.0 , 1.0);
+	cl->fast_simple_add ( 100.0 , 0.5);
+	cl->fast_simple_add ( 256.0 , 1.0);
+
+	// the same range twice, the second time from the kept result
+	for (int n = 0; n < 2; ++n) {
+		cl->curve().get_vector (0., 255., vec, 256);
+		cl->curve().rt_safe_get_vector (0., 255., ref, 256);
+		for (int i = 0; i < 256; ++i) {
+			CPPUNIT_ASSERT_EQUAL (ref[i], vec[i]);
+		}
+	}
+
+	// a change to the list is seen
+	cl->add (100.0, 0.25, false, false);
+	cl->curve().get_vector (0., 255., vec, 256);
+	CPPUNIT_ASSERT_EQUAL (0.25f, vec[100]);
+	cl->curve().rt_safe_get_vector (0., 255., ref, 256);
+	for (int i = 0; i < 256; ++i) {
+		CPPUNIT_ASSERT_EQUAL (ref[i], vec[i]);
+	}
+
+	// as is a change of interpolation
+	cl->set_interpolation (ControlList::Curved);
+	cl->curve().get_vector (0., 255., vec, 256);
+	cl->curve().rt_safe_get_vector (0., 255., ref, 256);
+	for (int i = 0; i < 256; ++i) {
+		CPPUNIT_ASSERT_EQUAL (ref[i], vec[i]);
+	}
+}
+
 void
 CurveTest::constrainedCubic ()
 {
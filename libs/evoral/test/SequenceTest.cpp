@@ -194,3 +194,46 @@ SequenceTest::controlInterpolationTest ()
 		last_value = i->second;
 	}
 }
+
+void
+SequenceTest::pitchIndexTest ()
+{
+	typedef boost::shared_ptr< Note<Time> > NotePtr;
+
+	for (Notes::const_iterator i = test_notes.begin(); i != test_notes.end(); ++i) {
+		seq->add_note_unlocked (*i);
+	}
+
+	// test_notes have pitches 64 .. 75
+	Sequence<Time>::Notes found;
+	seq->get_notes (found, Sequence<Time>::PitchEqual, 66);
+	CPPUNIT_ASSERT_EQUAL (size_t(1), found.size());
+	CPPUNIT_ASSERT (*found.begin() == test_notes[2]);
+
+	found.clear ();
+	seq->get_notes (found, Sequence<Time>::PitchLessThan, 66);
+	CPPUNIT_ASSERT_EQUAL (size_t(2), found.size());
+
+	found.clear ();
+	seq->get_notes (found, Sequence<Time>::PitchGreaterThanOrEqual, 70);
+	CPPUNIT_ASSERT_EQUAL (size_t(6), found.size());
+
+	// overlaps the second half of test_notes[2]
+	NotePtr overlapping (new Note<Time> (0, Beats(250), Beats(100), 66, 64));
+	CPPUNIT_ASSERT (seq->overlaps (overlapping, NotePtr()));
+	CPPUNIT_ASSERT (seq->contains (test_notes[2]));
+
+	seq->remove_note_unlocked (test_notes[2]);
+	CPPUNIT_ASSERT (!seq->overlaps (overlapping, NotePtr()));
+	CPPUNIT_ASSERT (!seq->contains (test_notes[2]));
+
+	found.clear ();
+	seq->get_notes (found, Sequence<Time>::PitchEqual, 66);
+	CPPUNIT_ASSERT_EQUAL (size_t(0), found.size());
+
+	// a copy indexes its own notes
+	MySequence<Time> copy (*seq);
+	NotePtr overlapping_copy (new Note<Time> (0, Beats(350), Beats(100), 67, 64));
+	CPPUNIT_ASSERT (copy.contains (test_notes[3]));
+	CPPUNIT_ASSERT (copy.overlaps (overlapping_copy, NotePtr()));
+}
@@ -116,6 +116,7 @@ class SequenceTest : public CppUnit::TestFixture
 	CPPUNIT_TEST (preserveEventOrderingTest);
 	CPPUNIT_TEST (iteratorSeekTest);
 	CPPUNIT_TEST (controlInterpolationTest);
+	CPPUNIT_TEST (pitchIndexTest);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -146,6 +147,7 @@ public:
 	void preserveEventOrderingTest ();
 	void iteratorSeekTest ();
 	void controlInterpolationTest ();
+	void pitchIndexTest ();
 
 private:
 	DummyTypeMap*       type_map;
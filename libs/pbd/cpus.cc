@@ -24,6 +24,9 @@
 
 #ifdef __linux__
 #include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <fstream>
 #elif defined(__APPLE__) || defined(__FreeBSD__)
 #include <stddef.h>
 #include <sys/types.h>
@@ -32,6 +35,10 @@
 #include <windows.h>
 #endif
 
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+
 #include "pbd/cpus.h"
 
 #if defined(COMPILER_MSVC) && !defined(PTW32_VERSION)
@@ -62,3 +69,77 @@ hardware_concurrency()
         return 0;
 #endif
 }
+
+bool
+parse_cpu_list (std::string const & str, std::vector<int>& cpus)
+{
+	cpus.clear ();
+
+	const char* p = str.c_str ();
+
+	while (*p && *p != '\n') {
+		char* end;
+		long first = strtol (p, &end, 10);
+		if (end == p || first < 0) {
+			return false;
+		}
+		long last = first;
+		p = end;
+		if (*p == '-') {
+			++p;
+			last = strtol (p, &end, 10);
+			if (end == p || last < first) {
+				return false;
+			}
+			p = end;
+		}
+		for (long c = first; c <= last; ++c) {
+			cpus.push_back (c);
+		}
+		if (*p == ',') {
+			++p;
+		} else if (*p && *p != '\n') {
+			return false;
+		}
+	}
+
+	return !cpus.empty ();
+}
+
+bool
+numa_node_cpus (int node, std::vector<int>& cpus)
+{
+#ifdef __linux__
+	char path[64];
+	snprintf (path, sizeof (path), "/sys/devices/system/node/node%d/cpulist", node);
+
+	std::ifstream f (path);
+	std::string line;
+
+	if (node < 0 || !std::getline (f, line)) {
+		return false;
+	}
+
+	return parse_cpu_list (line, cpus);
+#else
+	return false;
+#endif
+}
+
+int
+set_thread_cpu_affinity (int cpu)
+{
+#ifdef __linux__
+	if (cpu < 0 || cpu >= CPU_SETSIZE) {
+		return EINVAL;
+	}
+
+	cpu_set_t set;
+	CPU_ZERO (&set);
+	CPU_SET (cpu, &set);
+
+	return pthread_setaffinity_np (pthread_self (), sizeof (set), &set);
+#else
+	return ENOSYS;
+#endif
+}
@@ -43,30 +43,37 @@ FPU* FPU::_instance (0);
 #if ( (defined __x86_64__) || (defined __i386__) || (defined _M_X64) || (defined _M_IX86) ) // ARCH_X86
 #ifndef PLATFORM_WINDOWS
 
-/* use __cpuid() as the name to match the MSVC/mingw intrinsic */
+/* use __cpuid() and __cpuidex() as the names to match the MSVC/mingw intrinsics */
 
 static void
-__cpuid(int regs[4], int cpuid_leaf)
+__cpuidex(int regs[4], int cpuid_leaf, int cpuid_subleaf)
 {
         asm volatile (
 #if defined(__i386__)
 	        "pushl %%ebx;\n\t"
 #endif
 	        "cpuid;\n\t"
-	        "movl %%eax, (%1);\n\t"
-	        "movl %%ebx, 4(%1);\n\t"
-	        "movl %%ecx, 8(%1);\n\t"
-	        "movl %%edx, 12(%1);\n\t"
+	        "movl %%eax, (%[regs]);\n\t"
+	        "movl %%ebx, 4(%[regs]);\n\t"
+	        "movl %%ecx, 8(%[regs]);\n\t"
+	        "movl %%edx, 12(%[regs]);\n\t"
 #if defined(__i386__)
 	        "popl %%ebx;\n\t"
 #endif
-	        :"=a" (cpuid_leaf) /* %eax clobbered by CPUID */
-	        :"S" (regs), "a" (cpuid_leaf)
+	        :"=a" (cpuid_leaf), /* %eax clobbered by CPUID */
+	         "+c" (cpuid_subleaf) /* %ecx selects the sub-leaf, also clobbered */
+	        :[regs] "S" (regs), "a" (cpuid_leaf)
 	        :
 #if !defined(__i386__)
 	         "%ebx",
 #endif
-	         "%ecx", "%edx", "memory");
+	         "%edx", "memory");
+}
+
+static void
+__cpuid(int regs[4], int cpuid_leaf)
+{
+	__cpuidex (regs, cpuid_leaf, 0);
 }
 
 #endif /* !PLATFORM_WINDOWS */
@@ -194,6 +201,17 @@ FPU::FPU ()
 			_flags = Flags (_flags | (HasAVX) );
 		}
 
+		if ((_flags & HasAVX) && num_ids >= 7) {
+			int ext_info[4];
+			__cpuidex (ext_info, 7, 0);
+
+			if ((ext_info[1] & (1<<16)) /* AVX512F */ &&
+			    ((_xgetbv (_XCR_XFEATURE_ENABLED_MASK) & 0xe6) == 0xe6)) { /* OS saves opmask and ZMM state */
+				info << _("AVX-512 capable processor") << endmsg;
+				_flags = Flags (_flags | (HasAVX512F) );
+			}
+		}
+
 		if (cpu_info[3] & (1<<25)) {
 			_flags = Flags (_flags | (HasSSE|HasFlushToZero));
 		}
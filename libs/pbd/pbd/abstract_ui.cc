@@ -85,6 +85,14 @@ AbstractUI<RequestObject>::AbstractUI (const string& name)
 	}
 }
 
+template <typename RequestObject>
+AbstractUI<RequestObject>::~AbstractUI ()
+{
+	for (typename std::vector<RequestObject*>::iterator r = request_pool.begin(); r != request_pool.end(); ++r) {
+		delete *r;
+	}
+}
+
 template <typename RequestObject> void
 AbstractUI<RequestObject>::register_thread (pthread_t thread_id, string thread_name, uint32_t num_requests)
 {
@@ -176,14 +184,58 @@ AbstractUI<RequestObject>::get_request (RequestType rt)
 	 * are not at work.
 	 */
 
-	DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: allocated normal heap request of type %2, caller %3\n", event_loop_name(), rt, pthread_name()));
+	RequestObject* req = 0;
+
+	{
+		Glib::Threads::Mutex::Lock rbml (request_buffer_map_lock);
+		if (!request_pool.empty ()) {
+			req = request_pool.back ();
+			request_pool.pop_back ();
+		}
+	}
+
+	if (req) {
+		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: reused heap request for type %2, caller %3\n", event_loop_name(), rt, pthread_name()));
+	} else {
+		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: allocated normal heap request of type %2, caller %3\n", event_loop_name(), rt, pthread_name()));
+		req = new RequestObject;
+	}
 
-	RequestObject* req = new RequestObject;
 	req->type = rt;
 
 	return req;
 }
 
+template <typename RequestObject> void
+AbstractUI<RequestObject>::release_request (RequestObject* req)
+{
+	/* called with request_buffer_map_lock held, once a heap request has
+	 * been handled (or dropped).
+	 *
+	 * Drop the request's reference to its invalidation record whether the
+	 * request is kept or deleted, so that the record can be trashed.
+	 */
+
+	if (req->invalidation) {
+		req->invalidation->unref ();
+		req->invalidation = NULL;
+	}
+
+	/* Only CallSlot requests are kept: they carry nothing but the slot
+	 * and invalidation record, whereas other request types may own data
+	 * that their destructor releases.
+	 */
+
+	if (req->type != CallSlot || request_pool.size () >= 64) {
+		delete req;
+		return;
+	}
+
+	req->the_slot = 0;
+
+	request_pool.push_back (req);
+}
+
 template <typename RequestObject> void
 AbstractUI<RequestObject>::handle_ui_requests ()
 {
@@ -310,7 +362,7 @@ AbstractUI<RequestObject>::handle_ui_requests ()
 
 		if (req->invalidation && !req->invalidation->valid()) {
 			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 handling invalid heap request, type %3, deleting\n", event_loop_name(), pthread_name(), req->type));
-			delete req;
+			release_request (req);
 			continue;
 		}
 
@@ -343,12 +395,18 @@ AbstractUI<RequestObject>::handle_ui_requests ()
 
 		do_request (req);
 
-		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 delete heap request type %3\n", event_loop_name(), pthread_name(), req->type));
-		delete req;
+		/* drop the functor (and anything it holds) before taking the
+		 * lock again, as for per-thread requests above.
+		 */
+
+		req->the_slot = 0;
 
 		/* re-acquire the list lock so that we check again */
 
 		rbml.acquire();
+
+		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 release heap request type %3\n", event_loop_name(), pthread_name(), req->type));
+		release_request (req);
 	}
 
 	rbml.release ();
@@ -22,6 +22,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <pthread.h>
 
 #include <glibmm/threads.h>
@@ -56,7 +57,7 @@ class ABSTRACT_UI_API AbstractUI : public BaseUI
 {
 public:
 	AbstractUI (const std::string& name);
-	virtual ~AbstractUI() {}
+	virtual ~AbstractUI();
 
 	void register_thread (pthread_t, std::string, uint32_t num_requests);
 	void call_slot (EventLoop::InvalidationRecord*, const boost::function<void()>&);
@@ -95,6 +96,13 @@ protected:
 
 	std::list<RequestObject*> request_list;
 
+	/* heap requests from threads without a per-thread buffer, kept after
+	 * use so that the next one does not need to be allocated. Protected
+	 * by request_buffer_map_lock.
+	 */
+	std::vector<RequestObject*> request_pool;
+	void release_request (RequestObject*);
+
 	RequestObject* get_request (RequestType);
 	void handle_ui_requests ();
 	void send_request (RequestObject *);
@@ -109,6 +109,12 @@ class LIBPBD_API BaseUI : public sigc::trackable, public PBD::EventLoop
 
 	CrossThreadChannel request_channel;
 
+	/* non-zero while a wakeup has been written to request_channel and
+	 * not yet acted on: further requests made before the event loop gets
+	 * to them do not need to write to the channel again.
+	 */
+	gint _wakeup_pending;
+
 	static uint64_t rt_bit;
 
 	int setup_request_pipe ();
@@ -22,9 +22,26 @@
 #define __libpbd_cpus_h__
 
 #include <stdint.h>
+#include <string>
+#include <vector>
 
 #include "pbd/libpbd_visibility.h"
 
 LIBPBD_API extern uint32_t hardware_concurrency ();
 
+/** Parse a CPU list in the format used by Linux's sysfs, e.g. "0-3,8,10-11".
+ *  @return false if @param str is malformed.
+ */
+LIBPBD_API extern bool parse_cpu_list (std::string const & str, std::vector<int>& cpus);
+
+/** Find the CPUs that belong to NUMA node @param node.
+ *  @return false if they cannot be found, which is always the case on systems other than Linux.
+ */
+LIBPBD_API extern bool numa_node_cpus (int node, std::vector<int>& cpus);
+
+/** Bind the calling thread to @param cpu.
+ *  @return 0 on success, otherwise an errno value.
+ */
+LIBPBD_API extern int set_thread_cpu_affinity (int cpu);
+
 #endif /* __libpbd_cpus_h__ */
@@ -0,0 +1,310 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __pbd_interval_tree_h__
+#define __pbd_interval_tree_h__
+
+#include <cstddef>
+#include <map>
+#include <stdint.h>
+
+#include "pbd/libpbd_visibility.h"
+
+namespace PBD {
+
+/** An index of values, each covering a closed interval [first, last],
+ *  that answers "which values overlap this range" in O(log n + k).
+ *
+ *  It is a treap ordered by (first, insertion order) in which every node
+ *  also knows the largest `last' in its subtree, so whole subtrees that end
+ *  before a query range can be skipped. Values are kept in a map as well,
+ *  so they can be removed or moved without knowing their old interval.
+ *
+ *  Results are appended to a caller-provided container (anything with
+ *  push_back()) in order of ascending `first'; values with the same `first'
+ *  come out in the order they were inserted.
+ *
+ *  T must be usable as a std::map key. Not thread safe.
+ */
+template<typename Pos, typename T>
+class /*LIBPBD_API*/ IntervalTree
+{
+  public:
+	IntervalTree () : _root (0), _seq (0), _rand (2463534242U) {}
+	~IntervalTree () { clear (); }
+
+	/** Add @param v covering [@param first, @param last], or move it there if it is already present */
+	void insert (T const & v, Pos first, Pos last)
+	{
+		typename NodeMap::iterator i = _nodes.find (v);
+
+		if (i != _nodes.end()) {
+			if (i->second->first == first && i->second->last == last) {
+				return;
+			}
+			Node* n = i->second;
+			_root = unlink (_root, n);
+			n->first = first;
+			n->last = last;
+			n->seq = _seq++;
+			n->left = n->right = 0;
+			n->max_last = last;
+			_root = link (_root, n);
+			return;
+		}
+
+		Node* n = new Node (v, first, last, _seq++, next_priority ());
+		_nodes.insert (std::make_pair (v, n));
+		_root = link (_root, n);
+	}
+
+	/** Remove @param v
+	 *  @return true if it was present.
+	 */
+	bool erase (T const & v)
+	{
+		typename NodeMap::iterator i = _nodes.find (v);
+
+		if (i == _nodes.end()) {
+			return false;
+		}
+
+		Node* n = i->second;
+		_nodes.erase (i);
+		_root = unlink (_root, n);
+		delete n;
+		return true;
+	}
+
+	bool contains (T const & v) const { return _nodes.find (v) != _nodes.end(); }
+
+	void clear ()
+	{
+		destroy (_root);
+		_root = 0;
+		_nodes.clear ();
+	}
+
+	size_t size () const { return _nodes.size (); }
+	bool empty () const { return _nodes.empty (); }
+
+	/** Append all values that overlap [@param from, @param to] to @param out */
+	template<typename Container>
+	void find_overlapping (Pos from, Pos to, Container& out) const
+	{
+		overlapping (_root, from, to, out);
+	}
+
+	/** Append all values that cover @param p to @param out */
+	template<typename Container>
+	void find_covering (Pos p, Container& out) const
+	{
+		overlapping (_root, p, p, out);
+	}
+
+	/** Append all values whose interval starts within [@param from, @param to] to @param out */
+	template<typename Container>
+	void find_starting_within (Pos from, Pos to, Container& out) const
+	{
+		starting_within (_root, from, to, out);
+	}
+
+	/** @return true if any value covers @param p */
+	bool any_covering (Pos p) const
+	{
+		Node const * n = _root;
+
+		while (n && n->max_last >= p) {
+			if (n->left && n->left->max_last >= p) {
+				n = n->left;
+			} else if (n->first > p) {
+				return false;
+			} else if (n->last >= p) {
+				return true;
+			} else {
+				n = n->right;
+			}
+		}
+
+		return false;
+	}
+
+  private:
+	IntervalTree (IntervalTree const &);
+	IntervalTree& operator= (IntervalTree const &);
+
+	struct Node {
+		Node (T const & v, Pos f, Pos l, uint64_t s, uint32_t p)
+			: value (v), first (f), last (l), max_last (l), seq (s), priority (p), left (0), right (0) {}
+
+		T        value;
+		Pos      first;
+		Pos      last;
+		Pos      max_last; ///< largest `last' in this subtree
+		uint64_t seq;
+		uint32_t priority;
+		Node*    left;
+		Node*    right;
+
+		bool before (Node const * other) const {
+			return first < other->first || (first == other->first && seq < other->seq);
+		}
+	};
+
+	typedef std::map<T, Node*> NodeMap;
+
+	Node*    _root;
+	NodeMap  _nodes;
+	uint64_t _seq;
+	uint32_t _rand;
+
+	uint32_t next_priority ()
+	{
+		/* xorshift32; the shape of the tree only needs to be unpredictable to the input order */
+		_rand ^= _rand << 13;
+		_rand ^= _rand >> 17;
+		_rand ^= _rand << 5;
+		return _rand;
+	}
+
+	static void update (Node* n)
+	{
+		n->max_last = n->last;
+		if (n->left && n->left->max_last > n->max_last) {
+			n->max_last = n->left->max_last;
+		}
+		if (n->right && n->right->max_last > n->max_last) {
+			n->max_last = n->right->max_last;
+		}
+	}
+
+	/** Split @param t into the nodes ordered before @param key and the rest */
+	static void split (Node* t, Node const * key, Node*& l, Node*& r)
+	{
+		if (!t) {
+			l = r = 0;
+		} else if (t->before (key)) {
+			split (t->right, key, t->right, r);
+			l = t;
+			update (t);
+		} else {
+			split (t->left, key, l, t->left);
+			r = t;
+			update (t);
+		}
+	}
+
+	/** Join two trees, all of whose nodes in @param l are ordered before those in @param r */
+	static Node* merge (Node* l, Node* r)
+	{
+		if (!l) {
+			return r;
+		}
+		if (!r) {
+			return l;
+		}
+		if (l->priority > r->priority) {
+			l->right = merge (l->right, r);
+			update (l);
+			return l;
+		}
+		r->left = merge (l, r->left);
+		update (r);
+		return r;
+	}
+
+	static Node* link (Node* t, Node* n)
+	{
+		if (!t) {
+			return n;
+		}
+		if (n->priority > t->priority) {
+			split (t, n, n->left, n->right);
+			update (n);
+			return n;
+		}
+		if (n->before (t)) {
+			t->left = link (t->left, n);
+		} else {
+			t->right = link (t->right, n);
+		}
+		update (t);
+		return t;
+	}
+
+	static Node* unlink (Node* t, Node* n)
+	{
+		if (t == n) {
+			return merge (t->left, t->right);
+		}
+		if (n->before (t)) {
+			t->left = unlink (t->left, n);
+		} else {
+			t->right = unlink (t->right, n);
+		}
+		update (t);
+		return t;
+	}
+
+	static void destroy (Node* t)
+	{
+		if (t) {
+			destroy (t->left);
+			destroy (t->right);
+			delete t;
+		}
+	}
+
+	template<typename Container>
+	static void overlapping (Node const * n, Pos from, Pos to, Container& out)
+	{
+		while (n && n->max_last >= from) {
+			overlapping (n->left, from, to, out);
+			if (n->first > to) {
+				/* so does everything to the right */
+				return;
+			}
+			if (n->last >= from) {
+				out.push_back (n->value);
+			}
+			n = n->right;
+		}
+	}
+
+	template<typename Container>
+	static void starting_within (Node const * n, Pos from, Pos to, Container& out)
+	{
+		while (n) {
+			if (n->first < from) {
+				n = n->right;
+				continue;
+			}
+			starting_within (n->left, from, to, out);
+			if (n->first > to) {
+				return;
+			}
+			out.push_back (n->value);
+			n = n->right;
+		}
+	}
+};
+
+} /* namespace PBD */
+
+#endif /* __pbd_interval_tree_h__ */
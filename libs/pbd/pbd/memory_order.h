@@ -0,0 +1,71 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __pbd_memory_order_h__
+#define __pbd_memory_order_h__
+
+#include <glib.h>
+
+/* g_atomic_int_get() and g_atomic_int_set() are full barriers. Lock-free
+ * structures with a single writer per variable only need acquire/release
+ * ordering, which costs nothing on x86 and much less than a full barrier
+ * elsewhere. Where the compiler has no __atomic builtins (GCC < 4.7, MSVC)
+ * these fall back to the glib functions.
+ */
+
+#define PBD_CACHE_LINE_SIZE 64
+
+namespace PBD {
+
+/** Load @param p, ordered before any later loads and stores in this thread */
+static inline gint
+atomic_int_get_acquire (gint const volatile* p)
+{
+#ifdef __ATOMIC_ACQUIRE
+	return __atomic_load_n (p, __ATOMIC_ACQUIRE);
+#else
+	return g_atomic_int_get (p);
+#endif
+}
+
+/** Store @param v in @param p, ordered after any earlier loads and stores in this thread */
+static inline void
+atomic_int_set_release (gint volatile* p, gint v)
+{
+#ifdef __ATOMIC_RELEASE
+	__atomic_store_n (p, v, __ATOMIC_RELEASE);
+#else
+	g_atomic_int_set (p, v);
+#endif
+}
+
+/** Load @param p with no ordering; for variables only this thread writes */
+static inline gint
+atomic_int_get_relaxed (gint const volatile* p)
+{
+#ifdef __ATOMIC_RELAXED
+	return __atomic_load_n (p, __ATOMIC_RELAXED);
+#else
+	return g_atomic_int_get (p);
+#endif
+}
+
+} /* namespace PBD */
+
+#endif /* __pbd_memory_order_h__ */
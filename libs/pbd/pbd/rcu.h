@@ -122,26 +122,7 @@ public:
 
 	boost::shared_ptr<T> write_copy ()
 	{
-		m_lock.lock();
-
-		// clean out any dead wood
-
-		typename std::list<boost::shared_ptr<T> >::iterator i;
-
-		for (i = m_dead_wood.begin(); i != m_dead_wood.end(); ) {
-			if ((*i).unique()) {
-				i = m_dead_wood.erase (i);
-			} else {
-				++i;
-			}
-		}
-
-		/* store the current so that we can do compare and exchange
-		   when someone calls update(). Notice that we hold
-		   a lock, so this store of m_rcu_value is atomic.
-		*/
-
-		current_write_old = RCUManager<T>::x.m_rcu_value;
+		start_write ();
 
 		boost::shared_ptr<T> new_copy (new T(**current_write_old));
 
@@ -152,6 +133,21 @@ public:
 		*/
 	}
 
+	/* as write_copy(), for writers that replace the whole value: the
+	   new object is default-constructed instead of copied from the
+	   current one.
+	*/
+	boost::shared_ptr<T> write_new ()
+	{
+		start_write ();
+
+		boost::shared_ptr<T> new_value (new T);
+
+		return new_value;
+
+		/* the write lock is still held: update() MUST be called */
+	}
+
 	bool update (boost::shared_ptr<T> new_value)
 	{
 		/* we still hold the write lock - other writers are locked out */
@@ -194,6 +190,30 @@ public:
 	}
 
 private:
+	void start_write ()
+	{
+		m_lock.lock();
+
+		// clean out any dead wood
+
+		typename std::list<boost::shared_ptr<T> >::iterator i;
+
+		for (i = m_dead_wood.begin(); i != m_dead_wood.end(); ) {
+			if ((*i).unique()) {
+				i = m_dead_wood.erase (i);
+			} else {
+				++i;
+			}
+		}
+
+		/* store the current so that we can do compare and exchange
+		   when someone calls update(). Notice that we hold
+		   a lock, so this store of m_rcu_value is atomic.
+		*/
+
+		current_write_old = RCUManager<T>::x.m_rcu_value;
+	}
+
 	Glib::Threads::Mutex                      m_lock;
 	boost::shared_ptr<T>*            current_write_old;
 	std::list<boost::shared_ptr<T> > m_dead_wood;
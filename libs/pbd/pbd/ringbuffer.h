@@ -24,7 +24,21 @@
 #include <glib.h>
 
 #include "pbd/libpbd_visibility.h"
-
+#include "pbd/memory_order.h"
+
+/** A single-reader, single-writer lock-free ringbuffer.
+ *
+ *  The writer's and the reader's state live on separate cache lines, so
+ *  the two threads only ever share a line when one needs to look at the
+ *  other's index. Each side keeps its last sight of the other's index
+ *  and only reloads it when that does not show enough data (or space)
+ *  for the current request.
+ *
+ *  read(), get_read_vector() and increment_read_idx() are for the reader
+ *  only, write(), get_write_vector() and increment_write_idx() for the
+ *  writer only. read_space() and write_space() may be called from any
+ *  thread.
+ */
 template<class T>
 class /*LIBPBD_API*/ RingBuffer
 {
@@ -46,14 +60,15 @@ class /*LIBPBD_API*/ RingBuffer
 
 	void reset () {
 		/* !!! NOT THREAD SAFE !!! */
-		g_atomic_int_set (&write_idx, 0);
-		g_atomic_int_set (&read_idx, 0);
+		set (0, 0);
 	}
 
 	void set (guint r, guint w) {
 		/* !!! NOT THREAD SAFE !!! */
 		g_atomic_int_set (&write_idx, w);
 		g_atomic_int_set (&read_idx, r);
+		cached_read_idx = r;
+		cached_write_idx = w;
 	}
 
 	guint read  (T *dest, guint cnt);
@@ -68,56 +83,90 @@ class /*LIBPBD_API*/ RingBuffer
 	void get_write_vector (rw_vector *);
 
 	void decrement_read_idx (guint cnt) {
-		g_atomic_int_set (&read_idx, (g_atomic_int_get(&read_idx) - cnt) & size_mask);
+		/* reader only. The caller must know that the writer has not
+		 * reused the space handed back; the writer's cached view of
+		 * read_idx is never beyond where it was before this call, so
+		 * that is no different from when there was no cache.
+		 */
+		PBD::atomic_int_set_release (&read_idx, (PBD::atomic_int_get_relaxed (&read_idx) - cnt) & size_mask);
 	}
 
 	void increment_read_idx (guint cnt) {
-		g_atomic_int_set (&read_idx, (g_atomic_int_get(&read_idx) + cnt) & size_mask);
+		PBD::atomic_int_set_release (&read_idx, (PBD::atomic_int_get_relaxed (&read_idx) + cnt) & size_mask);
 	}
 
 	void increment_write_idx (guint cnt) {
-		g_atomic_int_set (&write_idx,  (g_atomic_int_get(&write_idx) + cnt) & size_mask);
+		PBD::atomic_int_set_release (&write_idx, (PBD::atomic_int_get_relaxed (&write_idx) + cnt) & size_mask);
 	}
 
 	guint write_space () const {
 		guint w, r;
 
-		w = g_atomic_int_get (&write_idx);
-		r = g_atomic_int_get (&read_idx);
+		w = PBD::atomic_int_get_acquire (&write_idx);
+		r = PBD::atomic_int_get_acquire (&read_idx);
 
-		if (w > r) {
-			return ((r - w + size) & size_mask) - 1;
-		} else if (w < r) {
-			return (r - w) - 1;
-		} else {
-			return size - 1;
-		}
+		return space_between (r, w);
 	}
 
 	guint read_space () const {
 		guint w, r;
 
-		w = g_atomic_int_get (&write_idx);
-		r = g_atomic_int_get (&read_idx);
+		w = PBD::atomic_int_get_acquire (&write_idx);
+		r = PBD::atomic_int_get_acquire (&read_idx);
 
-		if (w > r) {
-			return w - r;
-		} else {
-			return (w - r + size) & size_mask;
-		}
+		return (w - r) & size_mask;
 	}
 
 	T *buffer () { return buf; }
-	guint get_write_idx () const { return g_atomic_int_get (&write_idx); }
-	guint get_read_idx () const { return g_atomic_int_get (&read_idx); }
+	guint get_write_idx () const { return PBD::atomic_int_get_acquire (&write_idx); }
+	guint get_read_idx () const { return PBD::atomic_int_get_acquire (&read_idx); }
 	guint bufsize () const { return size; }
 
   protected:
 	T *buf;
 	guint size;
+	guint size_mask;
+
+	/* shared, read-mostly state above; keep the indices off its line */
+	char _pad0[PBD_CACHE_LINE_SIZE];
+
+	/* written by the writer */
 	mutable gint write_idx;
+	guint        cached_read_idx;  ///< the writer's last sight of read_idx
+	char _pad1[PBD_CACHE_LINE_SIZE];
+
+	/* written by the reader */
 	mutable gint read_idx;
-	guint size_mask;
+	guint        cached_write_idx; ///< the reader's last sight of write_idx
+	char _pad2[PBD_CACHE_LINE_SIZE];
+
+	/** @return space available for writing with write index @param w and read index @param r */
+	guint space_between (guint r, guint w) const {
+		return (r - w - 1) & size_mask;
+	}
+
+	/** Writer only: @return space available for writing, at least
+	 *  @param wanted if possible, without looking at read_idx if we
+	 *  already know that there is that much.
+	 */
+	guint writer_space (guint w, guint wanted) {
+		guint space = space_between (cached_read_idx, w);
+		if (space < wanted) {
+			cached_read_idx = PBD::atomic_int_get_acquire (&read_idx);
+			space = space_between (cached_read_idx, w);
+		}
+		return space;
+	}
+
+	/** Reader only: as writer_space(), for data available to read */
+	guint reader_space (guint r, guint wanted) {
+		guint space = (cached_write_idx - r) & size_mask;
+		if (space < wanted) {
+			cached_write_idx = PBD::atomic_int_get_acquire (&write_idx);
+			space = (cached_write_idx - r) & size_mask;
+		}
+		return space;
+	}
 };
 
 template<class T> /*LIBPBD_API*/ guint
@@ -129,9 +178,9 @@ RingBuffer<T>::read (T *dest, guint cnt)
         guint n1, n2;
         guint priv_read_idx;
 
-        priv_read_idx=g_atomic_int_get(&read_idx);
+        priv_read_idx = PBD::atomic_int_get_relaxed (&read_idx);
 
-        if ((free_cnt = read_space ()) == 0) {
+        if ((free_cnt = reader_space (priv_read_idx, cnt)) == 0) {
                 return 0;
         }
 
@@ -155,7 +204,7 @@ RingBuffer<T>::read (T *dest, guint cnt)
                 priv_read_idx = n2;
         }
 
-        g_atomic_int_set(&read_idx, priv_read_idx);
+        PBD::atomic_int_set_release (&read_idx, priv_read_idx);
         return to_read;
 }
 
@@ -169,9 +218,9 @@ RingBuffer<T>::write (T const *src, guint cnt)
         guint n1, n2;
         guint priv_write_idx;
 
-        priv_write_idx=g_atomic_int_get(&write_idx);
+        priv_write_idx = PBD::atomic_int_get_relaxed (&write_idx);
 
-        if ((free_cnt = write_space ()) == 0) {
+        if ((free_cnt = writer_space (priv_write_idx, cnt)) == 0) {
                 return 0;
         }
 
@@ -195,7 +244,7 @@ RingBuffer<T>::write (T const *src, guint cnt)
                 priv_write_idx = n2;
         }
 
-        g_atomic_int_set(&write_idx, priv_write_idx);
+        PBD::atomic_int_set_release (&write_idx, priv_write_idx);
         return to_write;
 }
 
@@ -205,16 +254,10 @@ RingBuffer<T>::get_read_vector (typename RingBuffer<T>::rw_vector *vec)
 {
 	guint free_cnt;
 	guint cnt2;
-	guint w, r;
+	guint r;
 
-	w = g_atomic_int_get (&write_idx);
-	r = g_atomic_int_get (&read_idx);
-
-	if (w > r) {
-		free_cnt = w - r;
-	} else {
-		free_cnt = (w - r + size) & size_mask;
-	}
+	r = PBD::atomic_int_get_relaxed (&read_idx);
+	free_cnt = reader_space (r, size);
 
 	cnt2 = r + free_cnt;
 
@@ -246,18 +289,10 @@ RingBuffer<T>::get_write_vector (typename RingBuffer<T>::rw_vector *vec)
 {
 	guint free_cnt;
 	guint cnt2;
-	guint w, r;
-
-	w = g_atomic_int_get (&write_idx);
-	r = g_atomic_int_get (&read_idx);
+	guint w;
 
-	if (w > r) {
-		free_cnt = ((r - w + size) & size_mask) - 1;
-	} else if (w < r) {
-		free_cnt = (r - w) - 1;
-	} else {
-		free_cnt = size - 1;
-	}
+	w = PBD::atomic_int_get_relaxed (&write_idx);
+	free_cnt = writer_space (w, size);
 
 	cnt2 = w + free_cnt;
 
@@ -26,11 +26,15 @@
 #include <glib.h>
 
 #include "pbd/libpbd_visibility.h"
+#include "pbd/memory_order.h"
 
 namespace PBD {
 
 /* ringbuffer class where the element size is not required to be a power of two */
 
+/** As RingBuffer, the writer's and reader's state are on separate cache
+ *  lines and each side caches its last sight of the other's pointer.
+ */
 template<class T>
 class /*LIBPBD_API*/ RingBufferNPT
 {
@@ -47,14 +51,15 @@ class /*LIBPBD_API*/ RingBufferNPT
 
 	void reset () {
 		/* !!! NOT THREAD SAFE !!! */
-		g_atomic_int_set (&write_ptr, 0);
-		g_atomic_int_set (&read_ptr, 0);
+		set (0, 0);
 	}
 
 	void set (size_t r, size_t w) {
 		/* !!! NOT THREAD SAFE !!! */
 		g_atomic_int_set (&write_ptr, w);
 		g_atomic_int_set (&read_ptr, r);
+		cached_read_ptr = r;
+		cached_write_ptr = w;
 	}
 
 	size_t  read  (T *dest, size_t cnt);
@@ -69,56 +74,92 @@ class /*LIBPBD_API*/ RingBufferNPT
 	void get_read_vector (rw_vector *);
 	void get_write_vector (rw_vector *);
 
+	/** As get_read_vector(), but safe to call from any thread: it reads
+	 *  both live pointers and leaves the reader's cached state alone.
+	 */
+	void peek_read_vector (rw_vector *) const;
+
 	void decrement_read_ptr (size_t cnt) {
-		g_atomic_int_set (&read_ptr, (g_atomic_int_get(&read_ptr) - cnt) % size);
+		/* reader only; as RingBuffer::decrement_read_idx() */
+		atomic_int_set_release (&read_ptr, (atomic_int_get_relaxed (&read_ptr) + size - cnt) % size);
 	}
 
 	void increment_read_ptr (size_t cnt) {
-		g_atomic_int_set (&read_ptr, (g_atomic_int_get(&read_ptr) + cnt) % size);
+		atomic_int_set_release (&read_ptr, (atomic_int_get_relaxed (&read_ptr) + cnt) % size);
 	}
 
 	void increment_write_ptr (size_t cnt) {
-		g_atomic_int_set (&write_ptr,  (g_atomic_int_get(&write_ptr) + cnt) % size);
+		atomic_int_set_release (&write_ptr, (atomic_int_get_relaxed (&write_ptr) + cnt) % size);
 	}
 
 	size_t write_space () {
 		size_t w, r;
 
-		w = g_atomic_int_get (&write_ptr);
-		r = g_atomic_int_get (&read_ptr);
+		w = atomic_int_get_acquire (&write_ptr);
+		r = atomic_int_get_acquire (&read_ptr);
 
-		if (w > r) {
-			return ((r - w + size) % size) - 1;
-		} else if (w < r) {
-			return (r - w) - 1;
-		} else {
-			return size - 1;
-		}
+		return space_between (r, w);
 	}
 
 	size_t read_space () {
 		size_t w, r;
 
-		w = g_atomic_int_get (&write_ptr);
-		r = g_atomic_int_get (&read_ptr);
+		w = atomic_int_get_acquire (&write_ptr);
+		r = atomic_int_get_acquire (&read_ptr);
 
-		if (w > r) {
-			return w - r;
-		} else {
-			return (w - r + size) % size;
-		}
+		return data_between (r, w);
 	}
 
 	T *buffer () { return buf; }
-	size_t get_write_ptr () const { return g_atomic_int_get (&write_ptr); }
-	size_t get_read_ptr () const { return g_atomic_int_get (&read_ptr); }
+	size_t get_write_ptr () const { return atomic_int_get_acquire (&write_ptr); }
+	size_t get_read_ptr () const { return atomic_int_get_acquire (&read_ptr); }
 	size_t bufsize () const { return size; }
 
   protected:
 	T *buf;
 	size_t size;
+
+	char _pad0[PBD_CACHE_LINE_SIZE];
+
+	/* written by the writer */
 	mutable gint write_ptr;
+	size_t       cached_read_ptr;  ///< the writer's last sight of read_ptr
+	char _pad1[PBD_CACHE_LINE_SIZE];
+
+	/* written by the reader */
 	mutable gint read_ptr;
+	size_t       cached_write_ptr; ///< the reader's last sight of write_ptr
+	char _pad2[PBD_CACHE_LINE_SIZE];
+
+	size_t space_between (size_t r, size_t w) const {
+		return (r + size - w - 1) % size;
+	}
+
+	size_t data_between (size_t r, size_t w) const {
+		return (w + size - r) % size;
+	}
+
+	/** Writer only: @return space available for writing, reloading
+	 *  read_ptr only if the cached value shows less than @param wanted.
+	 */
+	size_t writer_space (size_t w, size_t wanted) {
+		size_t space = space_between (cached_read_ptr, w);
+		if (space < wanted) {
+			cached_read_ptr = atomic_int_get_acquire (&read_ptr);
+			space = space_between (cached_read_ptr, w);
+		}
+		return space;
+	}
+
+	/** Reader only: as writer_space(), for data available to read */
+	size_t reader_space (size_t r, size_t wanted) {
+		size_t space = data_between (r, cached_write_ptr);
+		if (space < wanted) {
+			cached_write_ptr = atomic_int_get_acquire (&write_ptr);
+			space = data_between (r, cached_write_ptr);
+		}
+		return space;
+	}
 };
 
 template<class T> /*LIBPBD_API*/ size_t
@@ -130,9 +171,9 @@ RingBufferNPT<T>::read (T *dest, size_t cnt)
         size_t n1, n2;
         size_t priv_read_ptr;
 
-        priv_read_ptr=g_atomic_int_get(&read_ptr);
+        priv_read_ptr = atomic_int_get_relaxed (&read_ptr);
 
-        if ((free_cnt = read_space ()) == 0) {
+        if ((free_cnt = reader_space (priv_read_ptr, cnt)) == 0) {
                 return 0;
         }
 
@@ -156,7 +197,7 @@ RingBufferNPT<T>::read (T *dest, size_t cnt)
                 priv_read_ptr = n2;
         }
 
-        g_atomic_int_set(&read_ptr, priv_read_ptr);
+        atomic_int_set_release (&read_ptr, priv_read_ptr);
         return to_read;
 }
 
@@ -169,9 +210,9 @@ RingBufferNPT<T>::write (const T *src, size_t cnt)
         size_t n1, n2;
         size_t priv_write_ptr;
 
-        priv_write_ptr=g_atomic_int_get(&write_ptr);
+        priv_write_ptr = atomic_int_get_relaxed (&write_ptr);
 
-        if ((free_cnt = write_space ()) == 0) {
+        if ((free_cnt = writer_space (priv_write_ptr, cnt)) == 0) {
                 return 0;
         }
 
@@ -195,7 +236,7 @@ RingBufferNPT<T>::write (const T *src, size_t cnt)
                 priv_write_ptr = n2;
         }
 
-        g_atomic_int_set(&write_ptr, priv_write_ptr);
+        atomic_int_set_release (&write_ptr, priv_write_ptr);
         return to_write;
 }
 
@@ -210,16 +251,10 @@ RingBufferNPT<T>::get_read_vector (typename RingBufferNPT<T>::rw_vector *vec)
 {
 	size_t free_cnt;
 	size_t cnt2;
-	size_t w, r;
+	size_t r;
 
-	w = g_atomic_int_get (&write_ptr);
-	r = g_atomic_int_get (&read_ptr);
-
-	if (w > r) {
-		free_cnt = w - r;
-	} else {
-		free_cnt = (w - r + size) % size;
-	}
+	r = atomic_int_get_relaxed (&read_ptr);
+	free_cnt = reader_space (r, size);
 
 	cnt2 = r + free_cnt;
 
@@ -246,22 +281,39 @@ RingBufferNPT<T>::get_read_vector (typename RingBufferNPT<T>::rw_vector *vec)
 }
 
 template<class T> /*LIBPBD_API*/ void
-RingBufferNPT<T>::get_write_vector (typename RingBufferNPT<T>::rw_vector *vec)
+RingBufferNPT<T>::peek_read_vector (typename RingBufferNPT<T>::rw_vector *vec) const
 {
 	size_t free_cnt;
 	size_t cnt2;
-	size_t w, r;
+	size_t r;
 
-	w = g_atomic_int_get (&write_ptr);
-	r = g_atomic_int_get (&read_ptr);
+	r = atomic_int_get_acquire (&read_ptr);
+	free_cnt = data_between (r, atomic_int_get_acquire (&write_ptr));
 
-	if (w > r) {
-		free_cnt = ((r - w + size) % size) - 1;
-	} else if (w < r) {
-		free_cnt = (r - w) - 1;
+	cnt2 = r + free_cnt;
+
+	if (cnt2 > size) {
+		vec->buf[0] = &buf[r];
+		vec->len[0] = size - r;
+		vec->buf[1] = buf;
+		vec->len[1] = cnt2 % size;
 	} else {
-		free_cnt = size - 1;
+		vec->buf[0] = &buf[r];
+		vec->len[0] = free_cnt;
+		vec->buf[1] = 0;
+		vec->len[1] = 0;
 	}
+}
+
+template<class T> /*LIBPBD_API*/ void
+RingBufferNPT<T>::get_write_vector (typename RingBufferNPT<T>::rw_vector *vec)
+{
+	size_t free_cnt;
+	size_t cnt2;
+	size_t w;
+
+	w = atomic_int_get_relaxed (&write_ptr);
+	free_cnt = writer_space (w, size);
 
 	cnt2 = w + free_cnt;
 
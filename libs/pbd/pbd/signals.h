@@ -24,6 +24,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #ifdef nil
 #undef nil
@@ -78,7 +79,7 @@ protected:
 class LIBPBD_API Connection : public boost::enable_shared_from_this<Connection>
 {
 public:
-	Connection (SignalBase* b, PBD::EventLoop::InvalidationRecord* ir) : _signal (b), _invalidation_record (ir)
+	Connection (SignalBase* b, PBD::EventLoop::InvalidationRecord* ir) : _signal (b), _invalidation_record (ir), _connected (1)
 	{
 		if (_invalidation_record) {
 			_invalidation_record->ref ();
@@ -96,14 +97,21 @@ public:
 
 	void disconnected ()
 	{
+		g_atomic_int_set (&_connected, 0);
 		if (_invalidation_record) {
 			_invalidation_record->unref ();
 		}
 	}
 
+	/** @return false once disconnected from its signal; may be called
+	 *  from any thread, without locking.
+	 */
+	bool connected () const { return g_atomic_int_get (const_cast<gint*>(&_connected)); }
+
 	void signal_going_away ()
 	{
 		Glib::Threads::Mutex::Lock lm (_mutex);
+		g_atomic_int_set (&_connected, 0);
 		if (_invalidation_record) {
 			_invalidation_record->unref ();
 		}
@@ -114,6 +122,48 @@ private:
         Glib::Threads::Mutex _mutex;
 	SignalBase* _signal;
 	PBD::EventLoop::InvalidationRecord* _invalidation_record;
+	gint _connected;
+};
+
+/** The slots of a signal, as used for emitting it.
+
+    Emission uses a list of slots made the first time a signal is emitted
+    after a slot is connected or disconnected. Each emission takes its own
+    reference to that list, so it stays valid even if a slot destroys the
+    signal; taking the reference is all an emission does under the
+    signal's mutex, and nothing is allocated unless the list was dropped.
+
+    Connecting or disconnecting drops the signal's reference, so a
+    disconnected slot (and whatever it is bound to) is released there and
+    then, unless an emission still using the old list is in progress.
+    Connecting many slots between emissions, as happens when a session is
+    loaded, still builds the list only once.
+*/
+template<typename F>
+class /*LIBPBD_API*/ EmissionSlots
+{
+public:
+	typedef std::vector<std::pair<boost::shared_ptr<Connection>, F> > List;
+	typedef std::map<boost::shared_ptr<Connection>, F> Slots;
+
+	/** Note that @a slots has changed. Must be called with the signal's
+	    mutex held.
+	*/
+	void invalidate () { _list.reset (); }
+
+	/** @return the list for one emission of @a slots. Must be called with
+	    the signal's mutex held.
+	*/
+	boost::shared_ptr<List const> list (Slots const & slots)
+	{
+		if (!_list) {
+			_list.reset (new List (slots.begin(), slots.end()));
+		}
+		return _list;
+	}
+
+private:
+	boost::shared_ptr<List const> _list;
 };
 
 template<typename R>
@@ -104,6 +104,7 @@ def signal(f, n, v):
 	/** The slots that this signal will call on emission */
 	typedef std::map<boost::shared_ptr<Connection>, slot_function_type> Slots;
 	Slots _slots;
+	EmissionSlots<slot_function_type> _emission_slots;
 """, file=f)
 
     print("public:", file=f)
@@ -230,30 +231,24 @@ def signal(f, n, v):
     else:
         print("\ttypename C::result_type operator() (%s)" % comma_separated(Anan), file=f)
     print("\t{", file=f)
-    print("\t\t/* First, take a copy of our list of slots as it is now */", file=f)
+    print("\t\t/* Take a reference to our list of slots as it is now; that keeps it\n\t\t   alive even if a slot disconnects others, or destroys us.\n\t\t*/", file=f)
     print("", file=f)
-    print("\t\tSlots s;", file=f)
+    print("\t\tboost::shared_ptr<%sEmissionSlots<slot_function_type>::List const> s;" % typename, file=f)
     print("\t\t{", file=f)
     print("\t\t\tGlib::Threads::Mutex::Lock lm (_mutex);", file=f)
-    print("\t\t\ts = _slots;", file=f)
+    print("\t\t\ts = _emission_slots.list (_slots);", file=f)
     print("\t\t}", file=f)
     print("", file=f)
     if not v:
         print("\t\tstd::list<R> r;", file=f)
-    print("\t\tfor (%sSlots::const_iterator i = s.begin(); i != s.end(); ++i) {" % typename, file=f)
+    print("\t\tfor (%sEmissionSlots<slot_function_type>::List::const_iterator i = s->begin(); i != s->end(); ++i) {" % typename, file=f)
     print("""
 			/* We may have just called a slot, and this may have resulted in
-			   disconnection of other slots from us.  The list copy means that
-			   this won't cause any problems with invalidated iterators, but we
-			   must check to see if the slot we are about to call is still on the list.
+			   disconnection of other slots from us, or our destruction.  The
+			   list we use is not changed by that, but we must check to see if
+			   the slot we are about to call is still connected.
 			*/
-			bool still_there = false;
-			{
-				Glib::Threads::Mutex::Lock lm (_mutex);
-				still_there = _slots.find (i->first) != _slots.end ();
-			}
-
-			if (still_there) {""", file=f)
+			if (i->first->connected ()) {""", file=f)
     if v:
         print("\t\t\t\t(i->second)(%s);" % comma_separated(an), file=f)
     else:
@@ -295,6 +290,7 @@ def signal(f, n, v):
 		boost::shared_ptr<Connection> c (new Connection (this, ir));
 		Glib::Threads::Mutex::Lock lm (_mutex);
 		_slots[c] = f;
+		_emission_slots.invalidate ();
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
                 if (_debug_connection) {
                         std::cerr << "+++++++ CONNECT " << this << " size now " << _slots.size() << std::endl;
@@ -310,6 +306,7 @@ def signal(f, n, v):
 		{
 			Glib::Threads::Mutex::Lock lm (_mutex);
     			_slots.erase (c);
+			_emission_slots.invalidate ();
     		}
 		c->disconnected ();
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
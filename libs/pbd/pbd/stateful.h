@@ -103,8 +103,22 @@ class LIBPBD_API Stateful {
 
 	bool property_changes_suspended() const { return g_atomic_int_get (const_cast<gint*>(&_stateful_frozen)) > 0; }
 
+	/** @return a number which changes whenever a property of this object
+	 *  changes, or the object otherwise says that its state has changed
+	 *  (see state_changed()). Comparing it with an earlier value tells
+	 *  whether get_state() could now return something different.
+	 *  Changes made directly to the node returned by extra_xml() are not
+	 *  noticed.
+	 */
+	guint state_generation () const { return g_atomic_int_get (const_cast<gint*>(&_state_generation)); }
+
   protected:
 
+	/** Derived classes call this when their state changes other than
+	 *  through send_change().
+	 */
+	void state_changed () { g_atomic_int_inc (&_state_generation); }
+
 	void add_instant_xml (XMLNode&, const std::string& directory_path);
 	XMLNode *instant_xml (const std::string& str, const std::string& directory_path);
 	void add_properties (XMLNode &);
@@ -138,6 +152,7 @@ class LIBPBD_API Stateful {
 	static Glib::Threads::Private<bool> _regenerate_xml_or_string_ids;
 	PBD::ID  _id;
 	gint     _stateful_frozen;
+	gint     _state_generation;
 
 	static void set_regenerate_xml_and_string_ids_in_this_thread (bool yn);
 };
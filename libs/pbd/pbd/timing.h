@@ -181,6 +181,68 @@ private:
 
 };
 
+/** A summary of a series of durations, see TimingStats */
+struct LIBPBD_API DurationStats
+{
+	/** histogram bucket 0 counts durations of less than 1 usec;
+	 *  bucket n, durations of [2^(n-1), 2^n) usecs. The last
+	 *  bucket also counts anything longer.
+	 */
+	static const uint32_t n_buckets = 16;
+
+	DurationStats () { clear (); }
+
+	void clear ();
+
+	uint64_t count;    ///< number of durations
+	uint64_t min_ns;
+	uint64_t max_ns;
+	uint64_t total_ns;
+	uint64_t last_ns;  ///< the most recent duration
+	uint32_t histogram[n_buckets];
+
+	double min_usecs () const { return count ? min_ns / 1000.0 : 0; }
+	double max_usecs () const { return max_ns / 1000.0; }
+	double avg_usecs () const { return count ? total_ns / (1000.0 * count) : 0; }
+	double last_usecs () const { return last_ns / 1000.0; }
+	uint32_t bucket (uint32_t n) const { return n < n_buckets ? histogram[n] : 0; }
+
+	static uint32_t bucket_for (uint64_t ns);
+};
+
+/** Statistics of the time taken by some code that a (realtime) thread
+ *  runs over and over, e.g. once per process cycle.
+ *
+ *  Only one thread may call start() and update(); any thread may call
+ *  get() and reset(). Neither side ever blocks or allocates: readers
+ *  retry if they catch the writer in the middle of an update.
+ */
+class LIBPBD_API TimingStats
+{
+public:
+	TimingStats ();
+
+	void start () { _start = now (); }
+	void update ();
+
+	/** Clear the statistics. The writer does this the next time it
+	 *  calls update(); until then get() reports nothing.
+	 */
+	void reset ();
+
+	/** @return false if there is nothing to report */
+	bool get (DurationStats&) const;
+
+	/** @return a monotonic time in nanoseconds */
+	static uint64_t now ();
+
+private:
+	mutable gint  _seq;    ///< odd while the writer is updating _stats
+	gint          _reset;
+	uint64_t      _start;
+	DurationStats _stats;
+};
+
 } // namespace PBD
 
 #endif // __libpbd_timing_h__
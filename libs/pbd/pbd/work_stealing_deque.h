@@ -0,0 +1,157 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __pbd_work_stealing_deque_h__
+#define __pbd_work_stealing_deque_h__
+
+#include <cassert>
+#include <glib.h>
+
+#include "pbd/libpbd_visibility.h"
+
+namespace PBD {
+
+/** A bounded, lock-free work-stealing deque of pointers (Chase & Lev, 2005).
+ *
+ *  One thread owns the deque and may push() and pop() at the bottom end;
+ *  any other thread may steal() from the top end. No operation blocks or
+ *  allocates, so it is usable from realtime threads.
+ *
+ *  The indices are free-running and only ever compared by difference,
+ *  so they may wrap around. The capacity is fixed at construction and
+ *  rounded up to a power of two; push() fails if the deque is full.
+ */
+template<class T>
+class /*LIBPBD_API*/ WorkStealingDeque
+{
+  public:
+	WorkStealingDeque (guint sz)
+	{
+		guint power_of_two;
+		for (power_of_two = 1; 1U << power_of_two < sz; ++power_of_two) {}
+		_size = 1 << power_of_two;
+		_size_mask = _size - 1;
+		_buf = new T*[_size];
+		g_atomic_int_set (&_top, 0);
+		g_atomic_int_set (&_bottom, 0);
+	}
+
+	~WorkStealingDeque ()
+	{
+		delete [] _buf;
+	}
+
+	/** Owner only: add @param x at the bottom end. */
+	bool push (T* x)
+	{
+		guint b = g_atomic_int_get (&_bottom);
+		guint t = g_atomic_int_get (&_top);
+
+		if (b - t >= _size) {
+			return false;
+		}
+
+		g_atomic_pointer_set (&_buf[b & _size_mask], x);
+		g_atomic_int_set (&_bottom, b + 1);
+		return true;
+	}
+
+	/** Owner only: remove the most recently pushed element.
+	 *  @return the element, or 0 if the deque is empty.
+	 */
+	T* pop ()
+	{
+		guint b = (guint) g_atomic_int_get (&_bottom) - 1;
+		g_atomic_int_set (&_bottom, b);
+
+		guint t = g_atomic_int_get (&_top);
+
+		if ((gint) (b - t) < 0) {
+			/* empty */
+			g_atomic_int_set (&_bottom, t);
+			return 0;
+		}
+
+		T* x = (T*) g_atomic_pointer_get (&_buf[b & _size_mask]);
+
+		if (b != t) {
+			/* more than one element left, no thief can get to this one */
+			return x;
+		}
+
+		/* last element: race any thieves for it */
+		if (!g_atomic_int_compare_and_exchange (&_top, t, t + 1)) {
+			x = 0;
+		}
+		g_atomic_int_set (&_bottom, t + 1);
+		return x;
+	}
+
+	/** Any thread: remove the oldest element.
+	 *  @return the element, or 0 if the deque is empty or if
+	 *  another thread won the race for it.
+	 */
+	T* steal ()
+	{
+		guint t = g_atomic_int_get (&_top);
+		guint b = g_atomic_int_get (&_bottom);
+
+		if ((gint) (b - t) <= 0) {
+			return 0;
+		}
+
+		T* x = (T*) g_atomic_pointer_get (&_buf[t & _size_mask]);
+
+		if (!g_atomic_int_compare_and_exchange (&_top, t, t + 1)) {
+			return 0;
+		}
+		return x;
+	}
+
+	/** Approximate number of elements; only exact when quiescent. */
+	guint size () const
+	{
+		gint n = (gint) ((guint) g_atomic_int_get (&_bottom) - (guint) g_atomic_int_get (&_top));
+		return n > 0 ? n : 0;
+	}
+
+	bool empty () const { return size () == 0; }
+
+	guint capacity () const { return _size; }
+
+  private:
+	WorkStealingDeque (WorkStealingDeque const &);
+	WorkStealingDeque& operator= (WorkStealingDeque const &);
+
+	/* top is written by thieves, bottom by the owner: keep them
+	 * on separate cache lines.
+	 */
+	mutable gint _top;
+	char         _pad0[64 - sizeof (gint)];
+	mutable gint _bottom;
+	char         _pad1[64 - sizeof (gint)];
+
+	T**   _buf;
+	guint _size;
+	guint _size_mask;
+};
+
+} /* namespace PBD */
+
+#endif /* __pbd_work_stealing_deque_h__ */
@@ -51,6 +51,7 @@ Stateful::Stateful ()
 	, _instant_xml (0)
 	, _properties (new OwnedPropertyList)
 	, _stateful_frozen (0)
+	, _state_generation (0)
 {
 }
 
@@ -73,6 +74,8 @@ Stateful::add_extra_xml (XMLNode& node)
 
 	_extra_xml->remove_nodes_and_delete (node.name());
 	_extra_xml->add_child_nocopy (node);
+
+	state_changed ();
 }
 
 XMLNode *
@@ -283,6 +286,8 @@ Stateful::send_change (const PropertyChange& what_changed)
 		return;
 	}
 
+	state_changed ();
+
 	{
 		Glib::Threads::Mutex::Lock lm (_lock);
 		if (property_changes_suspended ()) {
@@ -0,0 +1,28 @@
+#include "cpus_test.h"
+#include "pbd/cpus.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (CPUsTest);
+
+using namespace std;
+
+void
+CPUsTest::testParseCPUList ()
+{
+	vector<int> cpus;
+
+	CPPUNIT_ASSERT (parse_cpu_list ("0-3,8,10-11\n", cpus));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 7, cpus.size ());
+	CPPUNIT_ASSERT_EQUAL (0, cpus[0]);
+	CPPUNIT_ASSERT_EQUAL (3, cpus[3]);
+	CPPUNIT_ASSERT_EQUAL (8, cpus[4]);
+	CPPUNIT_ASSERT_EQUAL (11, cpus[6]);
+
+	CPPUNIT_ASSERT (parse_cpu_list ("5", cpus));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, cpus.size ());
+	CPPUNIT_ASSERT_EQUAL (5, cpus[0]);
+
+	CPPUNIT_ASSERT (!parse_cpu_list ("", cpus));
+	CPPUNIT_ASSERT (!parse_cpu_list ("3-1", cpus));
+	CPPUNIT_ASSERT (!parse_cpu_list ("0-", cpus));
+	CPPUNIT_ASSERT (!parse_cpu_list ("0;1", cpus));
+}
@@ -0,0 +1,142 @@
+#include <cstdlib>
+#include <vector>
+
+#include "interval_tree_test.h"
+#include "pbd/interval_tree.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (IntervalTreeTest);
+
+using namespace std;
+
+typedef PBD::IntervalTree<long, int> Tree;
+
+void
+IntervalTreeTest::testBasic ()
+{
+	Tree t;
+	vector<int> r;
+
+	t.find_overlapping (0, 100, r);
+	CPPUNIT_ASSERT (r.empty ());
+
+	t.insert (1, 10, 19);
+	t.insert (2, 0, 99);
+	t.insert (3, 20, 29);
+	t.insert (4, 10, 12);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 4, t.size ());
+
+	/* ordered by start, then by insertion */
+	t.find_overlapping (0, 100, r);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 4, r.size ());
+	CPPUNIT_ASSERT_EQUAL (2, r[0]);
+	CPPUNIT_ASSERT_EQUAL (1, r[1]);
+	CPPUNIT_ASSERT_EQUAL (4, r[2]);
+	CPPUNIT_ASSERT_EQUAL (3, r[3]);
+
+	r.clear ();
+	t.find_covering (19, r);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 2, r.size ());
+	CPPUNIT_ASSERT_EQUAL (2, r[0]);
+	CPPUNIT_ASSERT_EQUAL (1, r[1]);
+
+	r.clear ();
+	t.find_overlapping (100, 200, r);
+	CPPUNIT_ASSERT (r.empty ());
+
+	r.clear ();
+	t.find_starting_within (10, 20, r);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 3, r.size ());
+	CPPUNIT_ASSERT_EQUAL (1, r[0]);
+	CPPUNIT_ASSERT_EQUAL (4, r[1]);
+	CPPUNIT_ASSERT_EQUAL (3, r[2]);
+
+	CPPUNIT_ASSERT (t.any_covering (50));
+	CPPUNIT_ASSERT (!t.any_covering (100));
+
+	CPPUNIT_ASSERT (t.erase (2));
+	CPPUNIT_ASSERT (!t.erase (2));
+	CPPUNIT_ASSERT (!t.any_covering (50));
+
+	t.clear ();
+	CPPUNIT_ASSERT (t.empty ());
+}
+
+void
+IntervalTreeTest::testMove ()
+{
+	Tree t;
+	vector<int> r;
+
+	t.insert (1, 0, 9);
+	t.insert (2, 0, 9);
+
+	/* moving re-inserts, so 1 now comes after 2 */
+	t.insert (1, 0, 9);
+	t.insert (1, 5, 9);
+	t.insert (1, 0, 9);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 2, t.size ());
+
+	t.find_covering (0, r);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 2, r.size ());
+	CPPUNIT_ASSERT_EQUAL (2, r[0]);
+	CPPUNIT_ASSERT_EQUAL (1, r[1]);
+
+	t.insert (2, 100, 109);
+	r.clear ();
+	t.find_covering (5, r);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, r.size ());
+	CPPUNIT_ASSERT_EQUAL (1, r[0]);
+}
+
+void
+IntervalTreeTest::testRandom ()
+{
+	const int n = 500;
+	Tree t;
+	vector<long> first (n, -1);
+	vector<long> last (n, -1);
+
+	srand (17);
+
+	for (int iter = 0; iter < 20000; ++iter) {
+		int v = rand () % n;
+
+		if (rand () % 4 == 0) {
+			t.erase (v);
+			first[v] = last[v] = -1;
+		} else {
+			first[v] = rand () % 10000;
+			last[v] = first[v] + rand () % (rand () % 8 ? 100 : 5000);
+			t.insert (v, first[v], last[v]);
+		}
+
+		if (iter % 50) {
+			continue;
+		}
+
+		long from = rand () % 11000;
+		long to = from + rand () % 300;
+		vector<int> r;
+		t.find_overlapping (from, to, r);
+
+		vector<bool> seen (n, false);
+		long prev = -1;
+
+		for (vector<int>::const_iterator i = r.begin(); i != r.end(); ++i) {
+			CPPUNIT_ASSERT (!seen[*i]);
+			CPPUNIT_ASSERT (first[*i] >= prev);
+			seen[*i] = true;
+			prev = first[*i];
+		}
+
+		bool covered = false;
+
+		for (int i = 0; i < n; ++i) {
+			bool const overlaps = first[i] >= 0 && first[i] <= to && last[i] >= from;
+			CPPUNIT_ASSERT_EQUAL (overlaps, (bool) seen[i]);
+			covered = covered || (first[i] >= 0 && first[i] <= from && last[i] >= from);
+		}
+
+		CPPUNIT_ASSERT_EQUAL (covered, t.any_covering (from));
+	}
+}
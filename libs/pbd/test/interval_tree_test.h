@@ -0,0 +1,16 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class IntervalTreeTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (IntervalTreeTest);
+	CPPUNIT_TEST (testBasic);
+	CPPUNIT_TEST (testMove);
+	CPPUNIT_TEST (testRandom);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void testBasic ();
+	void testMove ();
+	void testRandom ();
+};
@@ -0,0 +1,152 @@
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <glib.h>
+#include <glibmm/threads.h>
+
+#include "pbd/ringbuffer.h"
+#include "pbd/ringbufferNPT.h"
+
+/* Producer/consumer throughput of RingBuffer and RingBufferNPT, compared
+ * with the index layout RingBuffer used to have. One thread writes
+ * `total' items, another reads them and checks that they arrive in order,
+ * for a range of items per read/write call.
+ */
+
+using namespace std;
+
+/* both indices next to each other, every access a full barrier, nothing cached */
+template<class T>
+class OldRingBuffer
+{
+  public:
+	OldRingBuffer (guint sz) : size (sz), size_mask (sz - 1), buf (new T[sz]) {
+		g_atomic_int_set (&write_idx, 0);
+		g_atomic_int_set (&read_idx, 0);
+	}
+	~OldRingBuffer () { delete [] buf; }
+
+	guint write (T const * src, guint cnt) {
+		guint w = g_atomic_int_get (&write_idx);
+		guint r = g_atomic_int_get (&read_idx);
+		guint free_cnt = (r - w - 1) & size_mask;
+		guint n = cnt > free_cnt ? free_cnt : cnt;
+		guint n1 = min (n, size - w);
+		memcpy (&buf[w], src, n1 * sizeof (T));
+		memcpy (buf, src + n1, (n - n1) * sizeof (T));
+		g_atomic_int_set (&write_idx, (w + n) & size_mask);
+		return n;
+	}
+
+	guint read (T* dest, guint cnt) {
+		guint w = g_atomic_int_get (&write_idx);
+		guint r = g_atomic_int_get (&read_idx);
+		guint avail = (w - r) & size_mask;
+		guint n = cnt > avail ? avail : cnt;
+		guint n1 = min (n, size - r);
+		memcpy (dest, &buf[r], n1 * sizeof (T));
+		memcpy (dest + n1, buf, (n - n1) * sizeof (T));
+		g_atomic_int_set (&read_idx, (r + n) & size_mask);
+		return n;
+	}
+
+  private:
+	guint size;
+	guint size_mask;
+	T*    buf;
+	gint  write_idx;
+	gint  read_idx;
+};
+
+static const guint total = 1 << 24;
+
+template<class RB>
+struct Writer
+{
+	Writer (RB& rb, guint chunk) : _rb (rb), _chunk (chunk) {}
+
+	void run () {
+		vector<guint> v (_chunk);
+		guint n = 0;
+		while (n < total) {
+			guint const want = min (_chunk, total - n);
+			for (guint i = 0; i < want; ++i) {
+				v[i] = n + i;
+			}
+			guint done = 0;
+			while (done < want) {
+				guint const n = _rb.write (&v[done], want - done);
+				if (n == 0) {
+					Glib::Threads::Thread::yield ();
+				}
+				done += n;
+			}
+			n += want;
+		}
+	}
+
+	RB&   _rb;
+	guint _chunk;
+};
+
+/** Pass `total' items from one thread to another through @param rb,
+ *  @param chunk at a time.
+ *  @return items per microsecond, or 0 if they did not arrive in order.
+ */
+template<class RB>
+static double
+transfer (RB& rb, guint chunk)
+{
+	Writer<RB> w (rb, chunk);
+	vector<guint> v (chunk);
+	guint n = 0;
+	bool ok = true;
+
+	gint64 const start = g_get_monotonic_time ();
+	Glib::Threads::Thread* t = Glib::Threads::Thread::create (sigc::mem_fun (w, &Writer<RB>::run));
+
+	while (n < total) {
+		guint const got = rb.read (&v[0], chunk);
+		if (got == 0) {
+			Glib::Threads::Thread::yield ();
+		}
+		for (guint i = 0; i < got; ++i) {
+			ok = ok && (v[i] == n + i);
+		}
+		n += got;
+	}
+
+	t->join ();
+	gint64 const usecs = max ((gint64) 1, g_get_monotonic_time () - start);
+
+	return ok ? total / (double) usecs : 0;
+}
+
+int
+main ()
+{
+	cout << setw (8) << "chunk" << setw (12) << "old" << setw (12) << "RingBuffer" << setw (12) << "NPT" << "  (Mitems/s)" << endl;
+
+	for (guint chunk = 1; chunk <= 4096; chunk *= 4) {
+		OldRingBuffer<guint> old_rb (8192);
+		RingBuffer<guint> rb (8192);
+		PBD::RingBufferNPT<guint> npt (8192);
+
+		double const o = transfer (old_rb, chunk);
+		double const r = transfer (rb, chunk);
+		double const p = transfer (npt, chunk);
+
+		cout << setw (8) << chunk
+		     << fixed << setprecision (1)
+		     << setw (12) << o << setw (12) << r << setw (12) << p << endl;
+
+		if (o == 0 || r == 0 || p == 0) {
+			cerr << "data arrived out of order" << endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <vector>
+
+#include <glibmm/threads.h>
+
+#include "ringbuffer_test.h"
+#include "pbd/ringbuffer.h"
+#include "pbd/ringbufferNPT.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (RingBufferTest);
+
+using namespace std;
+
+static const guint total = 1 << 22; ///< items passed from writer to reader in the threaded tests
+
+template<class RB>
+struct Writer
+{
+	Writer (RB& rb, guint chunk) : _rb (rb), _chunk (chunk) {}
+
+	void run () {
+		vector<guint> v (_chunk);
+		guint n = 0;
+		while (n < total) {
+			guint const want = min (_chunk, total - n);
+			for (guint i = 0; i < want; ++i) {
+				v[i] = n + i;
+			}
+			guint done = 0;
+			while (done < want) {
+				guint const n = _rb.write (&v[done], want - done);
+				if (n == 0) {
+					Glib::Threads::Thread::yield ();
+				}
+				done += n;
+			}
+			n += want;
+		}
+	}
+
+	RB&   _rb;
+	guint _chunk;
+};
+
+/** @return true if all the data arrived in order */
+template<class RB>
+static bool
+read_all (RB& rb, guint chunk)
+{
+	vector<guint> v (chunk);
+	guint n = 0;
+	bool ok = true;
+
+	while (n < total) {
+		guint const got = rb.read (&v[0], chunk);
+		if (got == 0) {
+			Glib::Threads::Thread::yield ();
+		}
+		for (guint i = 0; i < got; ++i) {
+			ok = ok && (v[i] == n + i);
+		}
+		n += got;
+	}
+	return ok;
+}
+
+/** Pass `total' items from one thread to another through @param rb,
+ *  @param chunk at a time.
+ */
+template<class RB>
+static void
+transfer (RB& rb, guint chunk, bool& ok)
+{
+	Writer<RB> w (rb, chunk);
+	Glib::Threads::Thread* t = Glib::Threads::Thread::create (sigc::mem_fun (w, &Writer<RB>::run));
+	ok = read_all (rb, chunk);
+	t->join ();
+}
+
+void
+RingBufferTest::testBasic ()
+{
+	RingBuffer<int> rb (10);
+	CPPUNIT_ASSERT_EQUAL (16U, rb.bufsize ());
+	CPPUNIT_ASSERT_EQUAL (15U, rb.write_space ());
+	CPPUNIT_ASSERT_EQUAL (0U, rb.read_space ());
+
+	int in[32];
+	int out[32];
+	for (int i = 0; i < 32; ++i) {
+		in[i] = i;
+	}
+
+	/* go round a few times, so that both indices wrap */
+	for (int pass = 0; pass < 8; ++pass) {
+		CPPUNIT_ASSERT_EQUAL (11U, rb.write (in, 11));
+		CPPUNIT_ASSERT_EQUAL (4U, rb.write (in + 11, 11));
+		CPPUNIT_ASSERT_EQUAL (0U, rb.write (in, 1));
+		CPPUNIT_ASSERT_EQUAL (15U, rb.read_space ());
+		CPPUNIT_ASSERT_EQUAL (0U, rb.write_space ());
+
+		CPPUNIT_ASSERT_EQUAL (7U, rb.read (out, 7));
+		CPPUNIT_ASSERT_EQUAL (7U, rb.write_space ());
+
+		RingBuffer<int>::rw_vector vec;
+		rb.get_read_vector (&vec);
+		CPPUNIT_ASSERT_EQUAL (8U, vec.len[0] + vec.len[1]);
+		CPPUNIT_ASSERT_EQUAL (7, vec.buf[0][0]);
+
+		CPPUNIT_ASSERT_EQUAL (8U, rb.read (out + 7, 32));
+		for (int i = 0; i < 15; ++i) {
+			CPPUNIT_ASSERT_EQUAL (i, out[i]);
+		}
+		CPPUNIT_ASSERT_EQUAL (0U, rb.read (out, 1));
+
+		/* leave the indices somewhere else for the next pass */
+		CPPUNIT_ASSERT_EQUAL (3U, rb.write (in, 3));
+		CPPUNIT_ASSERT_EQUAL (3U, rb.read (out, 3));
+	}
+
+	rb.reset ();
+	CPPUNIT_ASSERT_EQUAL (15U, rb.write_space ());
+	CPPUNIT_ASSERT_EQUAL (0U, rb.read_space ());
+}
+
+void
+RingBufferTest::testNPT ()
+{
+	PBD::RingBufferNPT<int> rb (10);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 9, rb.write_space ());
+
+	int in[32];
+	int out[32];
+	for (int i = 0; i < 32; ++i) {
+		in[i] = i;
+	}
+
+	for (int pass = 0; pass < 8; ++pass) {
+		CPPUNIT_ASSERT_EQUAL ((size_t) 9, rb.write (in, 20));
+		CPPUNIT_ASSERT_EQUAL ((size_t) 0, rb.write_one (99));
+		CPPUNIT_ASSERT_EQUAL ((size_t) 9, rb.read_space ());
+
+		CPPUNIT_ASSERT_EQUAL ((size_t) 4, rb.read (out, 4));
+
+		PBD::RingBufferNPT<int>::rw_vector vec;
+		rb.get_write_vector (&vec);
+		CPPUNIT_ASSERT_EQUAL ((size_t) 4, vec.len[0] + vec.len[1]);
+
+		CPPUNIT_ASSERT_EQUAL ((size_t) 5, rb.read (out + 4, 32));
+		for (int i = 0; i < 9; ++i) {
+			CPPUNIT_ASSERT_EQUAL (i, out[i]);
+		}
+
+		CPPUNIT_ASSERT_EQUAL ((size_t) 3, rb.write (in, 3));
+		rb.increment_read_ptr (3);
+		CPPUNIT_ASSERT_EQUAL ((size_t) 0, rb.read_space ());
+	}
+}
+
+void
+RingBufferTest::testThreaded ()
+{
+	bool ok;
+
+	RingBuffer<guint> rb (1024);
+	transfer (rb, 100, ok);
+	CPPUNIT_ASSERT (ok);
+
+	PBD::RingBufferNPT<guint> npt (1000);
+	transfer (npt, 100, ok);
+	CPPUNIT_ASSERT (ok);
+}
+
+void
+RingBufferTest::testChunked ()
+{
+	bool ok;
+
+	for (guint chunk = 1; chunk <= 256; chunk *= 16) {
+		RingBuffer<guint> rb (4096);
+		transfer (rb, chunk, ok);
+		CPPUNIT_ASSERT (ok);
+
+		PBD::RingBufferNPT<guint> npt (4096);
+		transfer (npt, chunk, ok);
+		CPPUNIT_ASSERT (ok);
+	}
+}
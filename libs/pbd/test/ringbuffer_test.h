@@ -0,0 +1,18 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class RingBufferTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (RingBufferTest);
+	CPPUNIT_TEST (testBasic);
+	CPPUNIT_TEST (testNPT);
+	CPPUNIT_TEST (testThreaded);
+	CPPUNIT_TEST (testChunked);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void testBasic ();
+	void testNPT ();
+	void testThreaded ();
+	void testChunked ();
+};
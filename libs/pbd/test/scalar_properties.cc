@@ -45,3 +45,55 @@ ScalarPropertiesTest::testBasic ()
 	CPPUNIT_ASSERT (t);
 	CPPUNIT_ASSERT (t->val() == 5);
 }
+
+namespace {
+
+class Fred : public Stateful
+{
+public:
+	Fred ()
+		: _fred (Properties::fred, 0)
+	{
+		add_property (_fred);
+	}
+
+	XMLNode& get_state () { return *new XMLNode ("Fred"); }
+	int set_state (XMLNode const &, int) { return 0; }
+
+	void set_fred (int f) {
+		_fred = f;
+		send_change (PropertyChange (Properties::fred));
+	}
+
+	void send_nothing () { send_change (PropertyChange ()); }
+	void change_other_state () { state_changed (); }
+
+private:
+	Property<int> _fred;
+};
+
+}
+
+void
+ScalarPropertiesTest::testStateGeneration ()
+{
+	Fred f;
+
+	guint g = f.state_generation ();
+	f.set_fred (1);
+	CPPUNIT_ASSERT (f.state_generation () != g);
+
+	g = f.state_generation ();
+	f.send_nothing ();
+	CPPUNIT_ASSERT (f.state_generation () == g);
+
+	/* the state has changed, even if nobody has been told yet */
+	f.suspend_property_changes ();
+	f.set_fred (2);
+	CPPUNIT_ASSERT (f.state_generation () != g);
+	f.resume_property_changes ();
+
+	g = f.state_generation ();
+	f.change_other_state ();
+	CPPUNIT_ASSERT (f.state_generation () != g);
+}
@@ -1,16 +1,19 @@
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "pbd/properties.h"
+#include "pbd/stateful.h"
 
 class ScalarPropertiesTest : public CppUnit::TestFixture
 {
 	CPPUNIT_TEST_SUITE (ScalarPropertiesTest);
 	CPPUNIT_TEST (testBasic);
+	CPPUNIT_TEST (testStateGeneration);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
 	ScalarPropertiesTest ();
 	void testBasic ();
+	void testStateGeneration ();
 
 	static void make_property_quarks ();
 
@@ -0,0 +1,52 @@
+#include <iostream>
+#include <glib.h>
+
+#include "signals_benchmark.h"
+#include "pbd/signals.h"
+
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SignalsBenchmark);
+
+static int64_t received = 0;
+
+static void
+bench_receiver (int n)
+{
+	received += n;
+}
+
+/* Emits a signal with 0, 1 and 50 slots connected, and prints how many
+ * emissions per second that managed. Asserts only that every slot was
+ * called each time.
+ */
+void
+SignalsBenchmark::testEmission ()
+{
+	int const n_slots[] = { 0, 1, 50 };
+	int const emissions = 1000000;
+
+	cout << endl;
+
+	for (size_t i = 0; i < sizeof (n_slots) / sizeof (n_slots[0]); ++i) {
+
+		PBD::Signal1<void, int> signal;
+		PBD::ScopedConnectionList connections;
+
+		for (int n = 0; n < n_slots[i]; ++n) {
+			signal.connect_same_thread (connections, boost::bind (&bench_receiver, _1));
+		}
+
+		received = 0;
+
+		gint64 const start = g_get_monotonic_time ();
+		for (int n = 0; n < emissions; ++n) {
+			signal (1);
+		}
+		gint64 const elapsed = max ((gint64) 1, g_get_monotonic_time () - start);
+
+		cout << n_slots[i] << " slots: " << (emissions * 1e6 / elapsed) << " emissions/sec" << endl;
+
+		CPPUNIT_ASSERT_EQUAL ((int64_t) emissions * n_slots[i], received);
+	}
+}
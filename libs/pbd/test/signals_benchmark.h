@@ -0,0 +1,12 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class SignalsBenchmark : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (SignalsBenchmark);
+	CPPUNIT_TEST (testEmission);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void testEmission ();
+};
@@ -89,3 +89,89 @@ SignalsTest::testScopedConnectionList ()
 
 	CPPUNIT_ASSERT_EQUAL (1, N);
 }
+
+static void
+disconnecting_receiver (PBD::ScopedConnection* other)
+{
+	++N;
+	other->disconnect ();
+}
+
+/* Two slots which each disconnect the other: whichever runs first, the
+ * second must not be called, in that emission or afterwards.
+ */
+void
+SignalsTest::testDisconnectDuringEmission ()
+{
+	Emitter* e = new Emitter;
+	PBD::ScopedConnection a;
+	PBD::ScopedConnection b;
+
+	e->Fred.connect_same_thread (a, boost::bind (&disconnecting_receiver, &b));
+	e->Fred.connect_same_thread (b, boost::bind (&disconnecting_receiver, &a));
+
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (1, N);
+
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (1, N);
+
+	delete e;
+}
+
+static void
+destroying_receiver (Emitter** e)
+{
+	++N;
+	delete *e;
+	*e = 0;
+}
+
+/* A slot which destroys the signal's owner: the emission must finish
+ * without touching the signal, and the slot after it must not be called.
+ */
+void
+SignalsTest::testDestructionDuringEmission ()
+{
+	Emitter* e = new Emitter;
+	PBD::ScopedConnectionList connections;
+
+	e->Fred.connect_same_thread (connections, boost::bind (&destroying_receiver, &e));
+	e->Fred.connect_same_thread (connections, boost::bind (&receiver));
+
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (1, N);
+	CPPUNIT_ASSERT (e == 0);
+}
+
+static void
+holding_receiver (boost::shared_ptr<int>)
+{
+	++N;
+}
+
+/* Disconnecting a slot releases what it is bound to straight away, not on
+ * the next emission.
+ */
+void
+SignalsTest::testDisconnectReleasesSlot ()
+{
+	Emitter* e = new Emitter;
+	boost::shared_ptr<int> held (new int (0));
+	PBD::ScopedConnection c;
+
+	e->Fred.connect_same_thread (c, boost::bind (&holding_receiver, held));
+
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (1, N);
+	CPPUNIT_ASSERT (held.use_count () > 1);
+
+	c.disconnect ();
+	CPPUNIT_ASSERT_EQUAL (1L, held.use_count ());
+
+	delete e;
+}
@@ -0,0 +1,135 @@
+#include <vector>
+#include <pthread.h>
+
+#include "work_stealing_deque_test.h"
+#include "pbd/work_stealing_deque.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (WorkStealingDequeTest);
+
+using namespace std;
+
+typedef PBD::WorkStealingDeque<int> Deque;
+
+void
+WorkStealingDequeTest::testOwner ()
+{
+	Deque q (4);
+	int v[5] = { 0, 1, 2, 3, 4 };
+
+	CPPUNIT_ASSERT_EQUAL (4U, q.capacity ());
+	CPPUNIT_ASSERT (q.pop () == 0);
+
+	for (int i = 0; i < 4; ++i) {
+		CPPUNIT_ASSERT (q.push (&v[i]));
+	}
+	/* full */
+	CPPUNIT_ASSERT (!q.push (&v[4]));
+	CPPUNIT_ASSERT_EQUAL (4U, q.size ());
+
+	/* the owner sees LIFO order */
+	for (int i = 3; i >= 0; --i) {
+		CPPUNIT_ASSERT (q.pop () == &v[i]);
+	}
+	CPPUNIT_ASSERT (q.pop () == 0);
+	CPPUNIT_ASSERT (q.empty ());
+}
+
+void
+WorkStealingDequeTest::testSteal ()
+{
+	Deque q (8);
+	int v[3] = { 0, 1, 2 };
+
+	CPPUNIT_ASSERT (q.steal () == 0);
+
+	for (int i = 0; i < 3; ++i) {
+		q.push (&v[i]);
+	}
+
+	/* thieves see FIFO order */
+	CPPUNIT_ASSERT (q.steal () == &v[0]);
+	CPPUNIT_ASSERT (q.pop () == &v[2]);
+	CPPUNIT_ASSERT (q.steal () == &v[1]);
+	CPPUNIT_ASSERT (q.steal () == 0);
+	CPPUNIT_ASSERT (q.pop () == 0);
+
+	/* indices keep running after the deque drained */
+	for (int n = 0; n < 100; ++n) {
+		CPPUNIT_ASSERT (q.push (&v[n % 3]));
+		CPPUNIT_ASSERT (q.steal () == &v[n % 3]);
+	}
+}
+
+namespace {
+
+struct StealState {
+	Deque*        q;
+	volatile gint taken;
+	int           total;
+	volatile gint sum;
+};
+
+void*
+thief (void* arg)
+{
+	StealState* s = static_cast<StealState*> (arg);
+	while (g_atomic_int_get (&s->taken) < s->total) {
+		int* x = s->q->steal ();
+		if (x) {
+			g_atomic_int_add (&s->sum, *x);
+			g_atomic_int_inc (&s->taken);
+		}
+	}
+	return 0;
+}
+
+}
+
+void
+WorkStealingDequeTest::testConcurrent ()
+{
+	const int n = 100000;
+	vector<int> v (n, 1);
+	Deque q (256);
+
+	StealState s;
+	s.q = &q;
+	s.taken = 0;
+	s.total = n;
+	s.sum = 0;
+
+	pthread_t threads[3];
+	for (int t = 0; t < 3; ++t) {
+		pthread_create (&threads[t], 0, thief, &s);
+	}
+
+	int i = 0;
+	while (i < n) {
+		if (q.push (&v[i])) {
+			++i;
+		}
+		if ((i % 3) == 0) {
+			int* x = q.pop ();
+			if (x) {
+				g_atomic_int_add (&s.sum, *x);
+				g_atomic_int_inc (&s.taken);
+			}
+		}
+	}
+
+	while (g_atomic_int_get (&s.taken) < n) {
+		int* x = q.pop ();
+		if (x) {
+			g_atomic_int_add (&s.sum, *x);
+			g_atomic_int_inc (&s.taken);
+		}
+	}
+
+	for (int t = 0; t < 3; ++t) {
+		pthread_join (threads[t], 0);
+	}
+
+	/* every element was taken exactly once */
+	CPPUNIT_ASSERT_EQUAL (n, (int) g_atomic_int_get (&s.sum));
+	CPPUNIT_ASSERT (q.empty ());
+}
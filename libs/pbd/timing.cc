@@ -19,9 +19,14 @@
 
 #include "pbd/timing.h"
 
+#include <cstring>
 #include <sstream>
 #include <limits>
 
+#if !defined PLATFORM_WINDOWS && !defined __APPLE__
+#include <time.h>
+#endif
+
 #ifdef COMPILER_MSVC
 #undef min
 #undef max
@@ -68,4 +73,105 @@ timing_summary (const std::vector<uint64_t>& values)
 	return oss.str();
 }
 
+void
+DurationStats::clear ()
+{
+	count = 0;
+	min_ns = std::numeric_limits<uint64_t>::max();
+	max_ns = 0;
+	total_ns = 0;
+	last_ns = 0;
+	memset (histogram, 0, sizeof (histogram));
+}
+
+uint32_t
+DurationStats::bucket_for (uint64_t ns)
+{
+	uint64_t usecs = ns / 1000;
+	uint32_t n = 0;
+
+	while (usecs && n < n_buckets - 1) {
+		usecs >>= 1;
+		++n;
+	}
+	return n;
+}
+
+TimingStats::TimingStats ()
+	: _start (0)
+{
+	g_atomic_int_set (&_seq, 0);
+	g_atomic_int_set (&_reset, 0);
+}
+
+uint64_t
+TimingStats::now ()
+{
+#if defined PLATFORM_WINDOWS || defined __APPLE__
+	return g_get_monotonic_time () * 1000;
+#else
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+void
+TimingStats::update ()
+{
+	uint64_t const elapsed = now () - _start;
+
+	/* g_atomic_int_inc() is a full barrier, so _stats is only modified
+	 * while _seq is odd, as far as any reader can tell.
+	 */
+	g_atomic_int_inc (&_seq);
+
+	if (g_atomic_int_compare_and_exchange (&_reset, 1, 0)) {
+		_stats.clear ();
+	}
+
+	++_stats.count;
+	_stats.total_ns += elapsed;
+	_stats.last_ns = elapsed;
+	if (elapsed < _stats.min_ns) {
+		_stats.min_ns = elapsed;
+	}
+	if (elapsed > _stats.max_ns) {
+		_stats.max_ns = elapsed;
+	}
+	++_stats.histogram[DurationStats::bucket_for (elapsed)];
+
+	g_atomic_int_inc (&_seq);
+}
+
+void
+TimingStats::reset ()
+{
+	g_atomic_int_set (&_reset, 1);
+}
+
+bool
+TimingStats::get (DurationStats& stats) const
+{
+	if (g_atomic_int_get (&_reset)) {
+		return false;
+	}
+
+	/* the writer is never in update() for long; if we keep missing
+	 * it, it is being preempted, so give up rather than spin.
+	 */
+	for (int tries = 0; tries < 64; ++tries) {
+		gint const before = g_atomic_int_get (&_seq);
+		if (before & 1) {
+			continue;
+		}
+		memcpy (&stats, &_stats, sizeof (DurationStats));
+		if (g_atomic_int_get (&_seq) == before) {
+			return stats.count > 0;
+		}
+	}
+
+	return false;
+}
+
 } // namespace PBD
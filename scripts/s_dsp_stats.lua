@@ -0,0 +1,33 @@
+ardour { ["type"] = "Snippet", name = "DSP Statistics" }
+
+function factory () return function ()
+	-- the 10 processors that take longest to run, on average
+	local procs = Session:most_expensive_processors (10)
+
+	-- map processors back to the routes they belong to
+	local owner = {}
+	for r in Session:get_routes ():iter () do
+		local i = 0
+		while true do
+			local proc = r:nth_processor (i)
+			if proc:isnil () then break end
+			owner[proc:to_stateful ():id ():to_s ()] = r:name ()
+			i = i + 1
+		end
+	end
+
+	print ("----- DSP time per process cycle, in microseconds ----")
+	for p in procs:iter () do
+		-- get_dsp_stats() fills in its reference argument; t[1] is the DurationStats
+		local ok, t = p:get_dsp_stats (PBD.DurationStats ())
+		if ok then
+			local s = t[1]
+			print (string.format ("%-20s %-24s avg %8.1f  min %8.1f  max %8.1f  (%d cycles)",
+			       owner[p:to_stateful ():id ():to_s ()] or "?", p:display_name (),
+			       s:avg_usecs (), s:min_usecs (), s:max_usecs (), s.count))
+		end
+	end
+
+	-- start over for the next report
+	Session:reset_dsp_stats ()
+end end
@@ -106,7 +106,7 @@ SessionUtils::init (bool print_log)
 }
 
 // TODO return NULL, rather than exit() ?!
-static Session * _load_session (string dir, string state)
+static Session * _load_session (string dir, string state, uint32_t buffer_size)
 {
 	AudioEngine* engine = AudioEngine::create ();
 
@@ -132,6 +132,11 @@ static Session * _load_session (string dir, string state)
 		return 0;
 	}
 
+	if (buffer_size > 0 && engine->set_buffer_size (buffer_size)) {
+		std::cerr << "Cannot set buffer size.\n";
+		return 0;
+	}
+
 	init_post_engine ();
 
 	if (engine->start () != 0) {
@@ -145,23 +150,19 @@ static Session * _load_session (string dir, string state)
 }
 
 Session *
-SessionUtils::load_session (string dir, string state, bool exit_at_failure)
+SessionUtils::load_session (string dir, string state, bool exit_at_failure, uint32_t buffer_size)
 {
 	Session* s = 0;
 	try {
-		s = _load_session (dir, state);
+		s = _load_session (dir, state, buffer_size);
 	} catch (failed_constructor& e) {
 		cerr << "failed_constructor: " << e.what() << "\n";
-		::exit (EXIT_FAILURE);
 	} catch (AudioEngine::PortRegistrationFailure& e) {
 		cerr << "PortRegistrationFailure: " << e.what() << "\n";
-		::exit (EXIT_FAILURE);
 	} catch (exception& e) {
 		cerr << "exception: " << e.what() << "\n";
-		::exit (EXIT_FAILURE);
 	} catch (...) {
 		cerr << "unknown exception.\n";
-		::exit (EXIT_FAILURE);
 	}
 	if (!s && exit_at_failure) {
 		::exit (EXIT_FAILURE);
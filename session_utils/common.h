@@ -25,8 +25,10 @@ namespace SessionUtils {
 
 	/** @param dir Session directory.
 	 *  @param state Session state file, without .ardour suffix.
+	 *  @param exit_at_failure Exit the program if the session cannot be loaded, rather than returning NULL.
+	 *  @param buffer_size Engine buffer size in samples, or 0 for the backend's default.
 	 */
-	ARDOUR::Session * load_session (std::string dir, std::string state, bool exit_at_failure = true);
+	ARDOUR::Session * load_session (std::string dir, std::string state, bool exit_at_failure = true, uint32_t buffer_size = 0);
 
 	/** close session and stop engine
 	 * @param s Session to close (may me NULL)
@@ -0,0 +1,240 @@
+#include <iostream>
+#include <cstdlib>
+#include <getopt.h>
+#include <glibmm.h>
+
+#include "common.h"
+
+#include "ardour/export_handler.h"
+#include "ardour/export_status.h"
+#include "ardour/export_timespan.h"
+#include "ardour/export_channel_configuration.h"
+#include "ardour/export_format_specification.h"
+#include "ardour/export_filename.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/route.h"
+#include "ardour/broadcast_info.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace SessionUtils;
+
+/* Render a session's master bus as fast as the machine allows.
+ *
+ * The session runs on the dummy backend, which needs no sound card and,
+ * when freewheeling, starts each cycle as soon as the last one is done;
+ * routes are processed by the session's Graph on all DSP threads.  Large
+ * blocks keep the per-cycle overhead small.
+ */
+
+static int render_session (Session *session, std::string const & outdir, std::string const & name)
+{
+	ExportTimespanPtr tsp = session->get_export_handler()->add_timespan();
+	boost::shared_ptr<ExportChannelConfiguration> ccp = session->get_export_handler()->add_channel_config();
+	boost::shared_ptr<ARDOUR::ExportFilename> fnp = session->get_export_handler()->add_filename();
+	boost::shared_ptr<AudioGrapher::BroadcastInfo> b;
+
+	XMLTree tree;
+
+	/* 32bit float at the session's rate: no dither, no SRC, no clipping */
+	tree.read_buffer(std::string(
+"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+"<ExportFormatSpecification name=\"UTIL-WAV-FLOAT\" id=\"4d64ad4d-5bf0-4e1c-9d8a-8e8a1b4a6a11\">"
+"  <Encoding id=\"F_WAV\" type=\"T_Sndfile\" extension=\"wav\" name=\"WAV\" has-sample-format=\"true\" channel-limit=\"256\"/>"
+"  <SampleRate rate=\"1\"/>"
+"  <SRCQuality quality=\"SRC_SincBest\"/>"
+"  <EncodingOptions>"
+"    <Option name=\"sample-format\" value=\"SF_Float\"/>"
+"    <Option name=\"dithering\" value=\"D_None\"/>"
+"    <Option name=\"tag-metadata\" value=\"false\"/>"
+"    <Option name=\"tag-support\" value=\"false\"/>"
+"    <Option name=\"broadcast-info\" value=\"false\"/>"
+"  </EncodingOptions>"
+"  <Processing>"
+"    <Normalize enabled=\"false\" target=\"0\"/>"
+"    <Silence>"
+"      <Start>"
+"        <Trim enabled=\"false\"/>"
+"        <Add enabled=\"false\">"
+"          <Duration format=\"Timecode\" hours=\"0\" minutes=\"0\" seconds=\"0\" frames=\"0\"/>"
+"        </Add>"
+"      </Start>"
+"      <End>"
+"        <Trim enabled=\"false\"/>"
+"        <Add enabled=\"false\">"
+"          <Duration format=\"Timecode\" hours=\"0\" minutes=\"0\" seconds=\"0\" frames=\"0\"/>"
+"        </Add>"
+"      </End>"
+"    </Silence>"
+"  </Processing>"
+"</ExportFormatSpecification>"
+));
+
+	boost::shared_ptr<ExportFormatSpecification> fmp = session->get_export_handler()->add_format(*tree.root());
+
+	framepos_t start, end;
+	start = session->current_start_frame();
+	end   = session->current_end_frame();
+	tsp->set_range (start, end);
+	tsp->set_range_id ("session");
+	tsp->set_name (name);
+
+	IO* master_out = session->master_out() ? session->master_out()->output().get() : 0;
+	if (!master_out) {
+		cerr << "Session " << name << " has no master bus.\n";
+		return -1;
+	}
+
+	for (uint32_t n = 0; n < master_out->n_ports().n_audio(); ++n) {
+		PortExportChannel * channel = new PortExportChannel ();
+		channel->add_port (master_out->audio (n));
+		ExportChannelPtr chan_ptr (channel);
+		ccp->register_channel (chan_ptr);
+	}
+
+	if (!outdir.empty ()) {
+		fnp->set_folder (outdir);
+	}
+
+	fnp->set_timespan(tsp);
+	fnp->include_label = false;
+
+	fmp->set_soundcloud_upload(false);
+	session->get_export_handler()->add_export_config (tsp, ccp, fmp, fnp, b);
+
+	const gint64 t0 = g_get_monotonic_time ();
+
+	session->get_export_handler()->do_export();
+
+	boost::shared_ptr<ARDOUR::ExportStatus> status = session->get_export_status ();
+
+	/* poll often: a render of a short session may only take a moment */
+	while (status->running ()) {
+		Glib::usleep (10000);
+	}
+
+	const double elapsed = (g_get_monotonic_time () - t0) / 1e6;
+	const double duration = (end - start) / (double) session->nominal_frame_rate ();
+
+	const bool aborted = status->aborted ();
+	status->finish ();
+
+	if (aborted) {
+		cerr << "Rendering " << name << " failed.\n";
+		return -1;
+	}
+
+	printf ("* %s: %.1fs of audio in %.2fs (%.1fx realtime)\n",
+			Glib::build_filename (fnp->get_folder(), name + ".wav").c_str(),
+			duration, elapsed, elapsed > 0 ? duration / elapsed : 0.);
+
+	return 0;
+}
+
+static void usage (int status) {
+	// help2man compatible format (standard GNU help-text)
+	printf (UTILNAME " - render ardour sessions faster than realtime, without a sound card.\n\n");
+	printf ("Usage: " UTILNAME " [ OPTIONS ] <session-dir> <session/snapshot-name> [<snapshot-name> ...]\n\n");
+	printf ("Options:\n\
+  -b, --blocksize <samples>  process cycle length (default: 8192)\n\
+  -h, --help                 display this help and exit\n\
+  -o, --output <dir>         directory to write to (default: the session's export dir)\n\
+  -p, --preroll <seconds>    time to run the session before rendering (default: 0)\n\
+  -V, --version              print version information and exit\n\
+\n");
+	printf ("\n\
+Each snapshot is loaded in turn and its session range is rendered from the\n\
+master bus to <snapshot-name>.wav, as 32bit float at the session's samplerate.\n\
+A snapshot that fails to load or render does not stop the others; the exit\n\
+status is non-zero if any of them failed.\n\
+\n");
+
+	printf ("Report bugs to <http://tracker.ardour.org/>\n"
+	        "Website: <http://ardour.org/>\n");
+	::exit (status);
+}
+
+int main (int argc, char* argv[])
+{
+	uint32_t blocksize = 8192;
+	float preroll = 0;
+	std::string outdir;
+
+	const char *optstring = "b:ho:p:V";
+
+	const struct option longopts[] = {
+		{ "blocksize",  1, 0, 'b' },
+		{ "help",       0, 0, 'h' },
+		{ "output",     1, 0, 'o' },
+		{ "preroll",    1, 0, 'p' },
+		{ "version",    0, 0, 'V' },
+		{ 0, 0, 0, 0 }
+	};
+
+	int c = 0;
+	while (EOF != (c = getopt_long (argc, argv,
+					optstring, longopts, (int *) 0))) {
+		switch (c) {
+
+			case 'b':
+				{
+					const int bs = atoi (optarg);
+					if (bs >= 64 && bs <= 8192) {
+						blocksize = bs;
+					} else {
+						fprintf(stderr, "Invalid blocksize, must be between 64 and 8192\n");
+						usage (EXIT_FAILURE);
+					}
+				}
+				break;
+
+			case 'o':
+				outdir = optarg;
+				break;
+
+			case 'p':
+				preroll = atof (optarg);
+				if (preroll < 0) {
+					preroll = 0;
+				}
+				break;
+
+			case 'V':
+				printf ("ardour-utils version %s\n", VERSIONSTRING);
+				exit (0);
+				break;
+
+			case 'h':
+				usage (0);
+				break;
+
+			default:
+					usage (EXIT_FAILURE);
+					break;
+		}
+	}
+
+	if (optind + 2 > argc) {
+		usage (EXIT_FAILURE);
+	}
+
+	SessionUtils::init();
+
+	Config->set_export_preroll (preroll);
+
+	int failed = 0;
+
+	for (int i = optind + 1; i < argc; ++i) {
+		Session* s = SessionUtils::load_session (argv[optind], argv[i], false, blocksize);
+
+		if (!s || render_session (s, outdir, argv[i])) {
+			++failed;
+		}
+
+		SessionUtils::unload_session (s);
+	}
+
+	SessionUtils::cleanup();
+
+	return failed ? EXIT_FAILURE : 0;
+}